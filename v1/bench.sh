@@ -0,0 +1,99 @@
+#!/bin/bash
+
+# Benchmark harness: runs every mode on every bundled problem for a fixed exec
+# budget and seed, each in a fresh working directory, and merges the per-run
+# JSON reports (written by ./main -B) into one machine-readable report.
+#
+# Usage: ./bench.sh [-e EXECS] [-s SEED] [-m "MODES"] [-p "PROBLEMS"] [-o REPORT]
+#   MODES:    any of random, greybox, directed (default: "random greybox")
+#   PROBLEMS: names under problems/ without .c (default: all bundled problems)
+
+execs=20000
+seed=1
+modes="random greybox"
+problems="Problem1 Problem2 Problem3 Problem10 Problem13"
+report="bench_report.json"
+
+while getopts "e:s:m:p:o:" opt; do
+    case $opt in
+        e) execs="$OPTARG" ;;
+        s) seed="$OPTARG" ;;
+        m) modes="$OPTARG" ;;
+        p) problems="$OPTARG" ;;
+        o) report="$OPTARG" ;;
+        *) echo "Usage: $0 [-e EXECS] [-s SEED] [-m MODES] [-p PROBLEMS] [-o REPORT]"; exit 1 ;;
+    esac
+done
+
+root=$(cd "$(dirname "$0")" && pwd)
+fuzzer="$root/main"
+runs_dir="$root/bench_runs"
+
+if [ ! -x "$fuzzer" ]; then
+    echo "Fuzzer not built: run make first"
+    exit 1
+fi
+
+# Fuzzer flags for each mode (add new executors/schedulers here)
+mode_flags() {
+    case "$1" in
+        random) echo "-r" ;;
+        greybox) echo "-g" ;;
+        directed) echo "-g -D" ;;
+        *) return 1 ;;
+    esac
+}
+
+# Pull a numeric top-level field out of a run report
+field() {
+    sed -n "s/^  \"$2\": \([0-9.]*\),*$/\1/p" "$1"
+}
+
+rm -rf "$runs_dir"
+mkdir -p "$runs_dir"
+failed=0
+reports=()
+
+printf "%-10s %-10s %10s %12s %8s %12s\n" "problem" "mode" "execs" "execs/s" "edges" "peak_rss_kb"
+for problem in $problems; do
+    source_file="$root/problems/$problem.c"
+    if [ ! -f "$source_file" ]; then
+        echo "Skipping $problem: $source_file not found"
+        continue
+    fi
+    for mode in $modes; do
+        flags=$(mode_flags "$mode") || { echo "Unknown mode: $mode"; exit 1; }
+        work="$runs_dir/${problem}_$mode"
+        mkdir -p "$work"
+
+        # Fresh directory per run: no corpus or findings carried over
+        (cd "$work" && "$fuzzer" $flags -s "$seed" -E "$execs" -B "$work/report.json" \
+            -i "$source_file" > "$work/fuzzer.log" 2>&1)
+        if [ ! -f "$work/report.json" ]; then
+            echo "$problem/$mode failed, see $work/fuzzer.log"
+            failed=1
+            continue
+        fi
+        reports+=("$work/report.json")
+        printf "%-10s %-10s %10s %12s %8s %12s\n" "$problem" "$mode" \
+            "$(field "$work/report.json" execs)" "$(field "$work/report.json" execs_per_sec)" \
+            "$(field "$work/report.json" edges)" "$(field "$work/report.json" peak_rss_kb)"
+    done
+done
+
+# Merge: {"seed", "exec_budget", "host", "runs": [per-run reports]}
+{
+    echo "{"
+    echo "  \"seed\": $seed,"
+    echo "  \"exec_budget\": $execs,"
+    echo "  \"host\": \"$(uname -srm)\","
+    echo "  \"runs\": ["
+    for i in "${!reports[@]}"; do
+        sed 's/^/    /' "${reports[$i]}" | sed '$ s/}$/}'"$([ "$i" -lt $((${#reports[@]} - 1)) ] && echo ",")"'/'
+    done
+    echo "  ]"
+    echo "}"
+} > "$report"
+
+echo "Report written to $report (${#reports[@]} runs)"
+exit $failed
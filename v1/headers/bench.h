@@ -0,0 +1,27 @@
+// filepath: headers/bench.h
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+// Benchmark recording (enabled with -B). Keeps the coverage curve of the run
+// (one point each time the total edge count grows: execs, elapsed time, edges)
+// and writes a machine-readable JSON report at the end with execs/sec,
+// edges at fixed exec checkpoints, time-to-coverage milestones and peak RSS.
+
+#define BENCH_MILESTONE_COUNT 4 // Milestones at 50/75/90/100% of the final edge count
+
+// Start recording; the report is written to 'report_path' by bench_finish
+int bench_start(const char* report_path, const char* mode, const char* target, unsigned int seed,
+                unsigned long long exec_budget);
+
+// Is a benchmark being recorded?
+int bench_enabled(void);
+
+// Account newly covered edges (called by the coverage code)
+void bench_note_new_edges(int new_edges);
+
+// Write the report and free the curve. Returns 0 on success, -1 on error.
+int bench_finish(void);
+
+#endif // BENCH_H
@@ -0,0 +1,34 @@
+// filepath: headers/calibrate.h
+#ifndef CALIBRATE_H
+#define CALIBRATE_H
+
+#include <stdint.h>
+
+#include "coverage.h"
+
+// Calibration of new corpus entries. The input is run CALIBRATION_RUNS more
+// times (bypassing the execution cache); map indices whose hit/miss state
+// differs from the first run are flagged variable (coverage_mark_variable),
+// so flaky edges stop being reported as new coverage. The entry's exec time
+// becomes the mean over all runs, for scheduling.
+
+#define CALIBRATION_RUNS 4
+
+typedef struct {
+    uint64_t entries;   // Inputs calibrated
+    uint64_t execs;     // Extra executions spent
+    uint64_t unstable;  // Inputs that showed variable edges
+} calibration_stats_t;
+
+// Calibrate 'input', whose first run produced 'map' (the shared map or a copy).
+// Leaves shared memory and the last exec time as after the first run, except
+// that the exec time is the mean. Returns the number of newly flagged edges, or
+// -1 if a calibration run failed or timed out (calibration stops there).
+int calibrate_input(const char* exePath, int input, const coverage_t* map, unsigned int timeout_ms);
+
+calibration_stats_t calibration_stats(void);
+
+// Print calibration totals and stability
+void calibration_print_summary(void);
+
+#endif // CALIBRATE_H
@@ -0,0 +1,77 @@
+// filepath: headers/campaign.h
+#ifndef CAMPAIGN_H
+#define CAMPAIGN_H
+
+#include <stdint.h>
+
+// Campaign control: when a fuzzing session stops, and how the grey-box loop
+// splits its executions between stages.
+//
+// Limits are counted in executions (target runs plus runs restored from the
+// execution cache) and wall-clock time rather than loop iterations, whose cost
+// ranges from one run (corpus mutation) to a whole GA generation, so numbers
+// from different modes and settings can be compared. A session stops at the
+// first limit reached. Without any limit, CAMPAIGN_DEFAULT_EXECS applies.
+//
+// The grey-box loop asks campaign_next_stage which stage to run next: the one
+// furthest below its share of the executions spent so far.
+
+#define CAMPAIGN_DEFAULT_EXECS 500000ULL // About what the former fixed 10000 iterations cost
+#define CAMPAIGN_GA_EXEC_SHARE 99        // Percent of loop executions spent on GA generations (the former 50/50
+                                         // iteration split: one corpus run per 101-run generation)
+
+typedef enum {
+    CAMPAIGN_RUNNING = 0,
+    CAMPAIGN_STOP_EXECS,   // -E
+    CAMPAIGN_STOP_TIME,    // -T
+    CAMPAIGN_STOP_CRASH,   // -c
+    CAMPAIGN_STOP_PLATEAU, // -P
+    CAMPAIGN_STOP_SIGNAL,  // SIGINT/SIGTERM (campaign_request_stop)
+} campaign_stop_t;
+
+typedef struct {
+    uint64_t max_execs;       // Stop after this many executions (0: none)
+    uint64_t max_seconds;     // Stop after this much wall-clock time (0: none)
+    uint64_t plateau_seconds; // Stop when no new edge was found for this long (0: never)
+    int stop_on_crash;        // Stop at the first unique crash
+} campaign_config_t;
+
+typedef enum {
+    CAMPAIGN_STAGE_CORPUS = 0, // Mutate a corpus entry (deterministic stage, havoc, splice, crossover)
+    CAMPAIGN_STAGE_GA,         // Evaluate a GA generation
+    CAMPAIGN_STAGE_COUNT
+} campaign_stage_t;
+
+// Start the clock. Applies CAMPAIGN_DEFAULT_EXECS when no limit is set.
+void campaign_start(const campaign_config_t* config);
+
+// The limits in effect (after campaign_start)
+const campaign_config_t* campaign_config(void);
+
+// Executions so far
+uint64_t campaign_execs(void);
+
+// Check the limits against the session's progress. Once a limit is hit the
+// result stays set (and is logged once). Returns CAMPAIGN_RUNNING to go on.
+campaign_stop_t campaign_check(int edges, int unique_crashes);
+
+// Ask the session to stop at the next campaign_check. Only sets a flag, so it
+// is safe to call from a signal handler.
+void campaign_request_stop(int sig);
+
+// Signal passed to campaign_request_stop, or 0
+int campaign_interrupted(void);
+
+// "exec budget", "time limit", ... or NULL while running
+const char* campaign_stop_reason(void);
+
+// Stage to run next (CAMPAIGN_STAGE_GA if the corpus is empty)
+campaign_stage_t campaign_next_stage(int corpus_size);
+
+// Charge the executions made since 'execs_before' (a campaign_execs value) to a stage
+void campaign_account(campaign_stage_t stage, uint64_t execs_before);
+
+// Executions charged to a stage
+uint64_t campaign_stage_execs(campaign_stage_t stage);
+
+#endif // CAMPAIGN_H
@@ -0,0 +1,41 @@
+// filepath: headers/cmin.h
+#ifndef CMIN_H
+#define CMIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "coverage.h" // For coverage_t and COVERAGE_MAP_SIZE
+
+// Corpus minimization as weighted set cover over packed edge bitsets.
+// A coverage map is reduced to one bit per edge (COVERAGE_MAP_SIZE bits), so
+// "does entry A add anything to set B" is an AND + popcount over 1024 words
+// instead of a 64KB byte compare.
+
+#define CMIN_BITSET_WORDS (COVERAGE_MAP_SIZE / 64)
+#define CMIN_BITSET_BYTES (CMIN_BITSET_WORDS * sizeof(uint64_t))
+
+// One candidate for the cover
+typedef struct {
+    const uint64_t* edges;  // CMIN_BITSET_WORDS words, bit i set if edge i was hit
+    double weight;          // Cost of keeping the candidate (exec time x size); must be > 0
+    int required;           // Always keep, even if it adds nothing (e.g. unknown coverage)
+} cmin_item_t;
+
+// Pack a coverage map into a bitset (bit i = map[i] != 0)
+void cmin_bitset_from_map(uint64_t* bits, const coverage_t* map);
+
+// Number of set bits
+int cmin_bitset_count(const uint64_t* bits);
+
+// Number of bits set in both a and b
+int cmin_bitset_count_and(const uint64_t* a, const uint64_t* b);
+
+// Greedy weighted set cover: keeps every required item, then repeatedly keeps
+// the item covering the most still-uncovered edges per unit of weight until
+// the kept items cover every edge covered by any item. Ties go to the lower
+// index, so the result only depends on the order of 'items'.
+// keep[i] is set to 1 for kept items, 0 otherwise.
+// Returns the number of kept items, or -1 on allocation failure.
+int cmin_greedy_cover(const cmin_item_t* items, int count, uint8_t* keep);
+
+#endif // CMIN_H
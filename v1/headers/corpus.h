@@ -3,18 +3,63 @@
 #define CORPUS_H
 
 #include <time.h>
+#include <stdint.h>
 #include "coverage.h" // For coverage_t and COVERAGE_MAP_SIZE
 
 // Structure for an entry in the corpus
 typedef struct {
     int input_value;            // The input itself
+    uint64_t content_hash;      // Hash of the input bytes (dedup key)
     double fitness_score;       // Fitness score associated with this input
     int is_interesting;         // Flag (e.g., 1 if caused crash, new cov, etc.)
     time_t timestamp;           // When this entry was added/last updated
     coverage_t* coverage_map;   // Coverage map generated by this input (allocated per entry)
-    // Add other metadata: path to file?, size?, number of times fuzzed?
+    int det_done;               // Set once the deterministic stage has run on this entry
+    unsigned int exec_us;       // Execution time of this input (microseconds)
+    uint64_t cov_hash;          // Path hash of coverage_map (see coverage_path_hash)
+    int path_tracked;           // cov_hash is registered in the corpus path set
+    unsigned int times_selected; // Scheduling counter: times picked by selectCorpusEntry
+    int needs_eval;             // Loaded without metadata; coverage must be re-measured
+    int meta_dirty;             // Metadata changed since the sidecar was last written
+    int counters_dirty;         // Only times_selected, fitness or the interesting flag changed (written at shutdown)
+    char file_name[64];         // Input file name inside the corpus directory
+    long store_index;           // Record index in the corpus store, or -1
+    uint64_t* edge_bits;        // coverage_map packed to one bit per edge (see cmin.h)
+    int favored;                // Cheapest entry for at least one edge in the current cover
+    uint32_t distance;          // Directed mode: run distance to the unreached labels (see directed.h)
 } CorpusEntry;
 
+// Scheduling: non-favored entries are passed over this often (percent) while
+// favored entries exist, up to CORPUS_SELECT_ATTEMPTS picks per selection
+#define CORPUS_SKIP_NONFAVORED_PCT 75
+#define CORPUS_SELECT_ATTEMPTS 4
+
+// On-disk metadata sidecar ("<input file>.meta"), little-endian binary:
+//   corpus_meta_header_t, then edge_count corpus_meta_edge_t records
+#define CORPUS_META_MAGIC 0x4D5A5A46 // "FZZM"
+#define CORPUS_META_VERSION 2 // 2: path hash over sparse (index, bucket) pairs
+#define CORPUS_META_SUFFIX ".meta"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    int32_t input_value;
+    int32_t is_interesting;
+    double fitness_score;
+    int64_t timestamp;
+    uint64_t cov_hash;
+    uint32_t exec_us;
+    uint32_t times_selected;
+    uint32_t det_done;
+    uint32_t edge_count;        // Number of sparse edge records that follow
+} corpus_meta_header_t;
+
+typedef struct {
+    uint16_t index;             // Coverage map index
+    uint8_t hits;               // Raw hit count at that index
+    uint8_t reserved;
+} corpus_meta_edge_t;
+
 
 // --- Corpus Management Functions ---
 
@@ -26,18 +71,56 @@ int initializeCorpus(const char* corpus_dir);
 // **FIX:** Add const to coverage_map parameter to match definition
 int saveToCorpus(int input_value, const coverage_t* coverage_map, double fitness_score, int is_interesting);
 
-// Load corpus entries from disk into memory (basic version)
-// Returns the number of entries loaded, or -1 on error.
+// Load corpus entries from disk into memory. Entries with a valid metadata
+// sidecar get their coverage, fitness and counters restored (and their coverage
+// merged into global_cov_map); the rest are flagged with needs_eval.
+// Returns the corpus size after loading, or -1 on error.
 int loadCorpus(const char* corpus_dir);
 
-// Minimize the corpus by removing redundant entries based on coverage
+// Persist the corpus into an append-only store instead of per-entry files
+// (pass NULL to go back to files). Must be set before entries are added.
+struct corpus_store_s;
+void setCorpusStore(struct corpus_store_s* store);
+
+// Rewrite the metadata sidecar of every entry whose metadata changed; with
+// include_counters, also of entries whose only change is their scheduling
+// counter (selection touches nearly every entry, so periodic syncs skip those
+// and they are written once at shutdown). Returns the number of sidecars written.
+int syncCorpusMetadata(int include_counters);
+
+// Re-measure an entry after running its input: replaces coverage, path hash,
+// exec time and fitness, clears needs_eval and marks the metadata dirty.
+void updateCorpusEntryCoverage(CorpusEntry* entry, const coverage_t* coverage_map, double fitness_score);
+
+// Call fn on every in-memory corpus entry
+void corpusForEach(void (*fn)(CorpusEntry* entry, void* ctx), void* ctx);
+
+// Minimize the corpus with a weighted greedy set cover: keeps the cheapest
+// (exec time x size) set of entries that still covers every corpus edge.
+// Entries that still need re-evaluation are always kept. Removed entries are
+// dropped from memory only; their files/records stay on disk.
 // Returns the new size of the corpus, or -1 on error.
 int minimizeCorpus();
 
-// Select an entry from the corpus (e.g., for mutation)
-// Returns pointer to a corpus entry, or NULL if empty/error.
+// Write every in-memory entry (input file + metadata sidecar) to 'out_dir'
+// using the per-file corpus layout. Returns the number of entries written, or -1.
+int exportCorpus(const char* out_dir);
+
+// Select an entry from the corpus (e.g., for mutation). Favored entries (the
+// AFL-style top_rated cover, kept up to date incrementally as entries are
+// added) are preferred; in directed mode, so are entries closer to an unreached
+// error label. Returns pointer to a corpus entry, or NULL if empty/error.
 CorpusEntry* selectCorpusEntry();
 
+// While set, selectCorpusEntry also draws a second entry and keeps whichever
+// was selected less often
+void setCorpusRareBias(int enabled);
+
+// Inputs of the entries whose edges the fewest other entries share (score: sum
+// over the entry's edges of 1 / entries hitting the edge), rarest first.
+// Fills up to max inputs and returns how many.
+int getRareCorpusInputs(int* inputs, int max);
+
 // Clean up all memory used by the in-memory corpus
 void cleanupCorpus(void);
 
@@ -61,13 +144,16 @@ typedef struct {
     size_t len;                     // Length of data
     int fitness;                   // Number of new edges discovered
     coverage_t* coverage_map;      // Coverage map for this run
+    uint64_t data_hash;            // Hash of data[0..len) (set by add_to_corpus)
+    uint64_t cov_hash;             // Path hash of coverage_map (set by add_to_corpus)
 } TestCase;
 
 // Initialize GA corpus with initial seed
 void init_corpus(void);
 // Select a parent from the corpus (for crossover)
 TestCase* select_parent(void);
-// Add a test case to the corpus if fitness > 0 (replace worst if full)
+// Add a test case to the corpus if fitness > 0 (replace worst if full).
+// Test cases whose bytes or trace map are already in the corpus are skipped.
 int add_to_corpus(const TestCase* tc);
 
 #endif // CORPUS_H
\ No newline at end of file
@@ -9,6 +9,8 @@
 // Needs to be a power of 2 for the modulo arithmetic. 64KB is standard.
 #define COVERAGE_MAP_SIZE (1 << 16)
 
+#include "shm_layout.h" // Runtime-written area after the map (crash signature, ...)
+
 // Type alias for coverage map entries (usually bytes)
 typedef uint8_t coverage_t;
 
@@ -18,7 +20,7 @@ typedef uint8_t coverage_t;
 typedef struct {
     int shm_id;         // Shared memory ID
     coverage_t *map;    // Pointer to the shared memory map
-    // Add other shared data if needed (e.g., crash status)
+    shm_extra_t *extra; // Area after the map written by the target runtime
 } shared_mem_t;
 
 // Global shared memory structure (or pass it around)
@@ -31,8 +33,19 @@ extern coverage_t global_cov_map[COVERAGE_MAP_SIZE];
 // Coverage evaluation helpers
 // Copy shared map to run_cov, count new edges and merge into global map
 int evaluate_coverage(void);
+// Same for a run map other than the shared one (e.g. from an executor worker)
+int evaluate_coverage_map(const coverage_t* run_map);
 // Merge a run's coverage into the global map without counting
 void merge_global_coverage(const coverage_t* run_cov);
+// Edges covered in the global map, maintained incrementally (no map scan)
+int global_coverage_edges(void);
+
+// Flag a map index as variable: it differed between runs of the same input.
+// Variable edges are never counted as new. Returns 1 if newly flagged.
+int coverage_mark_variable(int index);
+int coverage_variable_edges(void);
+// Percentage of the edges seen so far that are not variable
+double coverage_stability(void);
 
 // Initialize shared memory for fuzzing
 int setup_shared_memory(void);
@@ -40,7 +53,10 @@ int setup_shared_memory(void);
 // Detach and remove shared memory
 void destroy_shared_memory(void);
 
-// Reset the coverage map in shared memory (call before each run)
+// Skip the "Fuzzer Info" messages of the two calls above (executor workers)
+void set_shared_memory_quiet(int quiet);
+
+// Reset the coverage map (and the runtime-written area) in shared memory (call before each run)
 void reset_coverage_map(void);
 
 // --- Fuzzer-Side Coverage Analysis ---
@@ -48,8 +64,9 @@ void reset_coverage_map(void);
 // Check if the current map (in shared memory) has new coverage compared to a global map
 int has_new_coverage(const coverage_t* global_map);
 
-// Update a global map with coverage found in the shared memory map
-void update_global_coverage(coverage_t* global_map);
+// Update a global map with coverage found in the shared memory map.
+// Returns the number of edges that were new to global_map.
+int update_global_coverage(coverage_t* global_map);
 
 // Calculate a fitness score based on the coverage map (usually the one in shared memory)
 // Note: Pass global_map to check for novelty bonus
@@ -61,6 +78,10 @@ int count_covered_edges(const coverage_t* map);
 // Dump coverage summary
 void dump_coverage_summary(const coverage_t* map);
 
+// Hash the execution path recorded in a map (hit counts bucketed AFL-style)
+// Two runs with the same hash took the same path through the target.
+uint64_t coverage_path_hash(const coverage_t* map);
+
 
 // --- Signal Handling ---
 
@@ -0,0 +1,46 @@
+// filepath: headers/crash.h
+#ifndef CRASH_H
+#define CRASH_H
+
+#include <stdint.h>
+#include "coverage.h" // For crash_signature_t
+
+// Crash deduplication. Each crashing run is bucketed by a hash of its signal,
+// faulting PC and top stack frames (as recorded by the target runtime in the
+// shared memory area after the coverage map). Only the first crash of a bucket
+// counts as a unique crash; later ones only replace the bucket's reproducer if
+// they are simpler (see tmin_is_simpler).
+
+// Outcome of recording one crashing run
+typedef enum {
+    CRASH_DUPLICATE = 0,          // Known bucket, reproducer unchanged
+    CRASH_NEW_BUCKET = 1,         // First crash with this signature
+    CRASH_SIMPLER_REPRODUCER = 2  // Known bucket, input is simpler than its reproducer
+} crash_record_result_t;
+
+// Hash identifying a crash. With no valid signature (e.g. the target was killed
+// before its handler ran) crashes are bucketed by signal alone.
+uint64_t crash_signature_hash(const crash_signature_t* sig, int signal);
+
+// Record a crashing run of 'input' that died with 'signal'. 'sig' may be NULL.
+// For CRASH_SIMPLER_REPRODUCER, *previous receives the replaced reproducer.
+crash_record_result_t crash_record(const crash_signature_t* sig, int signal, int input, int* previous);
+
+// Record that a crashing run of 'input' hit error label 'label' (reach_error_N,
+// or ERROR_LABEL_UNKNOWN). Returns 1 the first time a label is reached.
+int crash_record_error_label(int label, int input);
+
+// Number of distinct error labels reached so far
+int crash_error_label_count(void);
+
+// Number of unique crash buckets / crashing runs recorded so far
+int crash_bucket_count(void);
+int crash_total_count(void);
+
+// Print one line per bucket (signature, signal, PC, hits, reproducer) and per error label
+void crash_print_summary(void);
+
+// Free all buckets
+void crash_cleanup(void);
+
+#endif // CRASH_H
@@ -0,0 +1,40 @@
+// filepath: headers/deterministic.h
+#ifndef DETERMINISTIC_H
+#define DETERMINISTIC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Configuration ---
+#define DET_BATCH_SIZE 64   // Candidates handed to the executor per batch
+#define DET_ARITH_MAX 35    // Arithmetic stage tries +/- 1..DET_ARITH_MAX
+
+// Execute a batch of 'count' candidates, each 'len' bytes, stored back to back
+// in 'inputs'. The callback must fill path_hashes[i] with the coverage path hash
+// of candidate i (see coverage_path_hash) so the stage can build its effector map.
+// Candidates the caller chooses not to run should report the base path hash.
+// Returns 0 to go on, nonzero to abort the stage (the rest is not run).
+typedef int (*det_exec_batch_fn)(const uint8_t *inputs, size_t len, int count,
+                                 uint64_t *path_hashes, void *ctx);
+
+// Counters collected while running the stage
+typedef struct {
+    int execs;              // Candidates handed to the executor
+    int effective_bytes;    // Bytes whose flip changed the execution path
+    int skipped_bytes;      // Bytes skipped by the effector map
+    int aborted;            // The batch callback stopped the stage early
+} det_stats_t;
+
+// Run the deterministic stage over one input (AFL-style):
+//   walking bit flips (1/2/4 bits), byte flips (8/16/32 bits),
+//   +/- 1..DET_ARITH_MAX arithmetic (8/16/32 bit, both endians),
+//   interesting value substitution (8/16/32 bit, both endians).
+// The byte flip pass builds an effector map; later passes skip bytes whose
+// flip never changed the path. Candidates that an earlier pass already
+// produced (e.g. an arithmetic result that is also a bit flip) are skipped.
+// base_hash: path hash of the unmodified input.
+// Returns 0 on success, -1 on error (bad arguments / allocation failure).
+int det_stage_run(const uint8_t *buf, size_t len, uint64_t base_hash,
+                  det_exec_batch_fn exec_batch, void *ctx, det_stats_t *stats);
+
+#endif // DETERMINISTIC_H
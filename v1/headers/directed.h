@@ -0,0 +1,69 @@
+// filepath: headers/directed.h
+#ifndef DIRECTED_H
+#define DIRECTED_H
+
+#include <stdint.h>
+#include "coverage.h" // For shm_extra_t and the directed table layout
+
+// Directed fuzzing toward the error labels (reach_error_N) not reached yet.
+//
+// At startup the target source is scanned for a call graph (function
+// definitions and the calls made inside their bodies). Every function that can
+// reach an unreached label gets an AFLGo-style distance: the harmonic mean over
+// the reachable labels of (1 + call hops to the label). The table lives in the
+// shared memory area after the coverage map; a target built with
+// -finstrument-functions records the smallest distance among the functions a
+// run enters.
+//
+// Seeds closer to a label get more energy, with simulated annealing: early on
+// selection is close to uniform (exploration), then it shifts toward the
+// closest seeds (exploitation):
+//   p = (1 - d~)(1 - T) + 0.5 T,  T = 20^(-t / DIRECTED_TIME_TO_EXPLOIT)
+// where d~ is the distance normalised over the corpus.
+
+#define DIRECTED_TIME_TO_EXPLOIT 600 // Seconds until the schedule mostly exploits
+#define DIRECTED_FITNESS_WEIGHT 5.0  // GA fitness bonus for the closest runs (in new-edge units)
+#define DIRECTED_LABEL_PREFIX "reach_error_"
+
+// Build the call graph of 'source_path' and compute the distance table.
+// Returns the number of unreached labels (targets), or -1 on error.
+int directed_init(const char* source_path);
+
+// Is directed mode active (directed_init succeeded with at least one target)?
+int directed_enabled(void);
+
+// Copy the current distance table into a shared memory area
+void directed_sync_table(shm_extra_t* extra);
+
+// Label reached: drop it from the targets, recompute the distances and update
+// the table in fuzz_shared_mem. Returns 1 if 'label' was still a target.
+int directed_mark_reached(int label);
+
+// Minimum distance recorded by the last run (DIRECTED_DIST_NONE if the run
+// entered no function with a known distance, or directed mode is off)
+uint32_t directed_last_distance(void);
+
+// Account the distance of a new corpus seed (for normalisation).
+// Returns 1 if it is the closest seen so far.
+int directed_observe(uint32_t distance);
+
+// Annealed selection probability of a seed in [0, 1] (1.0 when off)
+double directed_energy(uint32_t distance);
+
+// Fitness bonus for a run at 'distance' (0.0 when off)
+double directed_fitness_bonus(uint32_t distance);
+
+// Closest distance observed so far (DIRECTED_DIST_NONE if none)
+uint32_t directed_best_distance(void);
+
+// Number of labels still unreached / labels found in the source
+int directed_target_count(void);
+int directed_label_count(void);
+
+// Print reachability and distance statistics
+void directed_print_summary(void);
+
+// Free the call graph
+void directed_cleanup(void);
+
+#endif // DIRECTED_H
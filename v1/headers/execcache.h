@@ -0,0 +1,61 @@
+// filepath: headers/execcache.h
+#ifndef EXECCACHE_H
+#define EXECCACHE_H
+
+#include <stdint.h>
+
+#include "coverage.h"
+
+// Memoised executions. The GA and the corpus loop often run an input that was
+// run before (values clamped to the range bounds, crossover of identical
+// parents, interesting values). For a deterministic target the outcome is the
+// same, so execute_target_fork (and executor_pool_run_maps) first look the
+// input up here and, on a hit, restore the recorded run into shared memory
+// (status, sparse edge list with hit counts, crash signature / error label /
+// directed distance) instead of forking.
+//
+// EXEC_CACHE_SLOTS entries are kept; a CLOCK hand evicts entries that were not
+// hit since it last passed them. Timeouts and exec errors are never cached.
+// One hit in EXEC_CACHE_VERIFY_INTERVAL is executed anyway and compared with
+// the cached run: a mismatch means the target is nondeterministic and turns
+// the cache off for the rest of the session.
+
+#define EXEC_CACHE_SLOTS 4096
+#define EXEC_CACHE_VERIFY_INTERVAL 64
+
+typedef struct {
+    uint64_t lookups;
+    uint64_t hits;
+    uint64_t inserts;
+    uint64_t evictions;
+    uint64_t verified; // Hits re-executed to check determinism
+} exec_cache_stats_t;
+
+// Turn the cache on or off (on by default; -C turns it off). Turning it off frees the entries.
+void exec_cache_set_enabled(int enabled);
+int exec_cache_enabled(void);
+
+// Look 'input' up. On a hit, writes the run's map into 'map' (whole map,
+// zeroed first) and its per-run shared memory state into 'extra' (either may
+// be NULL), sets *status and *exec_us, and returns 1. Returns 0 on a miss.
+int exec_cache_lookup(int input, coverage_t* map, void* extra, int* status, unsigned int* exec_us);
+
+// Should this hit be executed anyway to check determinism? Call after a hit.
+int exec_cache_should_verify(void);
+
+// Compare a re-executed run with the cached one; disables the cache on a mismatch
+void exec_cache_verify(int input, const coverage_t* map, int status);
+
+// Record a run (ignored for timeouts and exec errors). 'extra' may be NULL.
+void exec_cache_insert(int input, const coverage_t* map, const void* extra, int status, unsigned int exec_us);
+
+// Forget every entry (e.g. when the directed distance table changes)
+void exec_cache_clear(void);
+
+// Counters, readable from the stats thread
+exec_cache_stats_t exec_cache_stats(void);
+
+// Print the hit rate
+void exec_cache_print_summary(void);
+
+#endif // EXECCACHE_H
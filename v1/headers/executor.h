@@ -0,0 +1,69 @@
+// filepath: headers/executor.h
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "coverage.h"
+
+// Pool of executor worker processes. Each worker owns its own shared memory
+// coverage map and runs the target with execute_target_fork, so several inputs
+// can be evaluated at once. Inputs go to idle workers over a pipe; results come
+// back over another and are stored by input index, so the outcome of a batch
+// does not depend on which worker finished first. The parent also attaches
+// every worker's segment, so a batch can hand back each run's coverage map.
+
+#define EXECUTOR_MAX_WORKERS 64
+
+// Result of one execution
+typedef struct {
+    int status;             // execute_target_fork return code
+    uint64_t cov_hash;      // coverage_path_hash of the run's map
+    unsigned int exec_us;   // Execution time (microseconds)
+    int cached;             // Restored from the execution cache, not executed
+} exec_result_t;
+
+// Per-run part of a worker's shm_extra_t (crash signature, error label,
+// directed distance), copied back with the coverage map
+typedef struct {
+    uint8_t bytes[SHM_EXTRA_RUN_SIZE];
+} exec_run_extra_t;
+
+typedef struct {
+    int workers;                            // Number of running workers
+    unsigned int timeout_ms;
+    pid_t pids[EXECUTOR_MAX_WORKERS];
+    int to_worker[EXECUTOR_MAX_WORKERS];    // Write end: inputs
+    int from_worker[EXECUTOR_MAX_WORKERS];  // Read end: exec_result_t
+    coverage_t* maps[EXECUTOR_MAX_WORKERS]; // Each worker's shared memory, attached in the parent
+} executor_pool_t;
+
+// Start 'workers' worker processes for exePath (clamped to 1..EXECUTOR_MAX_WORKERS).
+// Returns 0 on success, -1 on failure.
+int executor_pool_start(executor_pool_t* pool, const char* exePath, int workers, unsigned int timeout_ms);
+
+// Run 'count' inputs; results[i] receives the result of inputs[i].
+// Returns 0 on success, -1 if a worker failed (its inputs report FUZZER_EXEC_ERROR).
+int executor_pool_run(executor_pool_t* pool, const int* inputs, int count, exec_result_t* results);
+
+// Like executor_pool_run, and also copies each run's coverage map into maps[i]
+// and the per-run shared memory state into extras[i] as its result arrives
+// (failed runs get an empty map). 'extras' may be NULL. Inputs found in the
+// execution cache are restored from it and not dispatched, except one hit in
+// EXEC_CACHE_VERIFY_INTERVAL, which runs and is compared with the cached run.
+int executor_pool_run_maps(executor_pool_t* pool, const int* inputs, int count, exec_result_t* results,
+                           coverage_t* const* maps, exec_run_extra_t* extras);
+
+// Make a pooled run the parent's most recent execution: restores its per-run
+// shared memory state and exec time, so code that inspects the last run
+// (crash signature, error label, directed distance, corpus exec time) sees it
+void executor_replay_result(const exec_result_t* result, const exec_run_extra_t* extra);
+
+// Copy the parent's directed distance table to every worker (after labels were reached)
+void executor_pool_sync_directed(executor_pool_t* pool);
+
+// Stop all workers (each removes its shared memory segment) and reap them
+void executor_pool_stop(executor_pool_t* pool);
+
+#endif // EXECUTOR_H
@@ -0,0 +1,62 @@
+// filepath: headers/fitness.h
+#ifndef FITNESS_H
+#define FITNESS_H
+
+#include "coverage.h"
+
+// GA fitness (-F). Every mode starts from the run's new edge count, so
+// discoveries are always rewarded; the modes differ in how they rank
+// individuals whose edges are all known already:
+//   edges   - new edges only (default)
+//   novelty - + NOVELTY_WEIGHT x novelty: mean Jaccard distance of the run's
+//             edge set to its NOVELTY_K nearest neighbours in an archive of
+//             past runs. Edge sets are compared as MinHash signatures and
+//             neighbours are found through LSH banding, so a lookup costs a
+//             few bucket probes instead of a scan of the archive.
+//   rarity  - + sum over the run's edges of 1 / (runs that hit the edge)
+//   pareto  - + Pareto rank of the generation on three objectives: edges hit
+//             (max), hit-count depth (max: sum of log2 hit counts, i.e. how
+//             far loops over the input go) and exec time (min). The first
+//             front scores highest; ties are broken by crowding distance.
+
+typedef enum {
+    FITNESS_EDGES = 0,
+    FITNESS_NOVELTY,
+    FITNESS_RARITY,
+    FITNESS_PARETO,
+    FITNESS_MODE_COUNT
+} fitness_mode_t;
+
+#define NOVELTY_HASHES 32          // MinHash signature length
+#define NOVELTY_BANDS 8            // LSH bands (NOVELTY_HASHES / NOVELTY_BANDS rows each)
+#define NOVELTY_BUCKETS 1024       // Buckets per band
+#define NOVELTY_ARCHIVE_SIZE 1024  // Archived signatures (oldest replaced first)
+#define NOVELTY_K 5                // Neighbours averaged
+#define NOVELTY_ADD_THRESHOLD 0.25 // Runs at least this novel are archived
+#define NOVELTY_WEIGHT 10.0        // Fitness of a run unlike anything archived
+
+// Per-run objectives kept for Pareto ranking
+typedef struct {
+    int edges;             // Edges hit by the run
+    int depth;             // Sum of log2 hit counts
+    unsigned int exec_us;  // Exec time
+} fitness_objectives_t;
+
+// Select the mode by name ("edges", "novelty", "rarity", "pareto"). Returns 0, or -1 if unknown.
+int fitness_set_mode(const char* name);
+fitness_mode_t fitness_mode(void);
+const char* fitness_mode_name(void);
+
+// Fitness of one evaluated run (call once per run, in evaluation order: the
+// novelty archive and rarity counts are updated). Fills 'objectives' if non-NULL.
+// A NULL map (run did not complete) scores its new edges only.
+double fitness_evaluate(const coverage_t* map, int new_edges, unsigned int exec_us,
+                        fitness_objectives_t* objectives);
+
+// Pareto mode: rank a whole generation; scores[i] is added to the fitness of individual i
+void fitness_pareto_scores(const fitness_objectives_t* objectives, int count, double* scores);
+
+// Free the archive
+void fitness_cleanup(void);
+
+#endif // FITNESS_H
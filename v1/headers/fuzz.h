@@ -1,6 +1,8 @@
 #ifndef FUZZ_H
 #define FUZZ_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include "range.h"
 
 // Random generation functions
@@ -24,9 +26,23 @@ int mutateArithmetic(int value);
 int mutateDictionary(int value);
 int mutateHavoc(int value);  // Apply multiple random mutations
 
+// Havoc tuning: up to max_stack stacked mutations, dictionary_pct percent of
+// them magic values (defaults below; plateau escalation raises both)
+#define HAVOC_DEFAULT_STACK 5
+#define HAVOC_DEFAULT_DICTIONARY_PCT 25
+void setHavocStrategy(int max_stack, int dictionary_pct);
+
 // Crossover functionality
 int crossover(int parent1, int parent2);
 
+// Splice: prefix of 'a' joined with the suffix of 'b' at a point between the first
+// and last byte where they differ. Result has b_len bytes (capped at out_cap).
+// Returns the spliced length, or 0 if the buffers are too similar to splice.
+size_t spliceBuffers(uint8_t *out, size_t out_cap, const uint8_t *a, size_t a_len,
+                     const uint8_t *b, size_t b_len);
+// Splice two integer inputs byte-wise; returns 'value' unchanged if not spliceable
+int mutateSplice(int value, int other);
+
 // Other utility functions
 int generateSequence(int length);
 int __VERIFIER_nondet_int(void);
@@ -13,40 +13,53 @@
 #define CROSSOVER_RATE 0.7     // Probability of crossover (adjust as needed)
 #define NUM_GENERATIONS 5       // Number of generations per main fuzzer iteration
 
-// Define if the Individual struct's coverage_map is a pointer vs array
-// If it's coverage_t* coverage_map; then define this
-#define INDIVIDUAL_MAP_IS_POINTER
-
 // Structure for an individual in the population
 typedef struct {
     int input_value;            // The input (genome)
     double fitness_score;       // Fitness score (e.g., based on coverage)
     time_t timestamp;           // Time when created/found
-
-#ifdef INDIVIDUAL_MAP_IS_POINTER
-    coverage_t* coverage_map;   // Pointer to coverage map for this individual's execution
-#else
-    coverage_t coverage_map[COVERAGE_MAP_SIZE]; // Array for coverage map
-#endif
-
+    coverage_t* coverage_map;   // Coverage map of this individual's execution (preallocated, see initializePopulations)
 } Individual;
 
 // --- Population Management ---
+// population and next_generation are two fixed buffers of POPULATION_SIZE
+// individuals whose maps live in one arena allocated here
 void initializePopulations(void);
 void cleanupPopulations(void);
+// Generation turnover: next_generation becomes the population (pointer swap, no copies)
+void swapPopulations(void);
 
 // --- GA Operations ---
-Individual selectParent(Individual population[], int population_size);
+// Tournament selection; returns the index of the winner
+int selectParent(const Individual population[], int population_size);
 void generateNewPopulation(Individual population[], int population_size, Individual next_generation[], int min_range, int max_range);
 
+// --- Island Model ---
+// The population can be split into islands that evolve independently
+// (selection stays within an island). Every MIGRATION_INTERVAL generations
+// each island sends copies of its MIGRATION_SIZE fittest individuals to the
+// next island in a ring, replacing that island's least fit ones.
+#define ISLAND_MIN_SIZE 10      // Smallest island (caps the island count); must be >= 2 * MIGRATION_SIZE
+#define MIGRATION_INTERVAL 5    // Generations between migrations
+#define MIGRATION_SIZE 2        // Individuals each island sends per migration
+
+// Set the number of islands (1: one panmictic population). Returns the count used.
+int setIslandCount(int islands);
+int getIslandCount(void);
+// generateNewPopulation applied to each island separately
+void generateIslandPopulations(Individual population[], Individual next_generation[], int min_range, int max_range);
+// Call once per evaluated generation (after swapPopulations). Returns 1 if migration happened.
+int migrateIslands(Individual population[]);
+
 // --- Utility Functions for Individual Maps ---
 void resetIndividualCoverageMap(coverage_t* map);
 // **FIX:** Add const to match definition in generational.c
 int compareCoverageMaps(const coverage_t* map1, const coverage_t* map2);
 
 // --- Byte-level GA Operators ---
-// One-point crossover for TestCase data
-void tc_crossover(uint8_t *out, TestCase *p1, TestCase *p2);
+// Splice crossover for TestCase data (parents may differ in length)
+// Writes into 'out' (MAX_TESTCASE_LEN bytes) and returns the child's length
+size_t tc_crossover(uint8_t *out, const TestCase *p1, const TestCase *p2);
 // Mutate a buffer of given length
 void tc_mutate(uint8_t *buf, size_t len);
 // Create offspring TestCase by selecting parents, crossover and mutation
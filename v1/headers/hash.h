@@ -0,0 +1,32 @@
+// filepath: headers/hash.h
+#ifndef HASH_H
+#define HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 64-bit non-cryptographic hash (XXH64 algorithm) used for input content
+// deduplication, coverage path hashes and store record checksums.
+uint64_t hash64(const void *data, size_t len, uint64_t seed);
+
+// Streaming XXH64 over data fed in pieces; the digest equals hash64 over
+// the concatenation
+typedef struct {
+    uint64_t v[4];
+    uint64_t total_len;
+    uint64_t seed;
+    uint8_t buf[32];     // Partial stripe
+    uint32_t buf_len;
+} hash64_state_t;
+
+void hash64_init(hash64_state_t *state, uint64_t seed);
+void hash64_update(hash64_state_t *state, const void *data, size_t len);
+uint64_t hash64_digest(const hash64_state_t *state);
+
+// Content hash of an integer input (its 4 bytes, host order)
+uint64_t hash_input_value(int input_value);
+
+// Dedup key / file name hash of a finding (same input can be both a crash and a timeout)
+uint64_t hash_finding(int input_value, int is_timeout);
+
+#endif // HASH_H
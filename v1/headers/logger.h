@@ -1,12 +1,67 @@
+// filepath: headers/logger.h
 #ifndef LOGGER_H
 #define LOGGER_H
 
-// Logging levels
-#define LOG_INFO "[INFO] "
-#define LOG_ERROR "[ERROR] "
-#define LOG_DEBUG "[DEBUG] "
+#include <stdint.h>
 
-void app_log(const char* level, const char* message);
-void app_log_with_value(const char* level, const char* message, const char* format, ...);
+// Diagnostic logging off the hot path. Each thread formats its messages into
+// its own lock-free single-producer ring of fixed-size records; a background
+// writer thread drains the rings to stderr with write(2). A full ring drops
+// the message (and counts it) instead of blocking the caller.
+//
+// Levels are filtered twice: LOG_COMPILE_LEVEL (make LOG_COMPILE_LEVEL=N)
+// removes calls below it from the binary, log_level (-L) skips them at run
+// time. Disabled calls do not evaluate their arguments.
+//
+// Before log_init, after log_shutdown and in forked children (executor
+// workers, target children before exec) messages are written synchronously.
 
-#endif
\ No newline at end of file
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_ERROR 3
+#define LOG_LEVEL_OFF 4
+
+// Level names used by app_log/app_log_with_value callers
+#define LOG_DEBUG LOG_LEVEL_DEBUG
+#define LOG_INFO LOG_LEVEL_INFO
+#define LOG_ERROR LOG_LEVEL_ERROR
+
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+#define LOG_RING_SLOTS 512         // Records per thread ring (power of two)
+#define LOG_MSG_SIZE 240           // Longer messages are truncated
+#define LOG_FLUSH_INTERVAL_MS 20   // Writer sleep when all rings are empty
+
+extern int log_level; // Runtime level: messages below it are skipped
+
+#define LOG_AT(level, tag, ...)                                          \
+    do {                                                                 \
+        if ((level) >= LOG_COMPILE_LEVEL && (level) >= log_level)        \
+            log_write((level), (tag), __VA_ARGS__);                      \
+    } while (0)
+
+// 'tag' is a string literal naming the component ("Main", "Exec")
+#define LOG_D(tag, ...) LOG_AT(LOG_LEVEL_DEBUG, tag, __VA_ARGS__)
+#define LOG_I(tag, ...) LOG_AT(LOG_LEVEL_INFO, tag, __VA_ARGS__)
+#define LOG_W(tag, ...) LOG_AT(LOG_LEVEL_WARN, tag, __VA_ARGS__)
+#define LOG_E(tag, ...) LOG_AT(LOG_LEVEL_ERROR, tag, __VA_ARGS__)
+
+// Start the writer thread. Returns 0 on success, -1 on error (logging stays synchronous).
+int log_init(void);
+
+// Drain every ring, stop the writer and report dropped messages. Registered with atexit by log_init.
+void log_shutdown(void);
+
+// Parse "debug", "info", "warn", "error" or "off". Returns the level, or -1 if unknown.
+int log_parse_level(const char* name);
+
+// Format and queue one message (use the LOG_* macros so disabled levels cost nothing)
+void log_write(int level, const char* tag, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+void app_log(int level, const char* message);
+void app_log_with_value(int level, const char* message, const char* format, ...);
+
+#endif // LOGGER_H
@@ -0,0 +1,79 @@
+// filepath: headers/perf.h
+#ifndef PERF_H
+#define PERF_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+// Hot-path timing. Each stage keeps a log-linear (HDR-style) latency histogram:
+// values below 2^PERF_HIST_SUB_BITS ns get their own bucket, larger values are
+// split into 2^PERF_HIST_SUB_BITS buckets per power of two, so any recorded
+// value is known to within ~3% at a fixed memory cost.
+
+#define PERF_HIST_SUB_BITS 5
+#define PERF_HIST_SUB_COUNT (1 << PERF_HIST_SUB_BITS)
+#define PERF_HIST_BUCKETS ((64 - PERF_HIST_SUB_BITS + 1) * PERF_HIST_SUB_COUNT)
+
+typedef enum {
+    PERF_STAGE_EXEC = 0,    // Whole execute_target_fork call (exec latency)
+    PERF_STAGE_FORK,        // fork() in the parent
+    PERF_STAGE_WRITE,       // Writing the input to the target's stdin
+    PERF_STAGE_WAIT,        // Waiting for the target to exit
+    PERF_STAGE_COVERAGE,    // evaluate_coverage
+    PERF_STAGE_CORPUS_SAVE, // saveToCorpus
+    PERF_STAGE_MUTATION,    // Generating the next input(s)
+    PERF_STAGE_COUNT
+} perf_stage_t;
+
+typedef struct {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t buckets[PERF_HIST_BUCKETS];
+} perf_histogram_t;
+
+// Monotonic timestamp in nanoseconds
+static inline uint64_t perf_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Reset all histograms and start the throughput clock
+void perf_init(void);
+
+// Record one sample for a stage
+void perf_record(perf_stage_t stage, uint64_t ns);
+
+// Record the time since 'start_ns' (from perf_now_ns) for a stage
+static inline void perf_record_since(perf_stage_t stage, uint64_t start_ns) {
+    perf_record(stage, perf_now_ns() - start_ns);
+}
+
+// Histogram helpers (also usable on standalone histograms)
+void perf_histogram_reset(perf_histogram_t* hist);
+void perf_histogram_add(perf_histogram_t* hist, uint64_t ns);
+// Value at percentile pct (0-100): upper bound of the bucket holding it
+uint64_t perf_histogram_percentile(const perf_histogram_t* hist, double pct);
+
+const perf_histogram_t* perf_stage_histogram(perf_stage_t stage);
+const char* perf_stage_name(perf_stage_t stage);
+
+// Executions per second since perf_init
+double perf_execs_per_sec(void);
+
+// Status line fragment: execs/sec, exec p50/p99 and stage breakdown
+// (each stage's share of the wall time since perf_init)
+void perf_format_status(char* buf, size_t size);
+
+// Extra CSV columns for the progress file (header, then one row's values;
+// both start with a comma)
+void perf_write_csv_header(FILE* f);
+void perf_write_csv_row(FILE* f);
+
+// Print the final per-stage table (count, mean, p50, p99, max, share of time)
+void perf_print_summary(void);
+
+#endif // PERF_H
@@ -0,0 +1,79 @@
+// filepath: headers/pipeline.h
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "coverage.h"
+#include "executor.h" // exec_result_t, exec_run_extra_t
+
+// Pipelined execution in the fuzzer process itself. A batch of pre-generated
+// inputs (a GA generation) is queued; up to 'depth' target children run at
+// once, each attached to a shared memory segment of its own. Children are
+// watched through pidfds in one epoll set, so completions and timeouts are
+// noticed without SIGALRM or blocking on a single pid, and a finished slot is
+// refilled from the queue straight away.
+//
+// Results are handed back in submission order (exec_pipeline_next), so
+// evaluation is identical to running the batch serially; while the caller
+// evaluates one result, the following inputs are already executing. (Except
+// for directed distances: queued runs keep the table they were submitted
+// with until exec_pipeline_sync_directed.)
+
+#define PIPELINE_MAX_DEPTH 16
+#define PIPELINE_DEFAULT_DEPTH 4 // Children in flight (-q); 1 runs one at a time
+#define PIPELINE_QUEUE_SIZE 256  // Largest batch
+
+typedef struct {
+    pid_t pid;              // Running child, 0 if the slot is free
+    int pidfd;
+    int index;              // Queue position being run
+    uint64_t start_ns;
+    uint64_t deadline_ns;
+    int shm_id;
+    coverage_t* map;        // Segment: map followed by shm_extra_t
+} pipeline_slot_t;
+
+typedef struct {
+    const char* exe_path;
+    unsigned int timeout_ms;
+    int depth;
+    int epoll_fd;
+    pipeline_slot_t slots[PIPELINE_MAX_DEPTH];
+
+    // Current batch
+    int count;
+    int launched;           // Next queue position to start
+    int retired;            // Next queue position to hand back
+    int inputs[PIPELINE_QUEUE_SIZE];
+    coverage_t* maps[PIPELINE_QUEUE_SIZE]; // Caller's buffers for each run's map
+    uint8_t done[PIPELINE_QUEUE_SIZE];
+    uint8_t verify[PIPELINE_QUEUE_SIZE];   // Cache hit run anyway to check determinism
+    exec_result_t results[PIPELINE_QUEUE_SIZE];
+    exec_run_extra_t extras[PIPELINE_QUEUE_SIZE];
+} exec_pipeline_t;
+
+// Create 'depth' slots (clamped to 1..PIPELINE_MAX_DEPTH) for exePath.
+// Returns 0, or -1 if pidfds, epoll or shared memory are unavailable.
+int exec_pipeline_start(exec_pipeline_t* pipeline, const char* exePath, int depth, unsigned int timeout_ms);
+
+// Queue 'count' inputs (at most PIPELINE_QUEUE_SIZE; the previous batch must
+// be fully handed back) and start the first ones. Each run's coverage map is
+// copied into maps[i]. Inputs found in the execution cache are restored from
+// it and not run, except one hit in EXEC_CACHE_VERIFY_INTERVAL, which runs and
+// is compared with the cached run. Returns 0, or -1 if the batch is too large.
+int exec_pipeline_submit(exec_pipeline_t* pipeline, const int* inputs, int count, coverage_t* const* maps);
+
+// Wait for the next result in submission order, starting queued inputs as
+// slots free up. Fills *result and *extra ('extra' may be NULL) and returns
+// the input's queue position, or -1 once the whole batch was handed back.
+int exec_pipeline_next(exec_pipeline_t* pipeline, exec_result_t* result, exec_run_extra_t* extra);
+
+// Copy the parent's directed distance table into every slot's segment
+void exec_pipeline_sync_directed(exec_pipeline_t* pipeline);
+
+// Kill anything still running and release the slots' shared memory
+void exec_pipeline_stop(exec_pipeline_t* pipeline);
+
+#endif // PIPELINE_H
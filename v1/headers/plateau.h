@@ -0,0 +1,53 @@
+// filepath: headers/plateau.h
+#ifndef PLATEAU_H
+#define PLATEAU_H
+
+#include <stdint.h>
+
+// Coverage plateau detection for the grey-box loop. When no new edge is found
+// for PLATEAU_WINDOW_EXECS executions, the strategy escalates one level;
+// each level keeps the ones below it:
+//   1 dictionary     - havoc draws magic values PLATEAU_DICTIONARY_PCT% of the time
+//   2 deep-havoc     - havoc stacks up to PLATEAU_HAVOC_STACK mutations
+//   3 rare-selection - corpus selection prefers rarely selected entries
+//   4 ga-reseed      - the GA population is reseeded from rare-edge corpus entries
+//   5 widen-range    - the input range doubles around its centre
+// Levels 1-3 are applied here; 4 and 5 are one-shot actions returned to the
+// caller, repeated on every further plateau at the top level. A new edge
+// steps back down one level, so the defaults return once progress resumes.
+
+#define PLATEAU_WINDOW_EXECS 2000   // Executions without a new edge that count as a plateau
+#define PLATEAU_DICTIONARY_PCT 50   // Level 1 dictionary share (default HAVOC_DEFAULT_DICTIONARY_PCT)
+#define PLATEAU_HAVOC_STACK 16      // Level 2 havoc stacking depth (default HAVOC_DEFAULT_STACK)
+
+typedef enum {
+    PLATEAU_LEVEL_DEFAULT = 0,
+    PLATEAU_LEVEL_DICTIONARY,
+    PLATEAU_LEVEL_DEEP_HAVOC,
+    PLATEAU_LEVEL_RARE_SELECTION,
+    PLATEAU_LEVEL_GA_RESEED,
+    PLATEAU_LEVEL_WIDEN_RANGE,
+    PLATEAU_LEVEL_COUNT
+} plateau_level_t;
+
+// One-shot actions returned by plateau_update
+#define PLATEAU_ACTION_RESEED_GA 0x1
+#define PLATEAU_ACTION_WIDEN_RANGE 0x2
+
+// Reset to the default strategy
+void plateau_start(void);
+
+// Feed the session's progress (call once per loop iteration). Escalates or
+// steps back as needed and returns the PLATEAU_ACTION_* bits to apply now.
+int plateau_update(uint64_t execs, int edges);
+
+// Current level and number of escalations / step-backs so far;
+// readable from the stats thread
+plateau_level_t plateau_level(void);
+uint64_t plateau_switches(void);
+const char* plateau_strategy_name(plateau_level_t level);
+
+// Print the switches made
+void plateau_print_summary(void);
+
+#endif // PLATEAU_H
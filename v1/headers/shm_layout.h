@@ -0,0 +1,96 @@
+// filepath: headers/shm_layout.h
+#ifndef SHM_LAYOUT_H
+#define SHM_LAYOUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Layout of the shared memory segment shared with the target:
+//   [0, COVERAGE_MAP_SIZE)          coverage map
+//   [SHM_EXTRA_OFFSET, +extra)      shm_extra_t, written by the target runtime
+// Included by both the fuzzer (coverage.h) and src/coverage_runtime.c, which
+// each define COVERAGE_MAP_SIZE before including it.
+
+// Crash signature left by the runtime's fatal signal handler
+#define CRASH_SIG_MAGIC 0x47495343 // "CSIG", written last so a torn write reads as invalid
+#define CRASH_SIG_FRAMES 8         // Return addresses kept (top of stack first)
+
+typedef struct {
+    uint32_t magic;                     // CRASH_SIG_MAGIC when the rest is valid
+    int32_t signal;                     // Fatal signal number
+    uint64_t fault_addr;                // siginfo si_addr (raw)
+    uint64_t pc;                        // Faulting PC as a module offset (see below)
+    uint32_t frame_count;               // Valid entries in frames
+    uint32_t reserved;
+    uint64_t frames[CRASH_SIG_FRAMES];  // Return addresses as module offsets
+} crash_signature_t;
+
+// Module offsets: low 48 bits are the offset from the module's load base, the
+// top 16 bits a hash of the module's file name (0 if the address wasn't in a module)
+#define CRASH_SIG_OFFSET_BITS 48
+
+// Error label left by the runtime's __assert_fail when an SV-COMP style
+// reach_error() is hit. The runtime then _exits with ERROR_LABEL_EXIT_CODE
+// instead of aborting; the fuzzer reports such runs as SIGABRT crashes.
+#define ERROR_LABEL_MAGIC 0x4C525245 // "ERRL"
+#define ERROR_LABEL_UNKNOWN -1       // Assertion not reached through a reach_error_N function
+#define ERROR_LABEL_EXIT_CODE 134    // 128 + SIGABRT, as a shell would report an abort
+
+typedef struct {
+    uint32_t magic;             // ERROR_LABEL_MAGIC when valid
+    int32_t label;              // N of the innermost reach_error_N on the stack, or ERROR_LABEL_UNKNOWN
+    int32_t line;               // Line passed to __assert_fail
+    uint32_t reserved;
+} error_label_t;
+
+// Directed fuzzing. The fuzzer fills a table of per-function distances to the
+// still unreached error labels (sorted by name hash, see shm_name_hash); targets
+// built with -finstrument-functions record the distances of the functions a run
+// enters. Distances are fixed point (x DIRECTED_DIST_SCALE).
+#define DIRECTED_MAX_FUNCS 4096
+#define DIRECTED_DIST_NONE 0xFFFFFFFFu // Function can't reach any unreached label
+#define DIRECTED_DIST_SCALE 100
+
+typedef struct {
+    uint64_t name_hash;
+    uint32_t distance;
+    uint32_t reserved;
+} directed_func_t;
+
+typedef struct {
+    uint32_t func_count;        // 0: directed mode off
+    uint32_t reserved;
+    directed_func_t funcs[DIRECTED_MAX_FUNCS];
+} directed_table_t;
+
+// Per-run distance record
+typedef struct {
+    uint32_t entered;           // Function entries with a known distance
+    uint32_t min_distance;      // Smallest distance entered (valid if entered > 0)
+    uint64_t distance_sum;      // Sum over entries (for the mean)
+} directed_run_t;
+
+// FNV-1a over a function name (same in fuzzer and runtime)
+__attribute__((no_instrument_function))
+static inline uint64_t shm_name_hash(const char *name) {
+    uint64_t h = 1469598103934665603ULL;
+    for (; *name; name++) {
+        h = (h ^ (uint8_t)*name) * 1099511628211ULL;
+    }
+    return h;
+}
+
+typedef struct {
+    crash_signature_t crash;
+    error_label_t error;
+    directed_run_t directed;
+    directed_table_t table;     // Written by the fuzzer; kept across runs (must stay last)
+} shm_extra_t;
+
+// Per-run part of shm_extra_t, cleared before every execution
+#define SHM_EXTRA_RUN_SIZE offsetof(shm_extra_t, table)
+
+#define SHM_EXTRA_OFFSET COVERAGE_MAP_SIZE
+#define SHM_TOTAL_SIZE (SHM_EXTRA_OFFSET + sizeof(shm_extra_t))
+
+#endif // SHM_LAYOUT_H
@@ -0,0 +1,46 @@
+// filepath: headers/stats.h
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+
+// Progress reporting off the hot path. The fuzzing loop only stores plain
+// counters (STATS_SET/STATS_ADD); a background thread wakes every
+// STATS_RENDER_INTERVAL_MS to print a status line (or redraw the dashboard,
+// -U) and every STATS_FILE_INTERVAL_MS appends a row to the progress CSV and
+// rewrites the key: value snapshot. Console and file I/O never stall a run.
+
+#define STATS_RENDER_INTERVAL_MS 1000
+#define STATS_FILE_INTERVAL_MS 5000
+#define STATS_SNAPSHOT_FILE "fuzzer_stats"
+
+typedef struct {
+    uint64_t iterations;
+    uint64_t edges;
+    uint64_t corpus_size;
+    uint64_t crashes;  // Unique crashes
+    uint64_t timeouts;
+} fuzz_stats_t;
+
+extern fuzz_stats_t fuzz_stats;
+
+// Counter updates from the fuzzing loop: relaxed stores, no lock, no I/O. The
+// fuzzing thread is the only writer, so STATS_ADD's load + store is safe.
+#define STATS_SET(field, value) __atomic_store_n(&fuzz_stats.field, (uint64_t)(value), __ATOMIC_RELAXED)
+#define STATS_ADD(field, n) STATS_SET(field, fuzz_stats.field + (uint64_t)(n))
+
+typedef struct {
+    const char* mode;            // Mode column of the progress CSV ("random", "greybox")
+    const char* progress_path;   // Progress CSV, appended to (NULL: none)
+    const char* snapshot_path;   // Snapshot file, replaced atomically (NULL: none)
+    uint64_t planned_execs;      // Exec budget, shown by the dashboard (0: none)
+    int dashboard;               // Redraw a full-screen dashboard instead of printing status lines
+} stats_config_t;
+
+// Reset the counters and start the reporting thread. Returns 0 on success, -1 on error.
+int stats_start(const stats_config_t* config);
+
+// Stop the thread, then render and write the final state once more
+void stats_stop(void);
+
+#endif // STATS_H
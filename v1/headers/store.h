@@ -0,0 +1,87 @@
+// filepath: headers/store.h
+#ifndef STORE_H
+#define STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+
+// Append-only corpus store: one segment file holding every input back to back
+// plus a fixed-size index file. The segment is mmap'd read-only over a large
+// reserved range, so pointers returned by store_get stay valid while the store
+// is open (appends only grow the file, they never move the mapping).
+//
+// Crash safety: a record is written to the segment before its index entry is
+// appended. On open, index entries that point past the end of the segment or
+// whose record header/hash doesn't match are dropped (torn tail), and the
+// segment is truncated back to the end of the last valid record.
+
+#define STORE_SEGMENT_FILE "store.seg"
+#define STORE_INDEX_FILE "store.idx"
+#define STORE_SEGMENT_MAGIC 0x47535A46 // "FZSG"
+#define STORE_RECORD_MAGIC 0x52535A46  // "FZSR"
+#define STORE_VERSION 2 // v2: records hashed with XXH64
+#define STORE_MAX_SEGMENT_SIZE (1ULL << 30) // Reserved mapping size (1 GiB of address space)
+
+// Record kinds
+typedef enum {
+    STORE_KIND_CORPUS = 1,      // Corpus input
+    STORE_KIND_CORPUS_META = 2, // Metadata sidecar for corpus record 'ref' (latest wins)
+    STORE_KIND_CRASH = 3,       // Crashing input
+    STORE_KIND_TIMEOUT = 4,     // Input that timed out
+    STORE_KIND_SUPERSEDED = 5   // Finding record 'ref' was replaced by a simpler reproducer
+} store_kind_t;
+
+// One index entry (fixed size, appended to store.idx)
+typedef struct {
+    uint64_t offset;            // Offset of the record data in the segment
+    uint32_t length;            // Record data length in bytes
+    uint32_t kind;              // store_kind_t
+    uint64_t hash;              // Hash of the record data
+    int64_t timestamp;          // When the record was appended
+    double fitness;             // Caller-provided metadata
+    uint64_t cov_hash;
+    uint32_t exec_us;
+    uint32_t ref;               // Record this one describes (STORE_KIND_CORPUS_META)
+} store_index_entry_t;
+
+// Open store handle
+typedef struct corpus_store_s {
+    char dir[PATH_MAX];
+    int seg_fd;
+    int idx_fd;
+    uint8_t *map;               // Read-only mapping of the segment
+    uint64_t seg_end;           // Logical end of the segment (next append offset)
+    store_index_entry_t *entries;
+    size_t count;
+    size_t capacity;
+} corpus_store_t;
+
+// Open (or create) the store in 'dir', recovering from a torn tail if needed.
+// Returns 0 on success, -1 on failure.
+int store_open(corpus_store_t *store, const char *dir);
+
+// Close the store and release the mapping
+void store_close(corpus_store_t *store);
+
+// Append a record. 'meta' may be NULL; its offset/length/kind/hash/timestamp
+// fields are filled in by the store. Returns the record's index, or -1 on error.
+long store_append(corpus_store_t *store, store_kind_t kind, const void *data, uint32_t length,
+                  const store_index_entry_t *meta);
+
+// Zero-copy access to a record's data; returns NULL if index is out of range
+const uint8_t *store_get(const corpus_store_t *store, size_t index, uint32_t *length);
+
+// Index entry for a record, or NULL if index is out of range
+const store_index_entry_t *store_entry(const corpus_store_t *store, size_t index);
+
+// Number of records in the store
+size_t store_count(const corpus_store_t *store);
+
+// Export the store to the directory layout used without a store:
+// out_dir/corpus/input_N_time, out_dir/crashes/finding_V_HASH, out_dir/timeouts/...
+// Superseded findings are left out, as their files are deleted without a store.
+// Returns the number of files written, or -1 on error.
+int store_export(const corpus_store_t *store, const char *out_dir);
+
+#endif // STORE_H
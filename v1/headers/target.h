@@ -3,6 +3,9 @@
 #define TARGET_H
 
 #include <limits.h> // For PATH_MAX (might need adjustment for portability)
+#include <sys/types.h>
+
+#include "coverage.h" // For shm_extra_t
 
 // Compile the target program using Clang with coverage instrumentation.
 // Links the coverage runtime.
@@ -14,15 +17,53 @@ int compile_target_with_clang_coverage(const char *sourceDir,
                                       const char *outputExeName);
 
 
-// Execute the instrumented target in a controlled environment (fork/exec).
-// Returns the exit status of the child process.
-// Special return values might indicate timeout (-SIGALRM) or crash (signal number).
+// Extra flags appended to the target compile command (NULL or "" for none).
+// Must be set before compile_target_with_clang_coverage.
+void set_target_extra_cflags(const char *flags);
+
+
+// Internal fuzzer error while setting up a run (spawn/pipe/etc.), not a target outcome
+#define FUZZER_EXEC_ERROR -999
+
+// Execute the instrumented target in a controlled environment (posix_spawn, see launch_target).
+// Return codes:
+//   0: Normal exit(0)
+//  +N: Normal exit(N) where N > 0
+//  -S: Terminated by signal S (e.g., -6 for SIGABRT, -11 for SIGSEGV, -SIGALRM for timeout)
+//  FUZZER_EXEC_ERROR: the run could not be started
 // exePath: Path to the compiled instrumented executable.
 // input: The integer input to pass to the target (via stdin pipe).
 // timeout_ms: Timeout in milliseconds for the target execution.
 int execute_target_fork(const char *exePath, int input, unsigned int timeout_ms);
 
 
+// Same, always executing the target (never answered by the execution cache,
+// nor recorded in it): for repeated runs that must observe the target itself
+int execute_target_uncached(const char *exePath, int input, unsigned int timeout_ms);
+
+
+// Wall-clock duration of the most recent execute_target_fork call (microseconds)
+unsigned int get_last_exec_time_us(void);
+
+// Override it: runs restored from the execution cache, mean exec time after calibration
+void set_last_exec_time_us(unsigned int exec_us);
+
+
+// Account an execution made by an executor worker process as the most recent
+// one (exec time and the exec latency histogram)
+void record_pooled_exec(unsigned int exec_us);
+
+
+// Start the target on 'input' (written to its stdin; stdout/stderr go to
+// /dev/null) with its coverage runtime attached to shared memory segment
+// shm_id. Returns the child's pid (the caller waits for it), or -1.
+pid_t launch_target(const char *exePath, int input, int shm_id);
+
+// Map a waitpid status to execute_target_fork's return codes. 'extra' is the
+// run's shared memory state (tells an intercepted reach_error from exit 134).
+int decode_target_status(int wait_status, const shm_extra_t *extra);
+
+
 // Execute the instrumented target with an input file instead of stdin
 int execute_target_file(const char *exePath, const char *input_file, unsigned int timeout_ms);
 
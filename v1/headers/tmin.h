@@ -0,0 +1,37 @@
+// filepath: headers/tmin.h
+#ifndef TMIN_H
+#define TMIN_H
+
+#include <stdint.h>
+#include "executor.h"
+
+// Test case minimizer. Shrinks an integer input toward 0 while it keeps
+// reproducing the same behaviour as the original:
+//   - a crash stays in the same crash bucket: same signal, same signature
+//     (faulting PC and frames) when the runtime wrote one, same reach_error label,
+//   - a timeout keeps timing out,
+//   - anything else keeps the same exit status and coverage path hash.
+// Each round builds candidates from the current best input (0, digit block
+// deletion on its decimal text, digit normalisation to '0', dropping the sign,
+// halving), runs them all in parallel on an executor pool and keeps the
+// simplest one that still reproduces. Stops when a round finds nothing smaller.
+
+#define TMIN_WORKERS 4          // Default executor workers for the tmin command
+#define TMIN_MAX_ROUNDS 64      // Upper bound on shrink rounds per input
+#define TMIN_MAX_CANDIDATES 128 // Candidates generated per round
+
+typedef struct {
+    int original_status;    // Status of the unmodified input
+    int rounds;             // Rounds that found a smaller input
+    int execs;              // Candidates executed
+} tmin_stats_t;
+
+// Is input a simpler than b? (smaller magnitude, then non-negative before negative)
+int tmin_is_simpler(int a, int b);
+
+// Minimize 'input' on 'pool'. *out receives the smallest reproducing input
+// (the input itself if nothing smaller reproduces).
+// Returns 0 on success, -1 if the original input could not be executed.
+int tmin_minimize_int(executor_pool_t* pool, int input, int* out, tmin_stats_t* stats);
+
+#endif // TMIN_H
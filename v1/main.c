@@ -10,6 +10,7 @@
 #include <unistd.h>
 #include <signal.h>
 #include <errno.h>
+#include <dirent.h>
 
 #include "headers/fuzz.h"
 #include "headers/io.h"
@@ -18,29 +19,131 @@
 #include "headers/generational.h"
 #include "headers/corpus.h"
 #include "headers/coverage.h"
+#include "headers/deterministic.h"
+#include "headers/store.h"
+#include "headers/hash.h"
+#include "headers/executor.h"
+#include "headers/tmin.h"
+#include "headers/crash.h"
+#include "headers/directed.h"
+#include "headers/perf.h"
+#include "headers/bench.h"
+#include "headers/stats.h"
+#include "headers/logger.h"
+#include "headers/fitness.h"
+#include "headers/execcache.h"
+#include "headers/calibrate.h"
+#include "headers/campaign.h"
+#include "headers/plateau.h"
+#include "headers/pipeline.h"
+#include "headers/uthash.h"
 
-#define MAX_ITERATIONS 10000
 #define CORPUS_DIR "corpus"
 #define CRASH_DIR "crashes"    // Directory for crashing inputs
 #define TIMEOUT_DIR "timeouts" // Directory for timeout inputs
 #define PROGRESS_FILE "fuzzing_progress.csv"
 #define TARGET_TIMEOUT_MS 1000
-#define FUZZER_EXEC_ERROR -999
+#define SPLICE_STALL_ITERATIONS 500 // Corpus steps (not GA generations) without a havoc find before splicing
+#define CORPUS_META_SYNC_INTERVAL 1000 // Iterations between corpus metadata syncs
 
 int minRange = INT_MIN;
 int maxRange = INT_MAX;
 coverage_t *global_coverage_map = NULL;
-const char *target_exe_path_global = NULL; // Store path for signal handler
 int random_mode = 0;
 int genetic_mode = 0;
+int deterministic_mode = 0; // Run the deterministic stage once per new corpus entry
+int resume_mode = 0;        // Load the existing corpus (and its metadata) before fuzzing
+int store_mode = 0;         // Persist corpus and findings in an append-only store
+int directed_mode = 0;      // Steer toward unreached reach_error_N labels (see directed.h)
+int dashboard_mode = 0;     // Redraw a full-screen status dashboard instead of status lines
+int exec_workers = 1;       // Executor worker processes evaluating each GA generation (-j)
+int ga_islands = 1;         // GA sub-populations with ring migration (-I)
+int pipeline_depth = PIPELINE_DEFAULT_DEPTH; // Target runs in flight per serially evaluated generation (-q)
+campaign_config_t campaign_settings = {0}; // Session limits (-E, -T, -P, -c)
+corpus_store_t corpus_store;
+corpus_store_t *active_store = NULL; // Set while the store is open
+
+// Content hashes of findings already saved this session
+typedef struct {
+    uint64_t hash; // key: input content hash, seeded by finding type
+    UT_hash_handle hh;
+} FindingHash;
+static FindingHash *saved_findings = NULL;
+
+// Remember a finding's content hash. Returns 0 if it was already saved.
+static int mark_finding_saved(uint64_t content_hash)
+{
+    FindingHash *seen;
+
+    HASH_FIND(hh, saved_findings, &content_hash, sizeof(content_hash), seen);
+    if (seen)
+        return 0;
+    seen = malloc(sizeof(FindingHash));
+    if (seen)
+    {
+        seen->hash = content_hash;
+        HASH_ADD(hh, saved_findings, hash, sizeof(seen->hash), seen);
+    }
+    return 1;
+}
+
+// Input value of a finding record in the store ("%d\n" text)
+static int store_finding_value(const corpus_store_t *store, size_t index)
+{
+    char value_buf[32];
+    uint32_t length;
+    const uint8_t *data = store_get(store, index, &length);
+    size_t n = length < sizeof(value_buf) - 1 ? length : sizeof(value_buf) - 1;
+
+    if (!data)
+        return 0;
+    memcpy(value_buf, data, n);
+    value_buf[n] = '\0';
+    return atoi(value_buf);
+}
+
+// Findings already in the store count as saved (file mode checks the files instead)
+static void seed_saved_findings(const corpus_store_t *store)
+{
+    for (size_t i = 0; i < store_count(store); i++)
+    {
+        const store_index_entry_t *e = store_entry(store, i);
+        if (e->kind == STORE_KIND_CRASH || e->kind == STORE_KIND_TIMEOUT)
+            mark_finding_saved(hash_finding(store_finding_value(store, i), e->kind == STORE_KIND_TIMEOUT));
+    }
+}
+
+// Path of the file a finding is saved to: <type dir>/finding_<input>_<content hash>
+static void finding_path(char *buf, size_t size, int input_val, const char *finding_type)
+{
+    uint64_t content_hash = hash_finding(input_val, strcmp(finding_type, CRASH_DIR) != 0);
+    snprintf(buf, size, "%s/finding_%d_%016llx", finding_type, input_val, (unsigned long long)content_hash);
+}
 
 // Function to save unique findings (crashes/timeouts)
+// Findings are deduplicated by content hash; the file name carries the hash,
+// so identical inputs map to the same file across sessions.
 void save_finding(int input_val, const char *finding_type)
 {
     char finding_dir[PATH_MAX];
     char filename[PATH_MAX];
     struct stat st = {0};
 
+    int is_crash = strcmp(finding_type, CRASH_DIR) == 0;
+    if (!mark_finding_saved(hash_finding(input_val, !is_crash)))
+        return; // Already saved this input for this finding type
+
+    // With a store, findings are appended to it instead of written as files
+    if (active_store)
+    {
+        char value_buf[32];
+        int n = snprintf(value_buf, sizeof(value_buf), "%d\n", input_val);
+        store_kind_t kind = is_crash ? STORE_KIND_CRASH : STORE_KIND_TIMEOUT;
+        if (store_append(active_store, kind, value_buf, (uint32_t)n, NULL) >= 0)
+            printf(">>> Saved %s input %d to store <<<\n", finding_type, input_val);
+        return;
+    }
+
     snprintf(finding_dir, sizeof(finding_dir), "%s", finding_type); // e.g., "crashes"
 
     // Create directory if it doesn't exist
@@ -48,20 +151,18 @@ void save_finding(int input_val, const char *finding_type)
     {
         if (mkdir(finding_dir, 0755) == -1 && errno != EEXIST)
         {
-            fprintf(stderr, "Warning: Failed to create %s directory: %s\n", finding_dir, strerror(errno));
+            LOG_W("Main", "Failed to create %s directory: %s", finding_dir, strerror(errno));
             return; // Cannot save
         }
     }
 
-    // Use input value for filename (careful with large/negative values)
-    // Consider hashing input if values are problematic for filenames
-    snprintf(filename, sizeof(filename), "%s/finding_%d_%ld", finding_dir, input_val, (long)time(NULL));
+    // Name by input value and content hash (no same-second collisions)
+    finding_path(filename, sizeof(filename), input_val, finding_type);
 
-    // Check if file already exists (simple check, might collide)
+    // Same content saved by an earlier session
     if (stat(filename, &st) == 0)
     {
-        // printf("Note: Finding file %s already exists, not overwriting.\n", filename);
-        return; // Don't overwrite for now
+        return;
     }
 
     FILE *fp = fopen(filename, "w");
@@ -73,43 +174,184 @@ void save_finding(int input_val, const char *finding_type)
     }
     else
     {
-        fprintf(stderr, "Warning: Failed to save finding to %s: %s\n", filename, strerror(errno));
+        LOG_W("Main", "Failed to save finding to %s: %s", filename, strerror(errno));
     }
 }
 
+// Delete a saved finding file. Store records are append-only: there the
+// finding's latest record is marked superseded, and store-export leaves it out.
+static void remove_finding(int input_val, const char *finding_type)
+{
+    char filename[PATH_MAX];
+
+    if (active_store)
+    {
+        store_kind_t kind = strcmp(finding_type, CRASH_DIR) == 0 ? STORE_KIND_CRASH : STORE_KIND_TIMEOUT;
+        for (size_t i = store_count(active_store); i-- > 0;)
+        {
+            const store_index_entry_t *e = store_entry(active_store, i);
+            if (e->kind != (uint32_t)kind || store_finding_value(active_store, i) != input_val)
+                continue;
+            store_index_entry_t meta;
+            memset(&meta, 0, sizeof(meta));
+            meta.ref = (uint32_t)i;
+            if (store_append(active_store, STORE_KIND_SUPERSEDED, NULL, 0, &meta) >= 0)
+                printf(">>> Replaced %s reproducer %d in store with a simpler input <<<\n", finding_type, input_val);
+            break;
+        }
+        return;
+    }
+    finding_path(filename, sizeof(filename), input_val, finding_type);
+    if (unlink(filename) == 0)
+        printf(">>> Replaced %s reproducer %s with a simpler input <<<\n", finding_type, filename);
+}
+
+// Bucket a crashing run by the signature the target runtime left in shared
+// memory. Saves the reproducer of a new bucket, and swaps a bucket's saved
+// reproducer for a simpler input when one hits it. Returns 1 for a new unique crash.
+static int record_crash(int input_val, int status)
+{
+    int previous;
+    const crash_signature_t *sig = fuzz_shared_mem.extra ? &fuzz_shared_mem.extra->crash : NULL;
+
+    if (campaign_interrupted() && -status == campaign_interrupted())
+        return 0; // Killed by the Ctrl-C that is stopping the session
+
+    // Per-label accounting for intercepted reach_error() calls
+    if (fuzz_shared_mem.extra && fuzz_shared_mem.extra->error.magic == ERROR_LABEL_MAGIC)
+    {
+        int label = fuzz_shared_mem.extra->error.label;
+        if (crash_record_error_label(label, input_val))
+        {
+            if (label == ERROR_LABEL_UNKNOWN)
+                printf("!!! Assertion failure reached with input %d (line %d) !!!\n", input_val,
+                       fuzz_shared_mem.extra->error.line);
+            else
+                printf("!!! reach_error_%d reached with input %d (%d labels so far) !!!\n", label, input_val,
+                       crash_error_label_count());
+            if (directed_mark_reached(label))
+            {
+                printf("[Directed] %d error labels left to reach\n", directed_target_count());
+                exec_cache_clear(); // Cached runs carry distances to the old targets
+            }
+        }
+    }
+
+    switch (crash_record(sig, -status, input_val, &previous))
+    {
+    case CRASH_NEW_BUCKET:
+        save_finding(input_val, CRASH_DIR);
+        return 1;
+    case CRASH_SIMPLER_REPRODUCER:
+        save_finding(input_val, CRASH_DIR);
+        remove_finding(previous, CRASH_DIR);
+        return 0;
+    default:
+        return 0;
+    }
+}
+
+// Calibrate an input about to become a corpus entry: flags its flaky edges and
+// makes its exec time the mean of several runs. Timeouts are not re-run.
+static void calibrate_new_entry(const char *target_exe, int input_val, const coverage_t *map, int status)
+{
+    if (status == -SIGALRM || status == FUZZER_EXEC_ERROR)
+        return;
+    calibrate_input(target_exe, input_val, map, TARGET_TIMEOUT_MS);
+}
+
+// Objectives of the generation being evaluated, for Pareto ranking (-F pareto)
+static fitness_objectives_t ga_objectives[POPULATION_SIZE];
+
+// Pareto fitness needs the whole generation: rank it once every individual has run
+static void addParetoScores(Individual generation[])
+{
+    static double scores[POPULATION_SIZE];
+    if (fitness_mode() != FITNESS_PARETO)
+        return;
+    fitness_pareto_scores(ga_objectives, POPULATION_SIZE, scores);
+    for (int i = 0; i < POPULATION_SIZE; i++)
+        generation[i].fitness_score += scores[i];
+}
+
+// Plateau escalation: the least fit half of the population is replaced by the
+// corpus entries covering the rarest edges, rarest fittest
+#define PLATEAU_RESEED_SIZE (POPULATION_SIZE / 2)
+
+static int compare_fitness_index(const void *a, const void *b)
+{
+    double fa = population[*(const int *)a].fitness_score;
+    double fb = population[*(const int *)b].fitness_score;
+    return (fa > fb) - (fa < fb);
+}
+
+static void reseed_population(void)
+{
+    int rare[PLATEAU_RESEED_SIZE];
+    int order[POPULATION_SIZE];
+    int count = getRareCorpusInputs(rare, PLATEAU_RESEED_SIZE);
+    if (count == 0)
+        return;
+
+    for (int i = 0; i < POPULATION_SIZE; i++)
+        order[i] = i;
+    qsort(order, POPULATION_SIZE, sizeof(order[0]), compare_fitness_index);
+    double best = population[order[POPULATION_SIZE - 1]].fitness_score;
+    for (int k = 0; k < count; k++)
+    {
+        Individual *ind = &population[order[k]];
+        ind->input_value = rare[k];
+        ind->fitness_score = best + (double)(count - k);
+        ind->timestamp = time(NULL);
+        resetIndividualCoverageMap(ind->coverage_map);
+    }
+    LOG_I("Main", "Reseeded %d GA individuals from rare-edge corpus entries", count);
+}
+
+// Plateau escalation: double the input range around its centre
+static void widen_input_range(int *min_r, int *max_r)
+{
+    if (*min_r == INT_MIN && *max_r == INT_MAX)
+        return;
+    long long half = ((long long)*max_r - *min_r) / 2 + 1;
+    long long lo = (long long)*min_r - half;
+    long long hi = (long long)*max_r + half;
+    *min_r = lo < INT_MIN ? INT_MIN : (int)lo;
+    *max_r = hi > INT_MAX ? INT_MAX : (int)hi;
+    LOG_I("Main", "Input range widened to [%d, %d]", *min_r, *max_r);
+}
+
+// SIGINT/SIGTERM: only flag the campaign to stop. The fuzzing loop sees it at its
+// next campaign_check and shuts down the normal way (pool, stats, bench report,
+// corpus metadata). A second signal terminates right away.
 void graceful_shutdown(int sig)
 {
-    fprintf(stderr, "[Main] Signal %d received, shutting down...\n", sig); // Use stderr
-    destroy_shared_memory();
-    if (global_coverage_map)
-        free(global_coverage_map);
-    if (target_exe_path_global)
-        cleanup_target(target_exe_path_global);
-    exit(0);
+    campaign_request_stop(sig);
+    signal(sig, SIG_DFL);
 }
 
 // Function to perform random fuzzing
-void randomFuzzing(const char *target_exe, int iterations, int min_r, int max_r)
+void randomFuzzing(const char *target_exe, int min_r, int max_r)
 {
-    fprintf(stderr, "[Main] Starting randomFuzzing...\n");
-    FILE *progress_file = fopen(PROGRESS_FILE, "a"); // Append mode
-    if (progress_file && ftell(progress_file) == 0)
-    { // Write header only if file is new/empty
-        fprintf(progress_file, "Iteration,Coverage,Mode,CorpusSize,Crashes,Timeouts\n");
-    }
+    LOG_I("Main", "Starting randomFuzzing...");
+    perf_init();
 
     global_coverage_map = calloc(COVERAGE_MAP_SIZE, sizeof(coverage_t));
     if (!global_coverage_map)
     { /* error */
-        if (progress_file)
-            fclose(progress_file);
         return;
     }
 
+    stats_config_t stats_config = {"random", PROGRESS_FILE, STATS_SNAPSHOT_FILE, campaign_config()->max_execs,
+                                   dashboard_mode};
+    stats_start(&stats_config);
+
     int crashes = 0;
     int timeouts = 0;
+    int edges = 0;
 
-    for (int i = 0; i < iterations; i++)
+    int i;
+    for (i = 0; campaign_check(edges, crashes) == CAMPAIGN_RUNNING; i++)
     {
         long long range_size = (long long)max_r - min_r + 1;
         int random_input = min_r;
@@ -120,18 +362,23 @@ void randomFuzzing(const char *target_exe, int iterations, int min_r, int max_r)
 
         int status = execute_target_fork(target_exe, random_input, TARGET_TIMEOUT_MS);
 
-        update_global_coverage(global_coverage_map);
+        edges += update_global_coverage(global_coverage_map);
+        STATS_SET(edges, edges);
 
         // **FIX:** Check status codes correctly
         if (status < 0 && status != -SIGALRM && status != FUZZER_EXEC_ERROR)
         { // Negative other than timeout/internal error = Signal Crash
-            crashes++;
-            printf("!!! Random Crash found with input: %d (Iteration: %d, Signal: %d) !!!\n", random_input, i, -status);
-            save_finding(random_input, CRASH_DIR);
+            if (record_crash(random_input, status))
+            {
+                crashes++;
+                STATS_SET(crashes, crashes);
+                printf("!!! Random Crash found with input: %d (Iteration: %d, Signal: %d) !!!\n", random_input, i, -status);
+            }
         }
         else if (status == -SIGALRM)
         {
             timeouts++;
+            STATS_SET(timeouts, timeouts);
             printf("!!! Random Timeout found with input: %d (Iteration: %d) !!!\n", random_input, i);
             save_finding(random_input, TIMEOUT_DIR);
         }
@@ -142,61 +389,239 @@ void randomFuzzing(const char *target_exe, int iterations, int min_r, int max_r)
         }
         else if (status == FUZZER_EXEC_ERROR)
         {
-            fprintf(stderr, "Warning: Fuzzer execution error for input %d\n", random_input);
+            LOG_W("Main", "Fuzzer execution error for input %d", random_input);
         }
 
-        if (i % 100 == 0 || i == iterations - 1)
-        {
-            int current_total_coverage = count_covered_edges(global_coverage_map);
-            printf("Iter %d: Total Cov %d, Crashes %d, Timeouts %d\n",
-                   i, current_total_coverage, crashes, timeouts);
-            if (progress_file)
-            {
-                // Use dummy values for corpus size in random mode
-                fprintf(progress_file, "%d,%d,random,0,%d,%d\n", i, current_total_coverage, crashes, timeouts);
-                fflush(progress_file);
-            }
-        }
+        STATS_SET(iterations, i + 1); // Status output and the progress file come from the stats thread
     }
+    stats_stop();
     printf("\n=== Random fuzzing completed ===\n");
-    printf("Total iterations: %d\n", iterations);
+    printf("Total iterations: %d\n", i);
+    printf("Stopped by %s after %llu execs\n", campaign_stop_reason(), (unsigned long long)campaign_execs());
     printf("Final total coverage: %d paths\n", count_covered_edges(global_coverage_map));
-    printf("Crashes: %d, Timeouts: %d\n", crashes, timeouts);
+    printf("Crashes: %d unique (%d crashing runs), Timeouts: %d\n", crashes, crash_total_count(), timeouts);
+    crash_print_summary();
+    crash_cleanup();
+    perf_print_summary();
+    exec_cache_print_summary();
     dump_coverage_summary(global_coverage_map);
+}
+
+// State shared with the deterministic stage's batch callback
+typedef struct {
+    const char *target_exe;
+    int min_r;
+    int max_r;
+    int iter;
+    int *crashes;
+    int *timeouts;
+    int *last_corpus_update;
+    executor_pool_t *pool;     // GA executor pool, or NULL
+    exec_pipeline_t *pipeline; // GA pipeline, or NULL (neither: one run at a time)
+} det_context_t;
+
+// Execute a batch of deterministic candidates (4-byte ints) and triage each result.
+// The candidates are independent, so the batch runs on the executor pool or the
+// pipeline when one is up. Returns nonzero once the campaign has to stop.
+static int det_exec_batch(const uint8_t *inputs, size_t len, int count, uint64_t *path_hashes, void *ctx)
+{
+    det_context_t *dc = (det_context_t *)ctx;
+    static coverage_t det_maps[DET_BATCH_SIZE][COVERAGE_MAP_SIZE];
+    static exec_result_t det_results[DET_BATCH_SIZE];
+    static exec_run_extra_t det_extras[DET_BATCH_SIZE];
+    coverage_t *maps[DET_BATCH_SIZE];
+    int run_inputs[DET_BATCH_SIZE];
+    int candidate_of[DET_BATCH_SIZE];
+    int runs = 0;
+    int targets_left = directed_target_count();
+
+    for (int i = 0; i < count; i++)
+    {
+        int input_val;
+        memcpy(&input_val, inputs + (size_t)i * len, sizeof(input_val));
+        if (input_val < dc->min_r || input_val > dc->max_r)
+            continue; // Out of range: leave the base hash so the byte looks ineffective
+        maps[runs] = det_maps[runs];
+        candidate_of[runs] = i;
+        run_inputs[runs++] = input_val;
+    }
+    if (dc->pool && runs > 0)
+        executor_pool_run_maps(dc->pool, run_inputs, runs, det_results, maps, det_extras);
+    else if (dc->pipeline && runs > 0)
+        exec_pipeline_submit(dc->pipeline, run_inputs, runs, maps);
+
+    for (int k = 0; k < runs; k++)
+    {
+        int input_val = run_inputs[k];
+        const coverage_t *map;
+        int status;
+        if (dc->pool || dc->pipeline)
+        {
+            if (dc->pipeline)
+                exec_pipeline_next(dc->pipeline, &det_results[k], &det_extras[k]);
+            executor_replay_result(&det_results[k], &det_extras[k]);
+            status = det_results[k].status;
+            map = maps[k];
+        }
+        else
+        {
+            status = execute_target_fork(dc->target_exe, input_val, TARGET_TIMEOUT_MS);
+            map = fuzz_shared_mem.map;
+        }
+        if (status == FUZZER_EXEC_ERROR || !map)
+            continue;
+
+        path_hashes[candidate_of[k]] = coverage_path_hash(map);
+        int new_edges = evaluate_coverage_map(map);
+        if (new_edges > 0)
+        {
+            printf("+++ Deterministic: %d new edges with input %d (Iteration: %d) +++\n", new_edges, input_val, dc->iter);
+            calibrate_new_entry(dc->target_exe, input_val, map, status);
+            saveToCorpus(input_val, map, new_edges, 1);
+            *dc->last_corpus_update = dc->iter;
+        }
 
-    if (progress_file)
-        fclose(progress_file);
+        if (status < 0 && status != -SIGALRM)
+        {
+            *dc->crashes += record_crash(input_val, status);
+        }
+        else if (status == -SIGALRM)
+        {
+            (*dc->timeouts)++;
+            save_finding(input_val, TIMEOUT_DIR);
+        }
+    }
+    if (directed_target_count() != targets_left)
+    {
+        if (dc->pool)
+            executor_pool_sync_directed(dc->pool);
+        if (dc->pipeline)
+            exec_pipeline_sync_directed(dc->pipeline);
+    }
+    return campaign_check(global_coverage_edges(), *dc->crashes) != CAMPAIGN_RUNNING;
 }
 
-// Function to perform grey box fuzzing
-void greyBoxFuzzing(const char *target_exe, int iterations, int min_r, int max_r)
+// Run the deterministic stage on a corpus entry that hasn't had it yet
+static void run_deterministic_stage(CorpusEntry *entry, det_context_t *dc)
 {
-    fprintf(stderr, "[Main] Starting greyBoxFuzzing...\n");
-    FILE *progress_file = fopen(PROGRESS_FILE, "a"); // Append mode
-    if (progress_file && ftell(progress_file) == 0)
-    { // Write header only if file is new/empty
-        fprintf(progress_file, "Iteration,Coverage,Mode,CorpusSize,Crashes,Timeouts\n");
+    det_stats_t det_stats;
+    int input_val = entry->input_value;
+    uint64_t base_hash = coverage_path_hash(entry->coverage_map);
+
+    entry->det_done = 1;
+    if (det_stage_run((const uint8_t *)&input_val, sizeof(input_val), base_hash,
+                      det_exec_batch, dc, &det_stats) != 0)
+    {
+        LOG_W("Main", "Iteration %d: Deterministic stage failed for input %d", dc->iter, input_val);
+        return;
+    }
+    if (det_stats.aborted)
+    {
+        entry->det_done = 0; // Stopped mid-stage: run it again on resume
+        printf("Deterministic stage on input %d stopped after %d execs\n", input_val, det_stats.execs);
+        return;
     }
+    printf("Deterministic stage on input %d: %d execs, %d effective bytes, %d skipped\n",
+           input_val, det_stats.execs, det_stats.effective_bytes, det_stats.skipped_bytes);
+}
+
+// Re-run a loaded corpus entry that has no metadata sidecar
+static void reevaluate_corpus_entry(CorpusEntry *entry, void *ctx)
+{
+    const char *target_exe = (const char *)ctx;
+
+    if (!entry->needs_eval)
+        return;
+
+    int status = execute_target_fork(target_exe, entry->input_value, TARGET_TIMEOUT_MS);
+    if (status == FUZZER_EXEC_ERROR || !fuzz_shared_mem.map)
+        return;
+
+    int new_edges = evaluate_coverage();
+    updateCorpusEntryCoverage(entry, fuzz_shared_mem.map, new_edges);
+}
+
+// Function to perform grey box fuzzing
+void greyBoxFuzzing(const char *target_exe, int min_r, int max_r)
+{
+    LOG_I("Main", "Starting greyBoxFuzzing...");
+    perf_init();
 
     // Use static global_cov_map in coverage.c to track coverage
-    fprintf(stderr, "[Main] Using static global_cov_map for coverage tracking...\n");
+    LOG_I("Main", "Using static global_cov_map for coverage tracking...");
 
-    fprintf(stderr, "[Main] Initializing corpus...\n");
+    LOG_I("Main", "Initializing corpus...");
     if (initializeCorpus(CORPUS_DIR) != 0)
     {
-        fprintf(stderr, "[Main] Error: Failed to initialize corpus\n");
-        if (progress_file)
-            fclose(progress_file);
+        LOG_E("Main", "Failed to initialize corpus");
         return;
     }
 
-    fprintf(stderr, "[Main] Initializing populations...\n");
+    if (store_mode)
+    {
+        LOG_I("Main", "Opening corpus store in %s...", CORPUS_DIR);
+        if (store_open(&corpus_store, CORPUS_DIR) != 0)
+        {
+            LOG_E("Main", "Failed to open corpus store");
+            return;
+        }
+        active_store = &corpus_store;
+        setCorpusStore(active_store);
+        seed_saved_findings(active_store);
+    }
+
+    if (resume_mode)
+    {
+        LOG_I("Main", "Resuming from existing corpus...");
+        if (loadCorpus(CORPUS_DIR) > 0)
+        {
+            corpusForEach(reevaluate_corpus_entry, (void *)target_exe);
+            syncCorpusMetadata(0);
+        }
+        LOG_I("Main", "Resumed corpus size: %d, coverage: %d",
+                getCorpusSize(), global_coverage_edges());
+    }
+
+    LOG_I("Main", "Initializing populations...");
     initializePopulations();
+    int workers = exec_workers;
+    if (ga_islands > 1)
+    {
+        LOG_I("Main", "GA split into %d islands", setIslandCount(ga_islands));
+        if (workers == 1)
+            workers = getIslandCount(); // Default to one executor worker per island
+    }
+
+    // GA generations are evaluated as one batch across the workers
+    executor_pool_t ga_pool;
+    int ga_pool_active = 0;
+    if (workers > 1)
+    {
+        LOG_I("Main", "Starting %d executor workers for GA generations...", workers);
+        if (executor_pool_start(&ga_pool, target_exe, workers, TARGET_TIMEOUT_MS) == 0)
+            ga_pool_active = 1;
+        else
+            LOG_W("Main", "Executor pool unavailable, evaluating generations serially");
+    }
+
+    // Without workers, generations are pipelined: several runs in flight, evaluated in order
+    static exec_pipeline_t ga_pipeline;
+    int ga_pipeline_active = 0;
+    if (!ga_pool_active && pipeline_depth > 1)
+    {
+        if (exec_pipeline_start(&ga_pipeline, target_exe, pipeline_depth, TARGET_TIMEOUT_MS) == 0)
+        {
+            LOG_I("Main", "Pipelining GA generations, %d runs in flight", ga_pipeline.depth);
+            ga_pipeline_active = 1;
+        }
+        else
+            LOG_W("Main", "Execution pipeline unavailable, evaluating generations one run at a time");
+    }
 
     printf("Starting grey-box fuzzing with coverage feedback...\n");
 
     // Initialize population & evaluate initial inputs
-    fprintf(stderr, "[Main] Initializing population & evaluating initial inputs...\n");
+    LOG_I("Main", "Initializing population & evaluating initial inputs...");
     int initial_crashes = 0;
     int initial_timeouts = 0;
     for (int i = 0; i < POPULATION_SIZE; i++) {
@@ -211,21 +636,24 @@ void greyBoxFuzzing(const char *target_exe, int iterations, int min_r, int max_r
 
         // Evaluate coverage for this input
         int new_edges = evaluate_coverage();
-        population[i].fitness_score = new_edges;
+        // Timed-out runs only earn their new edges: rewarding them would breed more timeouts
+        population[i].fitness_score = fitness_evaluate(status == -SIGALRM ? NULL : fuzz_shared_mem.map, new_edges,
+                                                       get_last_exec_time_us(), &ga_objectives[i]) +
+                                      directed_fitness_bonus(directed_last_distance());
         // Snapshot coverage map
         if (fuzz_shared_mem.map) memcpy(population[i].coverage_map, fuzz_shared_mem.map, COVERAGE_MAP_SIZE);
         else memset(population[i].coverage_map, 0, COVERAGE_MAP_SIZE);
 
         // If this input discovered new edges, add to corpus
         if (new_edges > 0) {
+            calibrate_new_entry(target_exe, population[i].input_value, fuzz_shared_mem.map, status);
             saveToCorpus(population[i].input_value, fuzz_shared_mem.map, population[i].fitness_score, 1);
         }
 
         // Count initial crashes/timeouts from population seeding
         if (status < 0 && status != -SIGALRM && status != FUZZER_EXEC_ERROR)
         {
-            initial_crashes++;
-            save_finding(population[i].input_value, CRASH_DIR);
+            initial_crashes += record_crash(population[i].input_value, status);
         }
         else if (status == -SIGALRM)
         {
@@ -234,45 +662,66 @@ void greyBoxFuzzing(const char *target_exe, int iterations, int min_r, int max_r
         }
     }
 
-    fprintf(stderr, "[Main] Population initialized. Initial corpus size: %d\n", getCorpusSize());
+    addParetoScores(population);
+    LOG_I("Main", "Population initialized. Initial corpus size: %d", getCorpusSize());
 
-    if (progress_file)
-    {
-        int initial_coverage = count_covered_edges(global_coverage_map);
-        fprintf(progress_file, "0,%d,greybox,%d,%d,%d\n", initial_coverage, getCorpusSize(), initial_crashes, initial_timeouts);
-        fflush(progress_file);
-    }
+    stats_config_t stats_config = {"greybox", PROGRESS_FILE, STATS_SNAPSHOT_FILE, campaign_config()->max_execs,
+                                   dashboard_mode};
+    stats_start(&stats_config);
+    STATS_SET(edges, global_coverage_edges());
+    STATS_SET(corpus_size, getCorpusSize());
+    STATS_SET(crashes, initial_crashes);
+    STATS_SET(timeouts, initial_timeouts);
 
     int last_corpus_update = 0;
+    int havoc_stall = 0; // Corpus steps since a corpus mutation last found new coverage
     int crashes = initial_crashes; // Start counting from initial phase
     int timeouts = initial_timeouts;
 
-    fprintf(stderr, "[Main] Starting main fuzzing loop...\n");
-    for (int iter = 1; iter <= iterations; iter++)
+    LOG_I("Main", "Starting main fuzzing loop...");
+    plateau_start();
+    int iter;
+    for (iter = 1; campaign_check(global_coverage_edges(), crashes) == CAMPAIGN_RUNNING; iter++)
     { // Start iter from 1
-        // Status update per iteration
-        printf("[Main] Iteration %d/%d - Coverage: %d, Corpus: %d\n",
-               iter, iterations,
-               count_covered_edges(global_cov_map),
-               getCorpusSize());
-
         int input_val;
-        int generated_new = 0; // Flag if *corpus* got a new entry this iteration
+        int from_corpus = 0;   // Flag if input_val was mutated from a corpus entry
+        uint64_t mutation_start;
+        uint64_t stage_start_execs = campaign_execs();
 
         // --- Input Selection Strategy ---
-        // Simplified: 50% Corpus (mutate/crossover), 50% GA
-        if (getCorpusSize() > 0 && rand() % 2 == 0)
+        // Corpus mutation or a GA generation, whichever is behind its share of the executions
+        campaign_stage_t stage = campaign_next_stage(getCorpusSize());
+        if (stage == CAMPAIGN_STAGE_CORPUS)
         {
             CorpusEntry *entry = selectCorpusEntry();
             if (!entry) {
-                fprintf(stderr, "[Main %d] Error: selectCorpusEntry returned NULL despite corpus size > 0. Skipping corpus step.\n", iter);
+                LOG_E("Main", "Iteration %d: selectCorpusEntry returned NULL despite corpus size > 0. Skipping corpus step.", iter);
                 // Force GA path or skip iteration? Let's try forcing GA.
                 goto use_ga; // Jump to the 'else' block for GA
                 // continue; // Alternative: Skip this iteration
            }
 
+            // Deterministic pass, once per entry, before it is handed to havoc
+            if (deterministic_mode && !entry->det_done)
+            {
+                det_context_t dc = {target_exe, min_r, max_r, iter, &crashes, &timeouts, &last_corpus_update,
+                                    ga_pool_active ? &ga_pool : NULL, ga_pipeline_active ? &ga_pipeline : NULL};
+                run_deterministic_stage(entry, &dc);
+            }
+
+            from_corpus = 1;
+            havoc_stall++; // Counted per corpus step: GA generations don't advance it
+            mutation_start = perf_now_ns();
             int mutation_type = rand() % 10;
-            if (mutation_type < 7 || getCorpusSize() < 2)
+            if (havoc_stall > SPLICE_STALL_ITERATIONS && getCorpusSize() >= 2)
+            { // Havoc stalled: splice two entries, then havoc the result
+                CorpusEntry *entry2 = selectCorpusEntry();
+                if (!entry2 || entry == entry2)
+                    input_val = mutateHavoc(entry->input_value);
+                else
+                    input_val = mutateHavoc(mutateSplice(entry->input_value, entry2->input_value));
+            }
+            else if (mutation_type < 7 || getCorpusSize() < 2)
             { // Mutate/Havoc
                 input_val = mutateHavoc(entry->input_value);
             }
@@ -284,30 +733,69 @@ void greyBoxFuzzing(const char *target_exe, int iterations, int min_r, int max_r
                 else
                     input_val = crossover(entry->input_value, entry2->input_value);
             }
+            perf_record_since(PERF_STAGE_MUTATION, mutation_start);
         }
         else
         { // GA-based generation
 use_ga:
-            generateNewPopulation(population, POPULATION_SIZE, next_generation, min_r, max_r);
+            stage = CAMPAIGN_STAGE_GA;
+            mutation_start = perf_now_ns();
+            generateIslandPopulations(population, next_generation, min_r, max_r);
+            perf_record_since(PERF_STAGE_MUTATION, mutation_start);
+            static exec_result_t ga_results[POPULATION_SIZE];
+            static exec_run_extra_t ga_extras[POPULATION_SIZE];
+            int targets_left = directed_target_count();
+            if (ga_pool_active || ga_pipeline_active)
+            { // Pool: run the whole generation first, workers copy each run's map straight into the individual.
+              // Pipeline: queue it, so later individuals run while earlier ones are evaluated below.
+                int ga_inputs[POPULATION_SIZE];
+                coverage_t *ga_maps[POPULATION_SIZE];
+                for (int i = 0; i < POPULATION_SIZE; i++)
+                {
+                    ga_inputs[i] = next_generation[i].input_value;
+                    ga_maps[i] = next_generation[i].coverage_map;
+                }
+                if (ga_pool_active)
+                    executor_pool_run_maps(&ga_pool, ga_inputs, POPULATION_SIZE, ga_results, ga_maps, ga_extras);
+                else
+                    exec_pipeline_submit(&ga_pipeline, ga_inputs, POPULATION_SIZE, ga_maps);
+            }
+            // Results are merged in individual order whichever worker ran them, so seeded runs reproduce
             for (int i = 0; i < POPULATION_SIZE; i++) {
-                int status_ga = execute_target_fork(target_exe, next_generation[i].input_value, TARGET_TIMEOUT_MS);
-                // Evaluate coverage and fitness
-                int new_edges_ga = evaluate_coverage();
-                next_generation[i].fitness_score = new_edges_ga;
-                // Snapshot coverage
-                if (fuzz_shared_mem.map) memcpy(next_generation[i].coverage_map, fuzz_shared_mem.map, COVERAGE_MAP_SIZE);
-                else memset(next_generation[i].coverage_map, 0, COVERAGE_MAP_SIZE);
+                int status_ga;
+                int new_edges_ga;
+                if (ga_pool_active || ga_pipeline_active)
+                {
+                    if (ga_pipeline_active)
+                        exec_pipeline_next(&ga_pipeline, &ga_results[i], &ga_extras[i]);
+                    executor_replay_result(&ga_results[i], &ga_extras[i]);
+                    status_ga = ga_results[i].status;
+                    new_edges_ga = evaluate_coverage_map(next_generation[i].coverage_map);
+                }
+                else
+                {
+                    status_ga = execute_target_fork(target_exe, next_generation[i].input_value, TARGET_TIMEOUT_MS);
+                    new_edges_ga = evaluate_coverage();
+                    // Snapshot coverage
+                    if (fuzz_shared_mem.map) memcpy(next_generation[i].coverage_map, fuzz_shared_mem.map, COVERAGE_MAP_SIZE);
+                    else memset(next_generation[i].coverage_map, 0, COVERAGE_MAP_SIZE);
+                }
+                // Fitness
+                next_generation[i].fitness_score =
+                    fitness_evaluate(status_ga == -SIGALRM ? NULL : next_generation[i].coverage_map, new_edges_ga,
+                                     get_last_exec_time_us(), &ga_objectives[i]) +
+                    directed_fitness_bonus(directed_last_distance());
                 // If new edges discovered, record and add to corpus
                 if (new_edges_ga > 0) {
-                    saveToCorpus(next_generation[i].input_value, fuzz_shared_mem.map, new_edges_ga, 1);
-                    generated_new = 1;
+                    calibrate_new_entry(target_exe, next_generation[i].input_value, next_generation[i].coverage_map,
+                                        status_ga);
+                    saveToCorpus(next_generation[i].input_value, next_generation[i].coverage_map, new_edges_ga, 1);
                     last_corpus_update = iter;
                 }
                 // **FIX:** Check status codes correctly for GA runs
                 if (status_ga < 0 && status_ga != -SIGALRM && status_ga != FUZZER_EXEC_ERROR)
                 {
-                    crashes++;
-                    save_finding(next_generation[i].input_value, CRASH_DIR);
+                    crashes += record_crash(next_generation[i].input_value, status_ga);
                 }
                 else if (status_ga == -SIGALRM)
                 {
@@ -316,13 +804,15 @@ use_ga:
                 }
                 // ...other status handling...
             }
+            if (ga_pool_active && directed_target_count() != targets_left)
+                executor_pool_sync_directed(&ga_pool); // Workers still steer toward labels reached meanwhile
+            if (ga_pipeline_active && directed_target_count() != targets_left)
+                exec_pipeline_sync_directed(&ga_pipeline);
+            addParetoScores(next_generation);
             // Replace population
-            for (int i = 0; i < POPULATION_SIZE; ++i)
-            {
-                population[i].input_value = next_generation[i].input_value;
-                population[i].fitness_score = next_generation[i].fitness_score;
-                memcpy(population[i].coverage_map, next_generation[i].coverage_map, COVERAGE_MAP_SIZE);
-            }
+            swapPopulations();
+            if (migrateIslands(population))
+                LOG_D("Main", "Iteration %d: islands exchanged migrants", iter);
             input_val = population[rand() % POPULATION_SIZE].input_value; // Select one from new pop for main check
         }
 
@@ -340,8 +830,17 @@ use_ga:
             int new_edges = evaluate_coverage();
             if (new_edges > 0) {
                 printf("+++ New coverage: %d new edges with input %d (Iteration: %d) +++\n", new_edges, input_val, iter);
+                calibrate_new_entry(target_exe, input_val, fuzz_shared_mem.map, status);
                 saveToCorpus(input_val, fuzz_shared_mem.map, new_edges, 1);
-                generated_new = 1;
+                last_corpus_update = iter;
+                if (from_corpus)
+                    havoc_stall = 0;
+            }
+            else if (directed_enabled() && directed_last_distance() < directed_best_distance())
+            { // No new edges, but closer to an unreached label than any seed so far
+                printf("+++ Directed: distance %.2f with input %d (Iteration: %d) +++\n",
+                       (double)directed_last_distance() / DIRECTED_DIST_SCALE, input_val, iter);
+                saveToCorpus(input_val, fuzz_shared_mem.map, 0.0, 1);
                 last_corpus_update = iter;
             }
         }
@@ -350,9 +849,11 @@ use_ga:
 
         if (status < 0 && status != -SIGALRM && status != FUZZER_EXEC_ERROR)
         { // Crash
-            crashes++;
-            printf("!!! Crash found with input: %d (Iteration: %d, Signal: %d) !!!\n", input_val, iter, -status);
-            save_finding(input_val, CRASH_DIR);
+            if (record_crash(input_val, status))
+            {
+                crashes++;
+                printf("!!! Crash found with input: %d (Iteration: %d, Signal: %d) !!!\n", input_val, iter, -status);
+            }
             // Also add crashing input to corpus? Might be useful for mutation.
             if (fuzz_shared_mem.map)
             {                                                         // Save with coverage map if available
@@ -362,7 +863,6 @@ use_ga:
             {
                 saveToCorpus(input_val, NULL, 0.0, 1);
             }
-            generated_new = 1; // Counts as corpus update for stagnation check
         }
         else if (status == -SIGALRM)
         { // Timeout
@@ -373,7 +873,6 @@ use_ga:
                 saveToCorpus(input_val, fuzz_shared_mem.map, 0.0, 1);
             else
                 saveToCorpus(input_val, NULL, 0.0, 1);
-            generated_new = 1;
         }
         else if (status > 0)
         {   // Non-zero exit
@@ -381,22 +880,31 @@ use_ga:
         }
         else if (status == FUZZER_EXEC_ERROR)
         { // Fuzzer internal error
-            fprintf(stderr, "Warning: Fuzzer execution error for input %d\n", input_val);
+            LOG_W("Main", "Fuzzer execution error for input %d", input_val);
         }
 
+        campaign_account(stage, stage_start_execs);
+
+        // --- Strategy switching on coverage plateaus ---
+        int plateau_actions = plateau_update(campaign_execs(), global_coverage_edges());
+        if (plateau_actions & PLATEAU_ACTION_RESEED_GA)
+            reseed_population();
+        if (plateau_actions & PLATEAU_ACTION_WIDEN_RANGE)
+            widen_input_range(&min_r, &max_r);
+
+        // --- Counters for the stats thread (status line, dashboard, progress file) ---
+        STATS_SET(iterations, iter);
+        STATS_SET(edges, global_coverage_edges());
+        STATS_SET(corpus_size, getCorpusSize());
+        STATS_SET(crashes, crashes);
+        STATS_SET(timeouts, timeouts);
+
         // --- Periodic Actions ---
-        if (iter % 100 == 0 || iter == iterations || generated_new)
+
+        // Persist updated entries for resume (scheduling counters are written at shutdown)
+        if (iter % CORPUS_META_SYNC_INTERVAL == 0)
         {
-            int current_total_coverage = count_covered_edges(global_cov_map);
-            int corpus_s = getCorpusSize();
-            printf("Iter %d: Total Cov %d, Corpus %d, Crashes %d, Timeouts %d\n",
-                   iter, current_total_coverage, corpus_s, crashes, timeouts);
-            if (progress_file)
-            {
-                fprintf(progress_file, "%d,%d,greybox,%d,%d,%d\n",
-                        iter, current_total_coverage, corpus_s, crashes, timeouts);
-                fflush(progress_file);
-            }
+            syncCorpusMetadata(0);
         }
 
         // Corpus minimization (optional, based on stagnation)
@@ -407,155 +915,483 @@ use_ga:
             last_corpus_update = iter;
         }
     }
-    fprintf(stderr, "[Main] Fuzzing loop finished.\n"); // Log loop exit
+    LOG_I("Main", "Fuzzing loop finished."); // Log loop exit
+    stats_stop();
     printf("\n=== Grey box fuzzing completed ===\n");
-    printf("Total iterations: %d\n", iterations);
-    printf("Crashes: %d, Timeouts: %d\n", crashes, timeouts);
+    printf("Total iterations: %d\n", iter - 1);
+    printf("Stopped by %s after %llu execs (GA generations %llu, corpus mutation %llu)\n", campaign_stop_reason(),
+           (unsigned long long)campaign_execs(), (unsigned long long)campaign_stage_execs(CAMPAIGN_STAGE_GA),
+           (unsigned long long)campaign_stage_execs(CAMPAIGN_STAGE_CORPUS));
+    printf("Crashes: %d unique (%d crashing runs), Timeouts: %d\n", crashes, crash_total_count(), timeouts);
+    crash_print_summary();
+    crash_cleanup();
+    directed_print_summary();
+    perf_print_summary();
+    exec_cache_print_summary();
+    calibration_print_summary();
+    plateau_print_summary();
     printCorpusStats();
     dump_coverage_summary(global_coverage_map);
 
+    syncCorpusMetadata(1); // Scheduling counters too
+    if (ga_pool_active)
+        executor_pool_stop(&ga_pool);
+    if (ga_pipeline_active)
+        exec_pipeline_stop(&ga_pipeline);
     cleanupPopulations();
+    fitness_cleanup();
+    cleanupCorpus();
+    if (active_store)
+    {
+        setCorpusStore(NULL);
+        store_close(active_store);
+        active_store = NULL;
+    }
+}
+
+// "store-export" tool: write a corpus store out to the per-file directory layout
+static int store_export_command(int argc, char *argv[])
+{
+    corpus_store_t store;
+
+    if (argc != 4)
+    {
+        fprintf(stderr, "Usage: %s store-export <store_dir> <out_dir>\n", argv[0]);
+        return 1;
+    }
+    if (store_open(&store, argv[2]) != 0)
+        return 1;
+
+    int written = store_export(&store, argv[3]);
+    store_close(&store);
+    return written < 0 ? 1 : 0;
+}
+
+// Resolve a target source file and compile it with coverage instrumentation.
+// exe_path receives "<source dir>/<source name without extension>_fuzz".
+// Returns 0 on success, -1 on failure.
+static int prepare_target(const char *filename, char *exe_path, size_t exe_path_size)
+{
+    LOG_I("Main", "Resolving paths...");
+    char *fullPath = realpath(filename, NULL);
+    if (!fullPath)
+    {
+        LOG_E("Main", "Cannot resolve %s: %s", filename, strerror(errno));
+        return -1;
+    }
+    char *temp_path_dir = strdup(fullPath);
+    char *temp_path_base = strdup(fullPath);
+    int result = -1;
+
+    if (temp_path_dir && temp_path_base)
+    {
+        const char *source_dir = dirname(temp_path_dir);
+        const char *base_filename = basename(temp_path_base);
+        char base_name_no_ext[PATH_MAX], target_exe_name[PATH_MAX];
+
+        snprintf(base_name_no_ext, sizeof(base_name_no_ext), "%s", base_filename);
+        char *dot = strrchr(base_name_no_ext, '.');
+        if (dot)
+            *dot = '\0';
+        snprintf(target_exe_name, sizeof(target_exe_name), "%s_fuzz", base_name_no_ext);
+        snprintf(exe_path, exe_path_size, "%s/%s", source_dir, target_exe_name);
+        LOG_I("Main", "Target source dir: %s", source_dir);
+        LOG_I("Main", "Target base name: %s", base_filename);
+        LOG_I("Main", "Output executable: %s", exe_path);
+
+        LOG_I("Main", "Compiling target...");
+        if (compile_target_with_clang_coverage(source_dir, base_filename, target_exe_name) == 0)
+            result = 0;
+        else
+            LOG_E("Main", "Failed to compile target.");
+    }
+
+    free(fullPath);
+    free(temp_path_dir);
+    free(temp_path_base);
+    return result;
+}
+
+// Minimize one input file with tmin and write the result to out_path
+static int tmin_file(executor_pool_t *pool, const char *in_path, const char *out_path)
+{
+    int input, minimized;
+    tmin_stats_t stats;
+
+    FILE *fp = fopen(in_path, "r");
+    if (!fp)
+    {
+        fprintf(stderr, "Warning: Failed to open %s: %s\n", in_path, strerror(errno));
+        return -1;
+    }
+    int parsed = fscanf(fp, "%d", &input);
+    fclose(fp);
+    if (parsed != 1)
+    {
+        fprintf(stderr, "Warning: Failed to parse input value from %s\n", in_path);
+        return -1;
+    }
+
+    if (tmin_minimize_int(pool, input, &minimized, &stats) != 0)
+        return -1;
+
+    fp = fopen(out_path, "w");
+    if (!fp)
+    {
+        fprintf(stderr, "Warning: Failed to write %s: %s\n", out_path, strerror(errno));
+        return -1;
+    }
+    fprintf(fp, "%d\n", minimized);
+    fclose(fp);
+    printf("tmin: %s: %d -> %d (status %d, %d rounds, %d execs)\n",
+           in_path, input, minimized, stats.original_status, stats.rounds, stats.execs);
+    return 0;
+}
+
+// "tmin" tool: shrink crash/timeout/corpus inputs while preserving their behaviour.
+// <input> may be a file (output defaults to <input>.min) or a directory of inputs.
+static int tmin_command(int argc, char *argv[])
+{
+    int workers = TMIN_WORKERS;
+    int argi = 2;
+    char target_exe_path[PATH_MAX];
+    char out_default[PATH_MAX];
+    struct stat st;
+
+    if (argc > argi + 1 && strcmp(argv[argi], "-j") == 0)
+    {
+        workers = atoi(argv[argi + 1]);
+        argi += 2;
+    }
+    if (argc - argi < 2 || argc - argi > 3)
+    {
+        fprintf(stderr, "Usage: %s tmin [-j workers] <target.c> <input_file|input_dir> [output]\n", argv[0]);
+        return 1;
+    }
+    const char *target_src = argv[argi];
+    const char *in_path = argv[argi + 1];
+    const char *out_path = argc - argi == 3 ? argv[argi + 2] : NULL;
+
+    if (stat(in_path, &st) != 0)
+    {
+        fprintf(stderr, "Error: %s not found\n", in_path);
+        return 1;
+    }
+    int is_dir = S_ISDIR(st.st_mode);
+    if (!out_path)
+    {
+        snprintf(out_default, sizeof(out_default), "%s.min", in_path);
+        out_path = out_default;
+    }
+
+    if (prepare_target(target_src, target_exe_path, sizeof(target_exe_path)) != 0)
+        return 1;
+
+    executor_pool_t pool;
+    if (executor_pool_start(&pool, target_exe_path, workers, TARGET_TIMEOUT_MS) != 0)
+        return 1;
+
+    int failures = 0;
+    if (!is_dir)
+    {
+        failures += tmin_file(&pool, in_path, out_path) != 0;
+    }
+    else
+    {
+        DIR *dir = opendir(in_path);
+        struct dirent *ent;
+        if (!dir || (mkdir(out_path, 0755) == -1 && errno != EEXIST))
+        {
+            fprintf(stderr, "Error: Cannot minimize %s into %s: %s\n", in_path, out_path, strerror(errno));
+            if (dir)
+                closedir(dir);
+            executor_pool_stop(&pool);
+            return 1;
+        }
+        while ((ent = readdir(dir)) != NULL)
+        {
+            char src[PATH_MAX], dst[PATH_MAX];
+            if (ent->d_name[0] == '.' || strstr(ent->d_name, CORPUS_META_SUFFIX))
+                continue;
+            if (snprintf(src, sizeof(src), "%s/%s", in_path, ent->d_name) >= (int)sizeof(src) ||
+                snprintf(dst, sizeof(dst), "%s/%s", out_path, ent->d_name) >= (int)sizeof(dst))
+            {
+                fprintf(stderr, "Error: Path too long, skipping %s\n", ent->d_name);
+                failures++;
+                continue;
+            }
+            if (stat(src, &st) != 0 || !S_ISREG(st.st_mode))
+                continue;
+            failures += tmin_file(&pool, src, dst) != 0;
+        }
+        closedir(dir);
+    }
+
+    executor_pool_stop(&pool);
+    return failures ? 1 : 0;
+}
+
+// "cmin" tool: minimize a corpus directory (or corpus store) into out_dir.
+// Uses the coverage saved in the metadata; entries without it are kept as-is.
+static int cmin_command(int argc, char *argv[])
+{
+    corpus_store_t store;
+    char seg_path[PATH_MAX];
+    struct stat st;
+
+    if (argc != 4)
+    {
+        fprintf(stderr, "Usage: %s cmin <corpus_dir> <out_dir>\n", argv[0]);
+        return 1;
+    }
+    if (stat(argv[2], &st) != 0 || !S_ISDIR(st.st_mode))
+    {
+        fprintf(stderr, "Error: Corpus directory %s not found\n", argv[2]);
+        return 1;
+    }
+
+    snprintf(seg_path, sizeof(seg_path), "%s/%s", argv[2], STORE_SEGMENT_FILE);
+    int use_store = stat(seg_path, &st) == 0;
+    if (use_store)
+    {
+        if (store_open(&store, argv[2]) != 0)
+            return 1;
+        setCorpusStore(&store);
+    }
+
+    int result = 1;
+    if (initializeCorpus(argv[2]) == 0 && loadCorpus(argv[2]) >= 0)
+    {
+        int before = getCorpusSize();
+        if (minimizeCorpus() >= 0 && exportCorpus(argv[3]) >= 0)
+        {
+            printf("cmin: %d -> %d entries\n", before, getCorpusSize());
+            result = 0;
+        }
+    }
+
     cleanupCorpus();
-    if (progress_file)
-        fclose(progress_file);
+    if (use_store)
+    {
+        setCorpusStore(NULL);
+        store_close(&store);
+    }
+    return result;
 }
 
 // Main function
 int main(int argc, char *argv[])
 {
-    fprintf(stderr, "[Main] Fuzzer starting...\n");
+    // Standalone tools
+    if (argc > 1 && strcmp(argv[1], "store-export") == 0)
+        return store_export_command(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "cmin") == 0)
+        return cmin_command(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "tmin") == 0)
+        return tmin_command(argc, argv);
+
+    log_init(); // Diagnostics go through the background log writer from here on
+    LOG_I("Main", "Fuzzer starting...");
     int opt;
     const char *filename = NULL;
 
-    fprintf(stderr, "[Main] Parsing arguments...\n");
-    while ((opt = getopt(argc, argv, "rgn:i:o:n:x:")) != -1)
+    LOG_I("Main", "Parsing arguments...");
+    const char *bench_report = NULL;
+    unsigned int seed = time(NULL) ^ getpid();
+    while ((opt = getopt(argc, argv, "rgdRSDUCcn:i:o:n:x:s:E:T:P:B:L:j:q:I:F:")) != -1)
     {
         switch (opt)
         {
         case 'r':
             random_mode = 1;
-            fprintf(stderr, "[Main] Arg: Random mode enabled\n"); // Add log
+            LOG_I("Main", "Arg: Random mode enabled"); // Add log
             break;
         case 'g':
             genetic_mode = 1;
-            fprintf(stderr, "[Main] Arg: Genetic mode enabled\n");
+            LOG_I("Main", "Arg: Genetic mode enabled");
+            break;
+        case 'd':
+            deterministic_mode = 1;
+            LOG_I("Main", "Arg: Deterministic stage enabled");
+            break;
+        case 'R':
+            resume_mode = 1;
+            LOG_I("Main", "Arg: Resume from existing corpus enabled");
+            break;
+        case 'S':
+            store_mode = 1;
+            LOG_I("Main", "Arg: Append-only corpus store enabled");
+            break;
+        case 'D':
+            directed_mode = 1;
+            LOG_I("Main", "Arg: Directed fuzzing toward unreached error labels enabled");
+            break;
+        case 'C':
+            exec_cache_set_enabled(0);
+            LOG_I("Main", "Arg: Execution cache disabled");
+            break;
+        case 'U':
+            dashboard_mode = 1;
+            LOG_I("Main", "Arg: Status dashboard enabled");
             break;
         case 'i':                                                               // Input target source file
             filename = optarg;                                                  // optarg contains the argument to -i
-            fprintf(stderr, "[Main] Arg: Target file set to '%s'\n", filename); // Add log
+            LOG_I("Main", "Arg: Target file set to '%s'", filename); // Add log
             break;
         // Add options for min/max range?
         case 'n':
             minRange = atoi(optarg); // Set minimum input value
-            fprintf(stderr, "[Main] Arg: minRange set to %d\n", minRange);
+            LOG_I("Main", "Arg: minRange set to %d", minRange);
             break;
         case 'x':
             maxRange = atoi(optarg); // Set maximum input value
-            fprintf(stderr, "[Main] Arg: maxRange set to %d\n", maxRange);
+            LOG_I("Main", "Arg: maxRange set to %d", maxRange);
+            break;
+        case 's':
+            seed = (unsigned int)strtoul(optarg, NULL, 10);
+            LOG_I("Main", "Arg: Seed set to %u", seed);
+            break;
+        case 'E':
+            campaign_settings.max_execs = strtoull(optarg, NULL, 10);
+            LOG_I("Main", "Arg: Exec budget set to %llu", (unsigned long long)campaign_settings.max_execs);
+            break;
+        case 'T':
+            campaign_settings.max_seconds = strtoull(optarg, NULL, 10);
+            LOG_I("Main", "Arg: Time limit set to %llus", (unsigned long long)campaign_settings.max_seconds);
+            break;
+        case 'P':
+            campaign_settings.plateau_seconds = strtoull(optarg, NULL, 10);
+            LOG_I("Main", "Arg: Stop after %llus without new coverage",
+                  (unsigned long long)campaign_settings.plateau_seconds);
+            break;
+        case 'c':
+            campaign_settings.stop_on_crash = 1;
+            LOG_I("Main", "Arg: Stop at the first unique crash");
+            break;
+        case 'B':
+            bench_report = optarg;
+            LOG_I("Main", "Arg: Benchmark report will be written to '%s'", bench_report);
+            break;
+        case 'j':
+            exec_workers = atoi(optarg);
+            if (exec_workers < 1)
+                exec_workers = 1;
+            LOG_I("Main", "Arg: %d executor workers for GA generations", exec_workers);
+            break;
+        case 'q':
+            pipeline_depth = atoi(optarg);
+            LOG_I("Main", "Arg: %d target runs in flight per GA generation", pipeline_depth);
+            break;
+        case 'I':
+            ga_islands = atoi(optarg);
+            LOG_I("Main", "Arg: %d GA islands requested", ga_islands);
+            break;
+        case 'F':
+            if (fitness_set_mode(optarg) != 0)
+            {
+                LOG_E("Main", "Unknown GA fitness '%s' (edges, novelty, rarity, pareto)", optarg);
+                return 1;
+            }
+            LOG_I("Main", "Arg: GA fitness set to %s", fitness_mode_name());
+            break;
+        case 'L':
+            if (log_parse_level(optarg) < 0)
+            {
+                LOG_E("Main", "Unknown log level '%s' (debug, info, warn, error, off)", optarg);
+                return 1;
+            }
+            log_level = log_parse_level(optarg);
+            LOG_I("Main", "Arg: Log level set to %s", optarg);
             break;
         case 'o':                                                               // Output directory? (unused for now)
-            fprintf(stderr, "[Main] Arg: Option -o found with '%s'\n", optarg); // Add log
+            LOG_I("Main", "Arg: Option -o found with '%s'", optarg); // Add log
             break;
         case '?': // Handle unknown options or missing arguments
-            fprintf(stderr, "[Main] Warning: Unknown option or missing argument for '-%c'\n", optopt);
+            LOG_W("Main", "Unknown option or missing argument for '-%c'", optopt);
             // You might want to exit here depending on desired behavior
             break;
         default:
             // Should not happen with getopt
-            fprintf(stderr, "[Main] Error: Unexpected argument parsing result.\n");
+            LOG_E("Main", "Unexpected argument parsing result.");
             return 1;
         }
     } // Keep options parsing
 
     if (random_mode && genetic_mode) {
-        fprintf(stderr, "[Main] Warning: Both random and genetic modes enabled, defaulting to genetic mode\n");
+        LOG_W("Main", "Both random and genetic modes enabled, defaulting to genetic mode");
         random_mode = 0;
     }
 
     if (!filename)
     {
-        fprintf(stderr, "[Main] Error: Target source file (-i) is required.\n");
+        LOG_E("Main", "Target source file (-i) is required.");
         return 1;
     }
-    fprintf(stderr, "[Main] Target file: %s\n", filename);
+    LOG_I("Main", "Target file: %s", filename);
 
-    fprintf(stderr, "[Main] Resolving paths...\n");
-    char *fullPath = realpath(filename, NULL);
-    if (!fullPath)
-    { /* error */
-        return 1;
-    }
-    char *temp_path_dir = strdup(fullPath);
-    char *temp_path_base = strdup(fullPath);
-    if (!temp_path_dir || !temp_path_base)
-    { /* error */ /* free */
-        return 1;
-    }
-    const char *source_dir = dirname(temp_path_dir);
-    const char *base_filename = basename(temp_path_base);
-
-    char target_exe_name[PATH_MAX], base_name_no_ext[PATH_MAX], target_exe_path[PATH_MAX];
-    // ... (generate target_exe_path as before) ...
-    snprintf(target_exe_name, sizeof(target_exe_name), "%s_fuzz", base_name_no_ext); // Simplified generation
-    snprintf(target_exe_path, sizeof(target_exe_path), "%s/%s", source_dir, target_exe_name);
-    fprintf(stderr, "[Main] Target source dir: %s\n", source_dir);
-    fprintf(stderr, "[Main] Target base name: %s\n", base_filename);
-    fprintf(stderr, "[Main] Output executable: %s\n", target_exe_path);
-    target_exe_path_global = target_exe_path; // Store globally for cleanup handler
-
-    printf("Fuzzer Info:\n"); /* ... print info ... */
-
-    fprintf(stderr, "[Main] Compiling target...\n");
-    if (compile_target_with_clang_coverage(source_dir, base_filename, target_exe_name) != 0)
+    char target_exe_path[PATH_MAX];
+    if (directed_mode)
+        set_target_extra_cflags("-finstrument-functions"); // Function entry hooks for the distance
+    if (prepare_target(filename, target_exe_path, sizeof(target_exe_path)) != 0)
     {
-        fprintf(stderr, "[Main] Error: Failed to compile target.\n");
-        free(fullPath);
-        free(temp_path_dir);
-        free(temp_path_base);
         return 1;
     }
-    fprintf(stderr, "[Main] Target compiled successfully.\n");
+    LOG_I("Main", "Target compiled successfully.");
 
-    fprintf(stderr, "[Main] Seeding RNG...\n");
-    unsigned int seed = time(NULL) ^ getpid();
-    fprintf(stderr, "[Main] Using seed: %u\n", seed);
+    LOG_I("Main", "Seeding RNG...");
+    LOG_I("Main", "Using seed: %u", seed);
     srand(seed);
 
-    fprintf(stderr, "[Main] Setting up shared memory...\n");
+    LOG_I("Main", "Setting up shared memory...");
     if (setup_shared_memory() != 0)
     {
-        fprintf(stderr, "[Main] Error: Failed to set up shared memory.\n"); // Use stderr
-        free(fullPath);
-        free(temp_path_dir);
-        free(temp_path_base);
+        LOG_E("Main", "Failed to set up shared memory.");
         cleanup_target(target_exe_path); // Clean up compiled target on error
         return 1;
     }
-    fprintf(stderr, "[Main] Shared memory setup complete.\n");
+    LOG_I("Main", "Shared memory setup complete.");
 
-    fprintf(stderr, "[Main] Setting up signal handlers...\n");
+    if (directed_mode)
+    {
+        LOG_I("Main", "Computing distances to the error labels...");
+        if (directed_init(filename) > 0)
+            directed_sync_table(fuzz_shared_mem.extra);
+        else
+            LOG_W("Main", "Directed mode unavailable, fuzzing undirected");
+    }
+
+    LOG_I("Main", "Setting up signal handlers...");
     signal(SIGINT, graceful_shutdown);
     signal(SIGTERM, graceful_shutdown);
 
+    campaign_start(&campaign_settings);
+    if (bench_report)
+    {
+        char *target_copy = strdup(filename);
+        bench_start(bench_report, random_mode ? "random" : "greybox",
+                    target_copy ? basename(target_copy) : filename, seed, campaign_config()->max_execs);
+        free(target_copy);
+    }
+
     if (random_mode)
     {
-        fprintf(stderr, "[Main] Starting fuzzing mode: Random\n");
-        randomFuzzing(target_exe_path, MAX_ITERATIONS, minRange, maxRange);
+        LOG_I("Main", "Starting fuzzing mode: Random");
+        randomFuzzing(target_exe_path, minRange, maxRange);
     }
     else /* Genetic mode by default */
     {
-        fprintf(stderr, "[Main] Starting fuzzing mode: Genetic\n");
-        greyBoxFuzzing(target_exe_path, MAX_ITERATIONS, minRange, maxRange);
+        LOG_I("Main", "Starting fuzzing mode: Genetic");
+        greyBoxFuzzing(target_exe_path, minRange, maxRange);
     }
+    bench_finish();
 
-    fprintf(stderr, "[Main] Fuzzing finished. Cleaning up...\n");
+    LOG_I("Main", "Fuzzing finished. Cleaning up...");
+    directed_cleanup();
     destroy_shared_memory();
     cleanup_target(target_exe_path);
     if (global_coverage_map)
         free(global_coverage_map);
-    free(fullPath);
-    free(temp_path_dir);
-    free(temp_path_base);
-    fprintf(stderr, "[Main] Cleanup complete. Exiting.\n");
+    LOG_I("Main", "Cleanup complete. Exiting.");
+    log_shutdown();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,353 @@
+// filepath: microbench.c
+// Microbenchmarks for the fuzzer's inner loops, run on synthetic data instead
+// of a real target: coverage maps with a configurable share of hit edges and a
+// corpus of configurable size. Reports ns/op (mean, p50, p99) and heap
+// allocations/op for each kernel. Allocations are counted by wrapping
+// malloc/calloc/realloc at link time (see the microbench rule in the Makefile),
+// so only calls made from the fuzzer's own objects are seen.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <dirent.h>
+
+#include "headers/coverage.h"
+#include "headers/corpus.h"
+#include "headers/fuzz.h"
+#include "headers/generational.h"
+#include "headers/perf.h"
+
+#define MB_DEFAULT_DENSITY 5     // Percent of map bytes hit in a synthetic run
+#define MB_DEFAULT_CORPUS 256    // Entries in the synthetic corpus
+#define MB_DEFAULT_OPS 1000      // Timed operations per kernel
+#define MB_MINIMIZE_REPS 5       // minimizeCorpus rebuilds the corpus each time: fewer reps
+#define MB_SEED 12345
+
+int minRange = INT_MIN;
+int maxRange = INT_MAX;
+
+// --- Allocation counting (-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc) ---
+
+static unsigned long long alloc_count = 0;
+static unsigned long long alloc_bytes = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    alloc_count++;
+    alloc_bytes += size;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    alloc_count++;
+    alloc_bytes += nmemb * size;
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    alloc_count++;
+    alloc_bytes += size;
+    return __real_realloc(ptr, size);
+}
+
+// --- Measurement ---
+
+typedef struct {
+    const char *name;
+    perf_histogram_t hist;
+    unsigned long long allocs;
+    unsigned long long bytes;
+} mb_result_t;
+
+static int density_pct = MB_DEFAULT_DENSITY;
+static int corpus_entries = MB_DEFAULT_CORPUS;
+static int ops = MB_DEFAULT_OPS;
+static const char *only_kernel = NULL;
+static char corpus_dir[PATH_MAX];
+
+// Timed region: call mb_begin/mb_end around exactly one operation
+static uint64_t op_start;
+static unsigned long long op_allocs, op_bytes;
+
+static void mb_begin(void)
+{
+    op_allocs = alloc_count;
+    op_bytes = alloc_bytes;
+    op_start = perf_now_ns();
+}
+
+static void mb_end(mb_result_t *r)
+{
+    uint64_t elapsed = perf_now_ns() - op_start;
+    perf_histogram_add(&r->hist, elapsed);
+    r->allocs += alloc_count - op_allocs;
+    r->bytes += alloc_bytes - op_bytes;
+}
+
+// Results are printed together at the end, after the kernels' own output
+#define MB_MAX_RESULTS 16
+static mb_result_t results[MB_MAX_RESULTS];
+static int result_count = 0;
+
+static void mb_report(const mb_result_t *r)
+{
+    if (r->hist.count > 0 && result_count < MB_MAX_RESULTS)
+        results[result_count++] = *r;
+}
+
+static void mb_print_result(const mb_result_t *r)
+{
+    const perf_histogram_t *h = &r->hist;
+    printf("%-24s %8llu %12.0f %12llu %12llu %10.2f %12.0f\n", r->name,
+           (unsigned long long)h->count, (double)h->total_ns / (double)h->count,
+           (unsigned long long)perf_histogram_percentile(h, 50.0),
+           (unsigned long long)perf_histogram_percentile(h, 99.0),
+           (double)r->allocs / (double)h->count, (double)r->bytes / (double)h->count);
+}
+
+static int selected(const char *name)
+{
+    return !only_kernel || strstr(name, only_kernel) != NULL;
+}
+
+// --- Synthetic data ---
+
+// Random map with density_pct percent of bytes hit (hit counts 1..255)
+static void fill_map(coverage_t *map)
+{
+    memset(map, 0, COVERAGE_MAP_SIZE);
+    for (int i = 0; i < COVERAGE_MAP_SIZE; i++)
+    {
+        if (rand() % 100 < density_pct)
+            map[i] = (coverage_t)(1 + rand() % 255);
+    }
+}
+
+// Remove the scratch corpus directory (flat: inputs and their sidecars)
+static void remove_corpus_dir(void)
+{
+    DIR *dir = opendir(corpus_dir);
+    struct dirent *ent;
+    char path[PATH_MAX * 2];
+
+    if (!dir)
+        return;
+    while ((ent = readdir(dir)) != NULL)
+    {
+        if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0)
+            continue;
+        snprintf(path, sizeof(path), "%s/%s", corpus_dir, ent->d_name);
+        unlink(path);
+    }
+    closedir(dir);
+    rmdir(corpus_dir);
+}
+
+// Fresh corpus of corpus_entries entries, each with its own random map
+static void build_corpus(coverage_t *map)
+{
+    initializeCorpus(corpus_dir);
+    for (int i = 0; i < corpus_entries; i++)
+    {
+        fill_map(map);
+        saveToCorpus(i, map, 1.0 + rand() % 10, 1);
+    }
+}
+
+// --- Kernels ---
+
+static void bench_evaluate_coverage(void)
+{
+    mb_result_t steady = {"evaluate_coverage"};
+    mb_result_t fresh = {"evaluate_coverage_new"};
+    perf_histogram_reset(&steady.hist);
+    perf_histogram_reset(&fresh.hist);
+
+    fill_map(fuzz_shared_mem.map);
+    for (int i = 0; i < ops; i++)
+    {
+        // Steady state: the global map already holds every edge of the run
+        mb_begin();
+        evaluate_coverage();
+        mb_end(&steady);
+
+        // Every edge new: global map cleared outside the timed region
+        memset(global_cov_map, 0, sizeof(global_cov_map));
+        mb_begin();
+        evaluate_coverage();
+        mb_end(&fresh);
+    }
+    memset(global_cov_map, 0, sizeof(global_cov_map));
+    mb_report(&steady);
+    mb_report(&fresh);
+}
+
+static void bench_save_to_corpus(coverage_t *map)
+{
+    mb_result_t r = {"saveToCorpus"};
+    perf_histogram_reset(&r.hist);
+
+    build_corpus(map);
+    for (int i = 0; i < ops; i++)
+    {
+        fill_map(map); // New path each time, so the entry is really added
+        mb_begin();
+        saveToCorpus(corpus_entries + i, map, 1.0, 1);
+        mb_end(&r);
+    }
+    cleanupCorpus();
+    mb_report(&r);
+}
+
+static void bench_select_corpus_entry(coverage_t *map)
+{
+    mb_result_t r = {"selectCorpusEntry"};
+    perf_histogram_reset(&r.hist);
+
+    build_corpus(map);
+    for (int i = 0; i < ops; i++)
+    {
+        mb_begin();
+        selectCorpusEntry();
+        mb_end(&r);
+    }
+    cleanupCorpus();
+    mb_report(&r);
+}
+
+static void bench_minimize_corpus(coverage_t *map)
+{
+    mb_result_t r = {"minimizeCorpus"};
+    perf_histogram_reset(&r.hist);
+
+    for (int rep = 0; rep < MB_MINIMIZE_REPS; rep++)
+    {
+        build_corpus(map);
+        mb_begin();
+        minimizeCorpus();
+        mb_end(&r);
+        cleanupCorpus();
+    }
+    mb_report(&r);
+}
+
+static void bench_mutate_havoc(void)
+{
+    mb_result_t r = {"mutateHavoc"};
+    volatile int sink = 0;
+    perf_histogram_reset(&r.hist);
+
+    for (int i = 0; i < ops; i++)
+    {
+        int value = rand();
+        mb_begin();
+        sink += mutateHavoc(value);
+        mb_end(&r);
+    }
+    (void)sink;
+    mb_report(&r);
+}
+
+static void bench_generate_new_population(void)
+{
+    mb_result_t r = {"generateNewPopulation"};
+    perf_histogram_reset(&r.hist);
+
+    initializePopulations();
+    for (int i = 0; i < POPULATION_SIZE; i++)
+    {
+        population[i].input_value = rand();
+        population[i].fitness_score = rand() % 20;
+    }
+    for (int i = 0; i < ops; i++)
+    {
+        mb_begin();
+        generateNewPopulation(population, POPULATION_SIZE, next_generation, minRange, maxRange);
+        mb_end(&r);
+    }
+    cleanupPopulations();
+    mb_report(&r);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-d DENSITY_PCT] [-c CORPUS_SIZE] [-n OPS] [-k KERNEL]\n", prog);
+    fprintf(stderr, "  -d  Percent of coverage map bytes hit per synthetic run (default %d)\n", MB_DEFAULT_DENSITY);
+    fprintf(stderr, "  -c  Synthetic corpus size (default %d)\n", MB_DEFAULT_CORPUS);
+    fprintf(stderr, "  -n  Timed operations per kernel (default %d)\n", MB_DEFAULT_OPS);
+    fprintf(stderr, "  -k  Only run kernels whose name contains KERNEL\n");
+}
+
+int main(int argc, char *argv[])
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "d:c:n:k:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'd':
+            density_pct = atoi(optarg);
+            break;
+        case 'c':
+            corpus_entries = atoi(optarg);
+            break;
+        case 'n':
+            ops = atoi(optarg);
+            break;
+        case 'k':
+            only_kernel = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (density_pct < 0 || density_pct > 100 || corpus_entries < 1 || ops < 1)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    srand(MB_SEED);
+    snprintf(corpus_dir, sizeof(corpus_dir), "/tmp/fuzz_microbench_%d", (int)getpid());
+    coverage_t *map = malloc(COVERAGE_MAP_SIZE);
+    if (!map || setup_shared_memory() != 0)
+    {
+        fprintf(stderr, "Error: Failed to set up benchmark state\n");
+        free(map);
+        return 1;
+    }
+
+    fprintf(stderr, "Microbenchmarks: map density %d%%, corpus %d entries, %d ops per kernel\n",
+            density_pct, corpus_entries, ops);
+
+    if (selected("evaluate_coverage"))
+        bench_evaluate_coverage();
+    if (selected("saveToCorpus"))
+        bench_save_to_corpus(map);
+    if (selected("selectCorpusEntry"))
+        bench_select_corpus_entry(map);
+    if (selected("minimizeCorpus"))
+        bench_minimize_corpus(map);
+    if (selected("mutateHavoc"))
+        bench_mutate_havoc();
+    if (selected("generateNewPopulation"))
+        bench_generate_new_population();
+
+    printf("\n%-24s %8s %12s %12s %12s %10s %12s\n", "kernel", "ops", "ns/op", "p50_ns", "p99_ns",
+           "allocs/op", "bytes/op");
+    for (int i = 0; i < result_count; i++)
+        mb_print_result(&results[i]);
+
+    remove_corpus_dir();
+    destroy_shared_memory();
+    free(map);
+    return 0;
+}
@@ -0,0 +1,163 @@
+// filepath: src/bench.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "../headers/bench.h"
+#include "../headers/perf.h"
+
+typedef struct {
+    uint64_t execs;
+    uint64_t elapsed_ns;
+    int edges;
+} bench_point_t;
+
+static const int milestone_pct[BENCH_MILESTONE_COUNT] = {50, 75, 90, 100};
+
+static int enabled = 0;
+static char report_path[4096];
+static char run_mode[32];
+static char run_target[256];
+static unsigned int run_seed = 0;
+static unsigned long long run_budget = 0;
+static uint64_t start_ns = 0;
+static int total_edges = 0;
+static bench_point_t* curve = NULL;
+static size_t curve_count = 0;
+static size_t curve_capacity = 0;
+
+int bench_start(const char* path, const char* mode, const char* target, unsigned int seed,
+                unsigned long long exec_budget) {
+    snprintf(report_path, sizeof(report_path), "%s", path);
+    snprintf(run_mode, sizeof(run_mode), "%s", mode);
+    snprintf(run_target, sizeof(run_target), "%s", target);
+    run_seed = seed;
+    run_budget = exec_budget;
+    start_ns = perf_now_ns();
+    total_edges = 0;
+    curve_count = 0;
+    enabled = 1;
+    return 0;
+}
+
+int bench_enabled(void) {
+    return enabled;
+}
+
+void bench_note_new_edges(int new_edges) {
+    if (!enabled || new_edges <= 0) return;
+
+    total_edges += new_edges;
+    if (curve_count == curve_capacity) {
+        size_t capacity = curve_capacity ? curve_capacity * 2 : 256;
+        bench_point_t* grown = realloc(curve, capacity * sizeof(bench_point_t));
+        if (!grown) return; // Only this curve point is lost; later points carry the full total
+        curve = grown;
+        curve_capacity = capacity;
+    }
+    curve[curve_count].execs = perf_stage_histogram(PERF_STAGE_EXEC)->count;
+    curve[curve_count].elapsed_ns = perf_now_ns() - start_ns;
+    curve[curve_count].edges = total_edges;
+    curve_count++;
+}
+
+// Edges covered after 'execs' executions
+static int edgesAt(uint64_t execs) {
+    int edges = 0;
+    for (size_t i = 0; i < curve_count && curve[i].execs <= execs; i++) {
+        edges = curve[i].edges;
+    }
+    return edges;
+}
+
+int bench_finish(void) {
+    if (!enabled) return 0;
+    enabled = 0;
+
+    FILE* f = fopen(report_path, "w");
+    if (!f) {
+        perror("[Bench] Error: Cannot write report");
+        free(curve);
+        curve = NULL;
+        curve_capacity = curve_count = 0;
+        return -1;
+    }
+
+    const perf_histogram_t* exec = perf_stage_histogram(PERF_STAGE_EXEC);
+    uint64_t execs = exec->count;
+    double elapsed = (double)(perf_now_ns() - start_ns) / 1e9;
+    struct rusage self, children;
+    getrusage(RUSAGE_SELF, &self);
+    getrusage(RUSAGE_CHILDREN, &children);
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"mode\": \"%s\",\n", run_mode);
+    fprintf(f, "  \"target\": \"%s\",\n", run_target);
+    fprintf(f, "  \"seed\": %u,\n", run_seed);
+    fprintf(f, "  \"exec_budget\": %llu,\n", run_budget);
+    fprintf(f, "  \"execs\": %llu,\n", (unsigned long long)execs);
+    fprintf(f, "  \"elapsed_s\": %.3f,\n", elapsed);
+    fprintf(f, "  \"execs_per_sec\": %.1f,\n", elapsed > 0.0 ? (double)execs / elapsed : 0.0);
+    fprintf(f, "  \"exec_p50_us\": %.1f,\n", (double)perf_histogram_percentile(exec, 50.0) / 1e3);
+    fprintf(f, "  \"exec_p99_us\": %.1f,\n", (double)perf_histogram_percentile(exec, 99.0) / 1e3);
+    fprintf(f, "  \"edges\": %d,\n", total_edges);
+    fprintf(f, "  \"peak_rss_kb\": %ld,\n", self.ru_maxrss);
+    fprintf(f, "  \"peak_child_rss_kb\": %ld,\n", children.ru_maxrss);
+
+    // Edges at 1-2-5 exec checkpoints up to the number of execs run
+    fprintf(f, "  \"edges_at_execs\": {");
+    int first = 1;
+    for (uint64_t decade = 100; decade <= execs; decade *= 10) {
+        static const int steps[] = {1, 2, 5};
+        for (int s = 0; s < 3 && decade * steps[s] <= execs; s++) {
+            uint64_t checkpoint = decade * steps[s];
+            fprintf(f, "%s\"%llu\": %d", first ? "" : ", ", (unsigned long long)checkpoint, edgesAt(checkpoint));
+            first = 0;
+        }
+    }
+    fprintf(f, "},\n");
+
+    // First point reaching each share of the final coverage
+    fprintf(f, "  \"milestones\": [");
+    for (int m = 0; m < BENCH_MILESTONE_COUNT; m++) {
+        int goal = (total_edges * milestone_pct[m] + 99) / 100;
+        size_t i = 0;
+        while (i < curve_count && curve[i].edges < goal) i++;
+        fprintf(f, "%s{\"pct\": %d, \"edges\": %d, ", m ? ", " : "", milestone_pct[m], goal);
+        if (i < curve_count) {
+            fprintf(f, "\"execs\": %llu, \"seconds\": %.3f}", (unsigned long long)curve[i].execs,
+                    (double)curve[i].elapsed_ns / 1e9);
+        } else {
+            fprintf(f, "\"execs\": null, \"seconds\": null}");
+        }
+    }
+    fprintf(f, "],\n");
+
+    fprintf(f, "  \"stages\": {");
+    for (int s = 0; s < PERF_STAGE_COUNT; s++) {
+        const perf_histogram_t* h = perf_stage_histogram(s);
+        fprintf(f, "%s\"%s\": {\"count\": %llu, \"total_ms\": %.3f, \"p50_us\": %.1f, \"p99_us\": %.1f}",
+                s ? ", " : "", perf_stage_name(s), (unsigned long long)h->count, (double)h->total_ns / 1e6,
+                (double)perf_histogram_percentile(h, 50.0) / 1e3,
+                (double)perf_histogram_percentile(h, 99.0) / 1e3);
+    }
+    fprintf(f, "},\n");
+
+    fprintf(f, "  \"curve\": [");
+    for (size_t i = 0; i < curve_count; i++) {
+        fprintf(f, "%s[%llu, %.3f, %d]", i ? ", " : "", (unsigned long long)curve[i].execs,
+                (double)curve[i].elapsed_ns / 1e9, curve[i].edges);
+    }
+    fprintf(f, "]\n}\n");
+
+    int result = fclose(f) == 0 ? 0 : -1;
+    printf("[Bench] Report written to %s (%llu execs, %d edges)\n", report_path,
+           (unsigned long long)execs, total_edges);
+
+    free(curve);
+    curve = NULL;
+    curve_capacity = curve_count = 0;
+    return result;
+}
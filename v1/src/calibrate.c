@@ -0,0 +1,77 @@
+// filepath: src/calibrate.c
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+
+#include "../headers/calibrate.h"
+#include "../headers/target.h"
+#include "../headers/logger.h"
+
+static calibration_stats_t counters;
+
+#define COUNT(field, n) __atomic_store_n(&counters.field, counters.field + (n), __ATOMIC_RELAXED)
+
+int calibrate_input(const char* exePath, int input, const coverage_t* map, unsigned int timeout_ms) {
+    static coverage_t first[COVERAGE_MAP_SIZE];
+    static uint8_t first_extra[SHM_EXTRA_RUN_SIZE];
+
+    if (!map || !fuzz_shared_mem.map) return -1;
+    // The first run's state, restored for the caller afterwards
+    if (map != first) memcpy(first, map, COVERAGE_MAP_SIZE);
+    memcpy(first_extra, fuzz_shared_mem.extra, SHM_EXTRA_RUN_SIZE);
+
+    uint64_t total_us = get_last_exec_time_us();
+    int runs = 1;
+    int flagged = 0;
+    int result = 0;
+
+    for (int r = 0; r < CALIBRATION_RUNS; r++) {
+        int status = execute_target_uncached(exePath, input, timeout_ms);
+        if (status == FUZZER_EXEC_ERROR || status == -SIGALRM) {
+            result = -1;
+            break;
+        }
+        COUNT(execs, 1);
+        total_us += get_last_exec_time_us();
+        runs++;
+
+        // Compare hit/miss per 8-byte word first: stable words are skipped
+        const coverage_t* cur = fuzz_shared_mem.map;
+        for (int word = 0; word < COVERAGE_MAP_SIZE; word += 8) {
+            uint64_t a, b;
+            memcpy(&a, first + word, sizeof(a));
+            memcpy(&b, cur + word, sizeof(b));
+            if (a == b) continue;
+            for (int i = word; i < word + 8; i++) {
+                if ((first[i] != 0) != (cur[i] != 0)) flagged += coverage_mark_variable(i);
+            }
+        }
+    }
+
+    memcpy(fuzz_shared_mem.map, first, COVERAGE_MAP_SIZE);
+    memcpy(fuzz_shared_mem.extra, first_extra, SHM_EXTRA_RUN_SIZE);
+    set_last_exec_time_us((unsigned int)(total_us / (uint64_t)runs));
+
+    COUNT(entries, 1);
+    if (flagged > 0) {
+        COUNT(unstable, 1);
+        LOG_I("Calib", "Input %d: %d variable edges (stability %.2f%%)", input, flagged, coverage_stability());
+    }
+    return result < 0 ? result : flagged;
+}
+
+calibration_stats_t calibration_stats(void) {
+    calibration_stats_t s;
+    s.entries = __atomic_load_n(&counters.entries, __ATOMIC_RELAXED);
+    s.execs = __atomic_load_n(&counters.execs, __ATOMIC_RELAXED);
+    s.unstable = __atomic_load_n(&counters.unstable, __ATOMIC_RELAXED);
+    return s;
+}
+
+void calibration_print_summary(void) {
+    calibration_stats_t s = calibration_stats();
+    if (s.entries == 0) return;
+    printf("Calibration: %llu entries (%llu runs), %llu unstable, %d variable edges, stability %.2f%%\n",
+           (unsigned long long)s.entries, (unsigned long long)s.execs, (unsigned long long)s.unstable,
+           coverage_variable_edges(), coverage_stability());
+}
@@ -0,0 +1,103 @@
+// filepath: src/campaign.c
+#include <stdio.h>
+#include <signal.h>
+
+#include "../headers/campaign.h"
+#include "../headers/perf.h"
+#include "../headers/execcache.h"
+#include "../headers/logger.h"
+
+static campaign_config_t config;
+static uint64_t start_ns = 0;
+static uint64_t last_find_ns = 0;
+static int last_edges = -1;
+static campaign_stop_t stopped = CAMPAIGN_RUNNING;
+static uint64_t stage_execs[CAMPAIGN_STAGE_COUNT];
+static volatile sig_atomic_t stop_signal = 0;
+
+static const char* const stop_reasons[] = {NULL, "exec budget", "time limit", "first crash", "coverage plateau", "signal"};
+
+void campaign_start(const campaign_config_t* cfg) {
+    config = *cfg;
+    if (!config.max_execs && !config.max_seconds && !config.plateau_seconds) {
+        config.max_execs = CAMPAIGN_DEFAULT_EXECS;
+    }
+    start_ns = perf_now_ns();
+    last_find_ns = start_ns;
+    last_edges = -1;
+    stopped = CAMPAIGN_RUNNING;
+    for (int s = 0; s < CAMPAIGN_STAGE_COUNT; s++) stage_execs[s] = 0;
+}
+
+const campaign_config_t* campaign_config(void) {
+    return &config;
+}
+
+uint64_t campaign_execs(void) {
+    exec_cache_stats_t cache = exec_cache_stats();
+    // Verified hits were executed, so they are already in the exec histogram
+    return __atomic_load_n(&perf_stage_histogram(PERF_STAGE_EXEC)->count, __ATOMIC_RELAXED) + cache.hits -
+           cache.verified;
+}
+
+campaign_stop_t campaign_check(int edges, int unique_crashes) {
+    if (stopped) return stopped;
+
+    uint64_t now = perf_now_ns();
+    if (edges > last_edges) {
+        last_edges = edges;
+        last_find_ns = now;
+    }
+
+    uint64_t execs = campaign_execs();
+    campaign_stop_t reason = CAMPAIGN_RUNNING;
+    if (stop_signal) {
+        reason = CAMPAIGN_STOP_SIGNAL;
+    } else if (config.max_execs && execs >= config.max_execs) {
+        reason = CAMPAIGN_STOP_EXECS;
+    } else if (config.max_seconds && now - start_ns >= config.max_seconds * 1000000000ULL) {
+        reason = CAMPAIGN_STOP_TIME;
+    } else if (config.stop_on_crash && unique_crashes > 0) {
+        reason = CAMPAIGN_STOP_CRASH;
+    } else if (config.plateau_seconds && now - last_find_ns >= config.plateau_seconds * 1000000000ULL) {
+        reason = CAMPAIGN_STOP_PLATEAU;
+    }
+    if (reason) {
+        if (reason == CAMPAIGN_STOP_SIGNAL) {
+            LOG_I("Campaign", "Stopping: signal %d received after %llu execs, %.1fs", (int)stop_signal,
+                  (unsigned long long)execs, (double)(now - start_ns) / 1e9);
+        } else {
+            LOG_I("Campaign", "Stopping: %s reached after %llu execs, %.1fs", stop_reasons[reason],
+                  (unsigned long long)execs, (double)(now - start_ns) / 1e9);
+        }
+        __atomic_store_n(&stopped, reason, __ATOMIC_RELAXED); // Read by the stats thread
+    }
+    return reason;
+}
+
+void campaign_request_stop(int sig) {
+    stop_signal = sig;
+}
+
+int campaign_interrupted(void) {
+    return stop_signal;
+}
+
+const char* campaign_stop_reason(void) {
+    return stop_reasons[__atomic_load_n(&stopped, __ATOMIC_RELAXED)];
+}
+
+campaign_stage_t campaign_next_stage(int corpus_size) {
+    if (corpus_size <= 0) return CAMPAIGN_STAGE_GA;
+    uint64_t total = stage_execs[CAMPAIGN_STAGE_CORPUS] + stage_execs[CAMPAIGN_STAGE_GA];
+    if (stage_execs[CAMPAIGN_STAGE_GA] * 100 <= total * CAMPAIGN_GA_EXEC_SHARE) return CAMPAIGN_STAGE_GA;
+    return CAMPAIGN_STAGE_CORPUS;
+}
+
+void campaign_account(campaign_stage_t stage, uint64_t execs_before) {
+    stage_execs[stage] += campaign_execs() - execs_before;
+}
+
+uint64_t campaign_stage_execs(campaign_stage_t stage) {
+    return stage_execs[stage];
+}
@@ -0,0 +1,142 @@
+// filepath: src/cmin.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../headers/cmin.h"
+
+// Max-heap node: upper bound on an item's gain per unit of weight
+typedef struct {
+    double score;
+    int index;
+} cmin_heap_node_t;
+
+void cmin_bitset_from_map(uint64_t* bits, const coverage_t* map) {
+    memset(bits, 0, CMIN_BITSET_BYTES);
+    if (!map) return;
+    for (int i = 0; i < COVERAGE_MAP_SIZE; i++) {
+        if (map[i]) {
+            bits[i >> 6] |= 1ULL << (i & 63);
+        }
+    }
+}
+
+int cmin_bitset_count(const uint64_t* bits) {
+    int count = 0;
+    for (int w = 0; w < CMIN_BITSET_WORDS; w++) {
+        count += __builtin_popcountll(bits[w]);
+    }
+    return count;
+}
+
+int cmin_bitset_count_and(const uint64_t* a, const uint64_t* b) {
+    int count = 0;
+    for (int w = 0; w < CMIN_BITSET_WORDS; w++) {
+        count += __builtin_popcountll(a[w] & b[w]);
+    }
+    return count;
+}
+
+// Heap order: higher score first, lower index on ties
+static int heapBefore(const cmin_heap_node_t* a, const cmin_heap_node_t* b) {
+    if (a->score != b->score) return a->score > b->score;
+    return a->index < b->index;
+}
+
+static void heapPush(cmin_heap_node_t* heap, int* size, cmin_heap_node_t node) {
+    int i = (*size)++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!heapBefore(&node, &heap[parent])) break;
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = node;
+}
+
+static cmin_heap_node_t heapPop(cmin_heap_node_t* heap, int* size) {
+    cmin_heap_node_t top = heap[0];
+    cmin_heap_node_t last = heap[--(*size)];
+    int i = 0;
+
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= *size) break;
+        if (child + 1 < *size && heapBefore(&heap[child + 1], &heap[child])) child++;
+        if (!heapBefore(&heap[child], &last)) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    if (*size > 0) heap[i] = last;
+    return top;
+}
+
+static void keepItem(const cmin_item_t* item, uint64_t* uncovered) {
+    for (int w = 0; w < CMIN_BITSET_WORDS; w++) {
+        uncovered[w] &= ~item->edges[w];
+    }
+}
+
+// Lazy greedy: an item's gain can only shrink as more edges get covered, so a
+// stale heap score is an upper bound. The top item is re-scored and taken if it
+// still beats the next best bound; otherwise it goes back with its new score.
+int cmin_greedy_cover(const cmin_item_t* items, int count, uint8_t* keep) {
+    int kept = 0;
+    int heap_size = 0;
+
+    if (count <= 0) return 0;
+    memset(keep, 0, (size_t)count);
+
+    uint64_t* uncovered = calloc(CMIN_BITSET_WORDS, sizeof(uint64_t));
+    cmin_heap_node_t* heap = malloc((size_t)count * sizeof(cmin_heap_node_t));
+    if (!uncovered || !heap) {
+        fprintf(stderr, "Error: Failed to allocate set cover state\n");
+        free(uncovered);
+        free(heap);
+        return -1;
+    }
+
+    // Universe: every edge any item covers
+    for (int i = 0; i < count; i++) {
+        if (!items[i].edges) continue;
+        for (int w = 0; w < CMIN_BITSET_WORDS; w++) {
+            uncovered[w] |= items[i].edges[w];
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (items[i].required) {
+            keep[i] = 1;
+            kept++;
+            if (items[i].edges) keepItem(&items[i], uncovered);
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (keep[i] || !items[i].edges) continue;
+        int gain = cmin_bitset_count_and(items[i].edges, uncovered);
+        if (gain == 0) continue;
+        cmin_heap_node_t node = {gain / items[i].weight, i};
+        heapPush(heap, &heap_size, node);
+    }
+
+    while (heap_size > 0) {
+        cmin_heap_node_t node = heapPop(heap, &heap_size);
+        int gain = cmin_bitset_count_and(items[node.index].edges, uncovered);
+        if (gain == 0) continue;
+
+        node.score = gain / items[node.index].weight;
+        if (heap_size > 0 && heapBefore(&heap[0], &node)) {
+            heapPush(heap, &heap_size, node); // Stale bound: re-queue with the real score
+            continue;
+        }
+
+        keep[node.index] = 1;
+        kept++;
+        keepItem(&items[node.index], uncovered);
+    }
+
+    free(uncovered);
+    free(heap);
+    return kept;
+}
@@ -14,18 +14,43 @@
 #include "../headers/uthash.h" // Assuming this is still used
 #include "../headers/coverage.h" // For COVERAGE_MAP_SIZE, coverage_t
 #include "../headers/generational.h" // For TOURNAMENT_SIZE
+#include "../headers/target.h" // For get_last_exec_time_us
+#include "../headers/store.h"
+#include "../headers/hash.h"
+#include "../headers/cmin.h"
+#include "../headers/directed.h"
+#include "../headers/perf.h"
 
 // Hash table entry for uthash
 typedef struct {
-    int input_value;           // key
+    uint64_t content_hash;     // key: hash of the input bytes
     CorpusEntry* entry;        // value
     UT_hash_handle hh;         // makes this structure hashable
 } CorpusHash;
 
+// Set of coverage path hashes held by the corpus (with reference counts)
+typedef struct {
+    uint64_t cov_hash;         // key
+    int refs;                  // Entries currently holding this path
+    UT_hash_handle hh;
+} PathHash;
+
 // Global corpus variables
 static CorpusHash* corpus_table = NULL;
+static PathHash* path_table = NULL;
 static int corpus_size = 0;
+static int duplicate_inputs = 0; // Saves rejected because the input bytes were already stored
+static int duplicate_paths = 0;  // Saves rejected because the trace map was already stored
 static char corpus_directory[1024] = {0};
+static corpus_store_t* corpus_store = NULL; // Optional append-only store (replaces per-entry files)
+
+// AFL-style top_rated: cheapest entry seen so far for each edge. Updated on
+// every add; the favored set is re-culled from it lazily before selection.
+static CorpusEntry* top_rated[COVERAGE_MAP_SIZE];
+static int top_rated_stale = 0; // An entry lost a slot: rebuild top_rated from scratch
+static int favored_dirty = 0;   // top_rated changed since the last cull
+static int favored_count = 0;
+static int rare_bias = 0; // Prefer rarely selected entries (plateau escalation)
 
 // --- GA corpus implementation ---
 static TestCase ga_corpus[CORPUS_CAPACITY];
@@ -39,11 +64,14 @@ void init_corpus(void) {
     memcpy(seed.data, "FUZZ", 4);
     seed.coverage_map = calloc(COVERAGE_MAP_SIZE, sizeof(coverage_t));
     seed.fitness = 0;
+    seed.data_hash = hash64(seed.data, seed.len, 0);
+    seed.cov_hash = 0;
     if (seed.coverage_map) {
         // Run initial coverage (map already zeroed)
         reset_coverage_map();
         // ...execute seed as needed before copying coverage...
         memcpy(seed.coverage_map, fuzz_shared_mem.map, COVERAGE_MAP_SIZE);
+        seed.cov_hash = coverage_path_hash(seed.coverage_map);
     }
     ga_corpus[ga_corpus_size++] = seed;
 }
@@ -60,11 +88,24 @@ TestCase* select_parent(void) {
 
 int add_to_corpus(const TestCase* tc) {
     if (tc->fitness <= 0) return 0;
+
+    // Skip exact duplicates (same bytes) and inputs that took an already stored path
+    uint64_t data_hash = hash64(tc->data, tc->len, 0);
+    uint64_t cov_hash = coverage_path_hash(tc->coverage_map);
+    for (int i = 0; i < ga_corpus_size; ++i) {
+        if ((ga_corpus[i].data_hash == data_hash && ga_corpus[i].len == tc->len) ||
+            (tc->coverage_map && ga_corpus[i].cov_hash == cov_hash)) {
+            return 0;
+        }
+    }
+
     if (ga_corpus_size < CORPUS_CAPACITY) {
         TestCase* slot = &ga_corpus[ga_corpus_size++];
         memcpy(slot->data, tc->data, tc->len);
         slot->len = tc->len;
         slot->fitness = tc->fitness;
+        slot->data_hash = data_hash;
+        slot->cov_hash = cov_hash;
         slot->coverage_map = calloc(COVERAGE_MAP_SIZE, sizeof(coverage_t));
         memcpy(slot->coverage_map, tc->coverage_map, COVERAGE_MAP_SIZE);
         return 1;
@@ -79,6 +120,8 @@ int add_to_corpus(const TestCase* tc) {
         memcpy(ga_corpus[worst].data, tc->data, tc->len);
         ga_corpus[worst].len = tc->len;
         ga_corpus[worst].fitness = tc->fitness;
+        ga_corpus[worst].data_hash = data_hash;
+        ga_corpus[worst].cov_hash = cov_hash;
         ga_corpus[worst].coverage_map = calloc(COVERAGE_MAP_SIZE, sizeof(coverage_t));
         memcpy(ga_corpus[worst].coverage_map, tc->coverage_map, COVERAGE_MAP_SIZE);
         return 1;
@@ -112,105 +155,576 @@ int initializeCorpus(const char* corpus_dir) {
     return 0;
 }
 
+// Is some corpus entry already holding this execution path?
+static int pathIsKnown(uint64_t cov_hash) {
+    PathHash* p;
+    HASH_FIND(hh, path_table, &cov_hash, sizeof(cov_hash), p);
+    return p != NULL;
+}
+
+// Drop an entry's reference on its path hash
+static void untrackEntryPath(CorpusEntry* entry) {
+    PathHash* p;
+    if (!entry->path_tracked) return;
+    HASH_FIND(hh, path_table, &entry->cov_hash, sizeof(entry->cov_hash), p);
+    if (p && --p->refs == 0) {
+        HASH_DEL(path_table, p);
+        free(p);
+    }
+    entry->path_tracked = 0;
+}
+
+// Set an entry's path hash and register it in the path set
+static void setEntryPathHash(CorpusEntry* entry, uint64_t cov_hash) {
+    PathHash* p;
+    untrackEntryPath(entry);
+    entry->cov_hash = cov_hash;
+
+    HASH_FIND(hh, path_table, &cov_hash, sizeof(cov_hash), p);
+    if (!p) {
+        p = (PathHash*)malloc(sizeof(PathHash));
+        if (!p) return; // Dedup is best effort
+        p->cov_hash = cov_hash;
+        p->refs = 0;
+        HASH_ADD(hh, path_table, cov_hash, sizeof(p->cov_hash), p);
+    }
+    p->refs++;
+    entry->path_tracked = 1;
+}
+
+// Length of the input as written to the target ("%d\n")
+static int inputTextLength(int input_value) {
+    unsigned int v = input_value < 0 ? 0u - (unsigned int)input_value : (unsigned int)input_value;
+    int len = input_value < 0 ? 3 : 2; // Sign, first digit, newline
+    while (v >= 10) {
+        v /= 10;
+        len++;
+    }
+    return len;
+}
+
+// Cost of keeping/scheduling an entry: exec time x input size (AFL's fav factor)
+static double entryWeight(const CorpusEntry* entry) {
+    return (double)(entry->exec_us ? entry->exec_us : 1) * inputTextLength(entry->input_value);
+}
+
+// Offer an entry as top_rated for every edge it hits
+static void offerTopRated(CorpusEntry* entry) {
+    double weight = entryWeight(entry);
+
+    for (int w = 0; w < CMIN_BITSET_WORDS; w++) {
+        uint64_t bits = entry->edge_bits[w];
+        while (bits) {
+            int i = (w << 6) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (top_rated[i] != entry && (!top_rated[i] || weight < entryWeight(top_rated[i]))) {
+                top_rated[i] = entry;
+                favored_dirty = 1;
+            }
+        }
+    }
+}
+
+// Release the top_rated slots an entry holds (its coverage changed or it is going away)
+static void dropTopRated(CorpusEntry* entry) {
+    for (int w = 0; w < CMIN_BITSET_WORDS; w++) {
+        uint64_t bits = entry->edge_bits[w];
+        while (bits) {
+            int i = (w << 6) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (top_rated[i] == entry) {
+                top_rated[i] = NULL;
+                top_rated_stale = 1;
+            }
+        }
+    }
+    if (entry->favored) {
+        entry->favored = 0;
+        favored_count--;
+        favored_dirty = 1;
+    }
+}
+
+// Repack an entry's edge bitset after its coverage map (or exec time) changed
+static void refreshEntryEdges(CorpusEntry* entry) {
+    dropTopRated(entry);
+    cmin_bitset_from_map(entry->edge_bits, entry->coverage_map);
+    offerTopRated(entry);
+}
+
+// Free an entry that has already been removed from corpus_table
+static void freeCorpusEntry(CorpusEntry* entry) {
+    if (!entry) return;
+    untrackEntryPath(entry);
+    if (entry->edge_bits) {
+        dropTopRated(entry);
+        free(entry->edge_bits);
+    }
+    free(entry->coverage_map);
+    free(entry);
+}
+
+// Serialize an entry's metadata (header + sparse edges) into a malloc'd buffer
+static uint8_t* serializeCorpusMetadata(const CorpusEntry* entry, size_t* out_len) {
+    uint32_t edge_count = 0;
+
+    if (entry->coverage_map) {
+        for (int i = 0; i < COVERAGE_MAP_SIZE; i++) {
+            if (entry->coverage_map[i] > 0) edge_count++;
+        }
+    }
+
+    size_t len = sizeof(corpus_meta_header_t) + edge_count * sizeof(corpus_meta_edge_t);
+    uint8_t* buf = malloc(len);
+    if (!buf) {
+        fprintf(stderr, "Warning: Failed to allocate metadata buffer\n");
+        return NULL;
+    }
+
+    corpus_meta_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = CORPUS_META_MAGIC;
+    header.version = CORPUS_META_VERSION;
+    header.input_value = entry->input_value;
+    header.is_interesting = entry->is_interesting;
+    header.fitness_score = entry->fitness_score;
+    header.timestamp = (int64_t)entry->timestamp;
+    header.cov_hash = entry->cov_hash;
+    header.exec_us = entry->exec_us;
+    header.times_selected = entry->times_selected;
+    header.det_done = (uint32_t)entry->det_done;
+    header.edge_count = edge_count;
+    memcpy(buf, &header, sizeof(header));
+
+    corpus_meta_edge_t* edges = (corpus_meta_edge_t*)(buf + sizeof(header));
+    uint32_t n = 0;
+    for (int i = 0; i < COVERAGE_MAP_SIZE && n < edge_count; i++) {
+        if (entry->coverage_map[i] > 0) {
+            corpus_meta_edge_t edge = { (uint16_t)i, entry->coverage_map[i], 0 };
+            memcpy(&edges[n++], &edge, sizeof(edge));
+        }
+    }
+
+    *out_len = len;
+    return buf;
+}
+
+// Restore an entry's metadata from a serialized sidecar.
+// Returns 0 if the buffer is valid and matches the entry's input value.
+static int parseCorpusMetadata(const uint8_t* buf, size_t len, CorpusEntry* entry) {
+    corpus_meta_header_t header;
+
+    if (len < sizeof(header)) return -1;
+    memcpy(&header, buf, sizeof(header));
+    if (header.magic != CORPUS_META_MAGIC ||
+        header.version != CORPUS_META_VERSION ||
+        header.input_value != entry->input_value ||
+        header.edge_count > COVERAGE_MAP_SIZE ||
+        len < sizeof(header) + header.edge_count * sizeof(corpus_meta_edge_t)) {
+        return -1;
+    }
+
+    memset(entry->coverage_map, 0, COVERAGE_MAP_SIZE * sizeof(coverage_t));
+    for (uint32_t i = 0; i < header.edge_count; i++) {
+        corpus_meta_edge_t edge;
+        memcpy(&edge, buf + sizeof(header) + i * sizeof(edge), sizeof(edge));
+        entry->coverage_map[edge.index] = edge.hits;
+    }
+
+    entry->is_interesting = header.is_interesting;
+    entry->fitness_score = header.fitness_score;
+    entry->timestamp = (time_t)header.timestamp;
+    setEntryPathHash(entry, header.cov_hash);
+    entry->exec_us = header.exec_us;
+    entry->times_selected = header.times_selected;
+    entry->det_done = (int)header.det_done;
+    refreshEntryEdges(entry);
+    return 0;
+}
+
+// Write a serialized sidecar to "<dir>/<file_name>.meta" via tmp file + rename,
+// so a crash never leaves a half-written sidecar behind. Returns 0 or -1.
+static int writeMetadataFile(const char* dir, const char* file_name, const uint8_t* buf, size_t len) {
+    char meta_path[PATH_MAX];
+    char tmp_path[PATH_MAX];
+
+    if (snprintf(meta_path, sizeof(meta_path), "%s/%s%s", dir, file_name, CORPUS_META_SUFFIX) >= (int)sizeof(meta_path) ||
+        snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", meta_path) >= (int)sizeof(tmp_path)) {
+        fprintf(stderr, "Warning: Metadata path too long for %s/%s\n", dir, file_name);
+        return -1;
+    }
+
+    FILE* fp = fopen(tmp_path, "wb");
+    if (!fp) {
+        fprintf(stderr, "Warning: Failed to write metadata file %s\n", tmp_path);
+        return -1;
+    }
+    int ok = fwrite(buf, 1, len, fp) == len;
+    ok = (fclose(fp) == 0) && ok;
+
+    if (!ok || rename(tmp_path, meta_path) != 0) {
+        fprintf(stderr, "Warning: Failed to save metadata file %s\n", meta_path);
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+// Write the metadata sidecar for an entry. With a store, a new metadata record
+// referencing the entry is appended (the latest one wins on load); otherwise the
+// sidecar file next to the input is replaced. Returns 0 on success, -1 on failure.
+static int writeCorpusMetadata(CorpusEntry* entry) {
+    size_t len;
+
+    if (entry->file_name[0] == '\0' && entry->store_index < 0) {
+        return -1; // Entry has no input file or record to attach metadata to
+    }
+
+    uint8_t* buf = serializeCorpusMetadata(entry, &len);
+    if (!buf) {
+        return -1;
+    }
+
+    if (corpus_store && entry->store_index >= 0) {
+        store_index_entry_t meta;
+        memset(&meta, 0, sizeof(meta));
+        meta.ref = (uint32_t)entry->store_index;
+        long idx = store_append(corpus_store, STORE_KIND_CORPUS_META, buf, (uint32_t)len, &meta);
+        free(buf);
+        if (idx < 0) {
+            return -1;
+        }
+        entry->meta_dirty = 0;
+        entry->counters_dirty = 0;
+        return 0;
+    }
+
+    int result = writeMetadataFile(corpus_directory, entry->file_name, buf, len);
+    free(buf);
+    if (result != 0) {
+        return -1;
+    }
+
+    entry->meta_dirty = 0;
+    entry->counters_dirty = 0;
+    return 0;
+}
+
+// Read the metadata sidecar for 'filepath' into 'entry'.
+// Returns 0 if the sidecar exists, is valid and matches the input value.
+static int readCorpusMetadata(const char* filepath, CorpusEntry* entry) {
+    char meta_path[PATH_MAX];
+    struct stat st;
+
+    snprintf(meta_path, sizeof(meta_path), "%s%s", filepath, CORPUS_META_SUFFIX);
+    FILE* fp = fopen(meta_path, "rb");
+    if (!fp) {
+        return -1; // No sidecar (older corpus or crash before it was written)
+    }
+
+    uint8_t* buf = NULL;
+    int result = -1;
+    if (fstat(fileno(fp), &st) == 0 && st.st_size > 0 && (buf = malloc((size_t)st.st_size)) != NULL &&
+        fread(buf, 1, (size_t)st.st_size, fp) == (size_t)st.st_size) {
+        result = parseCorpusMetadata(buf, (size_t)st.st_size, entry);
+    }
+    if (result != 0) {
+        fprintf(stderr, "Warning: Ignoring invalid metadata file %s\n", meta_path);
+    }
+    free(buf);
+    fclose(fp);
+    return result;
+}
+
+// Create a corpus entry and add it to the in-memory table.
+// file_name: existing input file to attach to (when loading), or NULL to
+// write a new input file into the corpus directory.
+static CorpusEntry* addCorpusEntry(int input_value, const coverage_t* coverage_map, double fitness_score,
+                                   int is_interesting, unsigned int exec_us, const char* file_name) {
+    CorpusEntry* new_corpus_entry = (CorpusEntry*)calloc(1, sizeof(CorpusEntry));
+    if (!new_corpus_entry) {
+        fprintf(stderr, "Failed to allocate memory for corpus entry\n");
+        return NULL;
+    }
+
+    new_corpus_entry->input_value = input_value;
+    new_corpus_entry->content_hash = hash_input_value(input_value);
+    new_corpus_entry->fitness_score = fitness_score;
+    new_corpus_entry->is_interesting = is_interesting;
+    new_corpus_entry->timestamp = time(NULL);
+    new_corpus_entry->det_done = 0;
+    new_corpus_entry->exec_us = exec_us;
+    new_corpus_entry->store_index = -1;
+    new_corpus_entry->distance = DIRECTED_DIST_NONE;
+
+    // Allocate and copy the coverage map for this entry
+    new_corpus_entry->coverage_map = (coverage_t*)malloc(COVERAGE_MAP_SIZE * sizeof(coverage_t));
+    if (!new_corpus_entry->coverage_map) {
+        fprintf(stderr, "Failed to allocate memory for corpus entry coverage map\n");
+        free(new_corpus_entry);
+        return NULL;
+    }
+    new_corpus_entry->edge_bits = (uint64_t*)malloc(CMIN_BITSET_BYTES);
+    if (!new_corpus_entry->edge_bits) {
+        fprintf(stderr, "Failed to allocate memory for corpus entry edge bitset\n");
+        free(new_corpus_entry->coverage_map);
+        free(new_corpus_entry);
+        return NULL;
+    }
+    memset(new_corpus_entry->edge_bits, 0, CMIN_BITSET_BYTES);
+    if (coverage_map) {
+         memcpy(new_corpus_entry->coverage_map, coverage_map, COVERAGE_MAP_SIZE * sizeof(coverage_t));
+    } else {
+         // If no coverage provided (e.g., initial random inputs?), zero it out.
+         memset(new_corpus_entry->coverage_map, 0, COVERAGE_MAP_SIZE * sizeof(coverage_t));
+    }
+    if (coverage_map) {
+        setEntryPathHash(new_corpus_entry, coverage_path_hash(new_corpus_entry->coverage_map));
+    } else {
+        new_corpus_entry->cov_hash = coverage_path_hash(new_corpus_entry->coverage_map);
+    }
+    refreshEntryEdges(new_corpus_entry);
+
+    // Create hash table entry
+    CorpusHash* hash_entry = (CorpusHash*)malloc(sizeof(CorpusHash));
+    if (!hash_entry) {
+        fprintf(stderr, "Failed to allocate memory for corpus hash entry\n");
+        freeCorpusEntry(new_corpus_entry);
+        return NULL;
+    }
+    hash_entry->content_hash = new_corpus_entry->content_hash;
+    hash_entry->entry = new_corpus_entry;
+
+    // Add to hash table
+    HASH_ADD(hh, corpus_table, content_hash, sizeof(hash_entry->content_hash), hash_entry);
+    corpus_size++;
+
+    if (file_name) {
+        snprintf(new_corpus_entry->file_name, sizeof(new_corpus_entry->file_name), "%s", file_name);
+        return new_corpus_entry;
+    }
+
+    // Save the input (same bytes as the per-file layout) to the store
+    char filename[PATH_MAX]; // Use PATH_MAX from limits.h
+    if (corpus_store) {
+        store_index_entry_t meta;
+        memset(&meta, 0, sizeof(meta));
+        meta.fitness = fitness_score;
+        meta.cov_hash = new_corpus_entry->cov_hash;
+        meta.exec_us = exec_us;
+        int n = snprintf(filename, sizeof(filename), "%d\n", input_value);
+        new_corpus_entry->store_index = store_append(corpus_store, STORE_KIND_CORPUS, filename, (uint32_t)n, &meta);
+        if (new_corpus_entry->store_index >= 0) {
+            writeCorpusMetadata(new_corpus_entry);
+        } else {
+            fprintf(stderr, "Warning: Failed to append input %d to the corpus store\n", input_value);
+        }
+        return new_corpus_entry;
+    }
+
+    // Save the input value itself to a file in the corpus directory
+    snprintf(new_corpus_entry->file_name, sizeof(new_corpus_entry->file_name),
+             "input_%d_%ld", corpus_size, (long)time(NULL));
+    snprintf(filename, sizeof(filename), "%s/%s", corpus_directory, new_corpus_entry->file_name);
+
+    FILE* fp = fopen(filename, "w");
+    if (fp) {
+        fprintf(fp, "%d\n", input_value); // Save only the input value
+        fclose(fp);
+        writeCorpusMetadata(new_corpus_entry);
+    } else {
+         fprintf(stderr, "Warning: Failed to save input file %s\n", filename);
+         new_corpus_entry->file_name[0] = '\0';
+         // Should we remove from memory if file save fails? Maybe not.
+    }
+    return new_corpus_entry;
+}
+
 // Save an input to the corpus (in memory and to file)
 // coverage_map: Pointer to the coverage map generated by this input (e.g., from shared memory)
-int saveToCorpus(int input_value, const coverage_t* coverage_map, double fitness_score, int is_interesting) {
+// Called right after the input ran, so the last execution time belongs to it.
+// Inputs are deduplicated by content hash, and a new input whose trace map
+// matches an entry already in the corpus is not stored again.
+static int saveEntry(int input_value, const coverage_t* coverage_map, double fitness_score, int is_interesting) {
     CorpusHash* hash_entry;
+    uint64_t content_hash = hash_input_value(input_value);
 
     // Check if input already exists in the in-memory corpus
-    HASH_FIND_INT(corpus_table, &input_value, hash_entry);
+    HASH_FIND(hh, corpus_table, &content_hash, sizeof(content_hash), hash_entry);
 
     if (hash_entry) {
-        // Update existing entry if this one is "better" (e.g., higher fitness)
-        // Or if it's newly marked as interesting (e.g., caused a crash)
-        if (is_interesting || fitness_score > hash_entry->entry->fitness_score) {
-            hash_entry->entry->fitness_score = fitness_score;
-            // Update coverage map if provided and different? Or just keep the best one?
-            if (coverage_map && hash_entry->entry->coverage_map) {
-                 memcpy(hash_entry->entry->coverage_map, coverage_map, COVERAGE_MAP_SIZE * sizeof(coverage_t));
-            }
-            hash_entry->entry->is_interesting = hash_entry->entry->is_interesting || is_interesting; // Keep interesting flag if set
-            hash_entry->entry->timestamp = time(NULL);
-            // Note: No need to rewrite file here unless content changes significantly.
-             // File only stores the input value itself. Metadata could go in separate file?
+        CorpusEntry* entry = hash_entry->entry;
+        int promoted = is_interesting && !entry->is_interesting;
+        int better = fitness_score > entry->fitness_score;
+
+        // A repeat only updates the entry if it newly marks it interesting or
+        // scores higher (the fitness is never lowered)
+        if (!promoted && !better) {
+            duplicate_inputs++;
+            return 0;
         }
-    } else {
-        // --- Create New Corpus Entry ---
-        CorpusEntry* new_corpus_entry = (CorpusEntry*)malloc(sizeof(CorpusEntry));
-        if (!new_corpus_entry) {
-            fprintf(stderr, "Failed to allocate memory for corpus entry\n");
-            return -1;
+        if (better) entry->fitness_score = fitness_score;
+        entry->is_interesting = entry->is_interesting || is_interesting;
+        entry->timestamp = time(NULL);
+        entry->counters_dirty = 1; // Written at shutdown unless the map changed too
+
+        if (coverage_map && entry->coverage_map &&
+            memcmp(entry->coverage_map, coverage_map, COVERAGE_MAP_SIZE * sizeof(coverage_t)) != 0) {
+            memcpy(entry->coverage_map, coverage_map, COVERAGE_MAP_SIZE * sizeof(coverage_t));
+            setEntryPathHash(entry, coverage_path_hash(entry->coverage_map));
+            refreshEntryEdges(entry);
+            entry->meta_dirty = 1;
         }
+        return 0;
+    }
+
+    if (coverage_map && pathIsKnown(coverage_path_hash(coverage_map))) {
+        duplicate_paths++;
+        return 0;
+    }
 
-        new_corpus_entry->input_value = input_value;
-        new_corpus_entry->fitness_score = fitness_score;
-        new_corpus_entry->is_interesting = is_interesting;
-        new_corpus_entry->timestamp = time(NULL);
+    CorpusEntry* entry = addCorpusEntry(input_value, coverage_map, fitness_score, is_interesting,
+                                        get_last_exec_time_us(), NULL);
+    if (!entry) return -1;
+    entry->distance = directed_last_distance();
+    directed_observe(entry->distance);
+    return 0;
+}
 
-        // Allocate and copy the coverage map for this entry
-        new_corpus_entry->coverage_map = (coverage_t*)malloc(COVERAGE_MAP_SIZE * sizeof(coverage_t));
-        if (!new_corpus_entry->coverage_map) {
-            fprintf(stderr, "Failed to allocate memory for corpus entry coverage map\n");
-            free(new_corpus_entry);
-            return -1;
+int saveToCorpus(int input_value, const coverage_t* coverage_map, double fitness_score, int is_interesting) {
+    uint64_t start = perf_now_ns();
+    int result = saveEntry(input_value, coverage_map, fitness_score, is_interesting);
+    perf_record_since(PERF_STAGE_CORPUS_SAVE, start);
+    return result;
+}
+
+// Re-measure an entry (used for entries loaded without metadata)
+void updateCorpusEntryCoverage(CorpusEntry* entry, const coverage_t* coverage_map, double fitness_score) {
+    if (!entry || !entry->coverage_map) return;
+
+    if (coverage_map) {
+        memcpy(entry->coverage_map, coverage_map, COVERAGE_MAP_SIZE * sizeof(coverage_t));
+    } else {
+        memset(entry->coverage_map, 0, COVERAGE_MAP_SIZE * sizeof(coverage_t));
+    }
+    setEntryPathHash(entry, coverage_path_hash(entry->coverage_map));
+    entry->exec_us = get_last_exec_time_us();
+    entry->distance = directed_last_distance();
+    directed_observe(entry->distance);
+    refreshEntryEdges(entry);
+    entry->fitness_score = fitness_score;
+    entry->needs_eval = 0;
+    entry->meta_dirty = 1;
+}
+
+// Rewrite sidecars for entries whose metadata changed since the last sync
+int syncCorpusMetadata(int include_counters) {
+    CorpusHash* current, *tmp;
+    int written = 0;
+
+    HASH_ITER(hh, corpus_table, current, tmp) {
+        CorpusEntry* entry = current->entry;
+        if (entry && (entry->meta_dirty || (include_counters && entry->counters_dirty)) && !entry->needs_eval) {
+            if (writeCorpusMetadata(entry) == 0) {
+                written++;
+            }
         }
-        if (coverage_map) {
-             memcpy(new_corpus_entry->coverage_map, coverage_map, COVERAGE_MAP_SIZE * sizeof(coverage_t));
-        } else {
-             // If no coverage provided (e.g., initial random inputs?), zero it out.
-             memset(new_corpus_entry->coverage_map, 0, COVERAGE_MAP_SIZE * sizeof(coverage_t));
+    }
+    return written;
+}
+
+// Call fn on every in-memory entry
+void corpusForEach(void (*fn)(CorpusEntry* entry, void* ctx), void* ctx) {
+    CorpusHash* current, *tmp;
+
+    if (!fn) return;
+    HASH_ITER(hh, corpus_table, current, tmp) {
+        if (current->entry) {
+            fn(current->entry, ctx);
         }
+    }
+}
 
+// Use an append-only store for corpus persistence instead of per-entry files
+void setCorpusStore(corpus_store_t* store) {
+    corpus_store = store;
+}
 
-        // Create hash table entry
-        hash_entry = (CorpusHash*)malloc(sizeof(CorpusHash));
-        if (!hash_entry) {
-            fprintf(stderr, "Failed to allocate memory for corpus hash entry\n");
-            free(new_corpus_entry->coverage_map);
-            free(new_corpus_entry);
-            return -1;
+// Load corpus entries (and their latest metadata records) from the store
+static int loadCorpusFromStore(void) {
+    size_t count = store_count(corpus_store);
+    int loaded_count = 0;
+    int restored_count = 0;
+
+    // Map record index -> loaded entry so metadata records can find their input
+    CorpusEntry** by_record = calloc(count ? count : 1, sizeof(CorpusEntry*));
+    if (!by_record) {
+        fprintf(stderr, "Error: Failed to allocate store load table\n");
+        return -1;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const store_index_entry_t* e = store_entry(corpus_store, i);
+        uint32_t len;
+        const uint8_t* data = store_get(corpus_store, i, &len);
+
+        if (e->kind == STORE_KIND_CORPUS) {
+            char value_buf[32];
+            size_t n = len < sizeof(value_buf) - 1 ? len : sizeof(value_buf) - 1;
+            int input_value;
+            memcpy(value_buf, data, n);
+            value_buf[n] = '\0';
+            if (sscanf(value_buf, "%d", &input_value) != 1) {
+                fprintf(stderr, "Warning: Failed to parse input value from store record %zu\n", i);
+                continue;
+            }
+
+            CorpusHash* existing;
+            uint64_t content_hash = hash_input_value(input_value);
+            HASH_FIND(hh, corpus_table, &content_hash, sizeof(content_hash), existing);
+            if (existing) continue;
+
+            CorpusEntry* loaded = addCorpusEntry(input_value, NULL, e->fitness, 0, e->exec_us, "");
+            if (!loaded) continue;
+            loaded->store_index = (long)i;
+            loaded->needs_eval = 1; // Until a metadata record says otherwise
+            by_record[i] = loaded;
+            loaded_count++;
+        } else if (e->kind == STORE_KIND_CORPUS_META && e->ref < i && by_record[e->ref]) {
+            CorpusEntry* target = by_record[e->ref];
+            if (parseCorpusMetadata(data, len, target) == 0) {
+                if (target->needs_eval) restored_count++;
+                target->needs_eval = 0;
+            }
         }
-        hash_entry->input_value = input_value;
-        hash_entry->entry = new_corpus_entry;
-
-        // Add to hash table
-        HASH_ADD_INT(corpus_table, input_value, hash_entry);
-        corpus_size++;
-
-        // Save the input value itself to a file in the corpus directory
-        char filename[PATH_MAX]; // Use PATH_MAX from limits.h
-        // Use a more robust naming scheme, e.g., based on hash or timestamp+seq
-        // For now, simple sequential or value-based name. Avoid value if too large.
-        snprintf(filename, sizeof(filename), "%s/input_%d_%ld", corpus_directory, corpus_size, (long)time(NULL));
-        // Alternative: snprintf(filename, sizeof(filename), "%s/input-%d", corpus_directory, input_value); // If input values are reasonable
-
-        FILE* fp = fopen(filename, "w");
-        if (fp) {
-            fprintf(fp, "%d\n", input_value); // Save only the input value
-            fclose(fp);
-             // TODO: Save metadata (coverage hash, fitness) separately?
-             // char meta_filename[PATH_MAX];
-             // snprintf(meta_filename, sizeof(meta_filename), "%s.meta", filename);
-             // FILE* meta_fp = fopen(meta_filename, "wb"); // Binary for coverage?
-             // if (meta_fp) { /* write fitness, write coverage map */ fclose(meta_fp); }
-        } else {
-             fprintf(stderr, "Warning: Failed to save input file %s\n", filename);
-             // Should we remove from memory if file save fails? Maybe not.
+    }
+
+    // Coverage is known for restored entries: no need to re-run them
+    for (size_t i = 0; i < count; i++) {
+        if (by_record[i] && !by_record[i]->needs_eval) {
+            merge_global_coverage(by_record[i]->coverage_map);
         }
     }
+    free(by_record);
 
-    return 0;
+    printf("Loaded %d entries from corpus store (%d restored from metadata, %d need re-evaluation).\n",
+           loaded_count, restored_count, loaded_count - restored_count);
+    return corpus_size;
 }
 
-// Load corpus from directory (basic version - loads only inputs)
-// TODO: Enhance to load coverage/fitness metadata if saved separately.
+// Load corpus from directory, restoring metadata sidecars where present
 int loadCorpus(const char* corpus_dir) {
+    if (corpus_store) {
+        return loadCorpusFromStore();
+    }
+
     DIR* dir;
     struct dirent* entry;
     char filepath[PATH_MAX];
     FILE* fp;
     int input_value;
     int loaded_count = 0;
+    int restored_count = 0;
 
     if (!corpus_dir || corpus_dir[0] == '\0') {
          if (corpus_directory[0] == '\0') {
@@ -236,54 +750,67 @@ int loadCorpus(const char* corpus_dir) {
 
     // Read each file in the directory
     while ((entry = readdir(dir)) != NULL) {
-         // Basic check: starts with "input_" or similar convention used in saveToCorpus
-        if (strncmp(entry->d_name, "input_", 6) == 0) {
-            snprintf(filepath, sizeof(filepath), "%s/%s", corpus_dir, entry->d_name);
-
-            // Check if it's a regular file before opening
-             struct stat path_stat;
-             if (stat(filepath, &path_stat) != 0 || !S_ISREG(path_stat.st_mode)) {
-                  continue; // Skip directories, special files etc.
-             }
-
-
-            fp = fopen(filepath, "r");
-            if (fp) {
-                if (fscanf(fp, "%d", &input_value) == 1) {
-                    // Found an input value. Add it to the in-memory corpus.
-                    // We don't have coverage/fitness from file yet, so use defaults.
-                    // The fuzzer should re-evaluate these inputs later if needed.
-                    coverage_t* placeholder_map = calloc(COVERAGE_MAP_SIZE, sizeof(coverage_t));
-                    if (placeholder_map) {
-                        saveToCorpus(input_value, placeholder_map, 0.0, 0); // Add with 0 fitness/coverage
-                        free(placeholder_map);
-                        loaded_count++;
-                    } else {
-                         fprintf(stderr, "Warning: Failed to alloc placeholder map for loading %s\n", filepath);
-                    }
-                } else {
-                     fprintf(stderr, "Warning: Failed to parse input value from corpus file %s\n", filepath);
-                }
-                fclose(fp);
-
-                 // TODO: Load metadata if exists (e.g., filepath + ".meta")
-                 // char meta_filepath[PATH_MAX];
-                 // snprintf(meta_filepath, sizeof(meta_filepath), "%s.meta", filepath);
-                 // Load fitness/coverage from meta_filepath and update the entry in corpus_table
-            } else {
-                 fprintf(stderr, "Warning: Failed to open corpus file %s\n", filepath);
-            }
+        // Input files follow the "input_" convention used in saveToCorpus; skip their sidecars
+        if (strncmp(entry->d_name, "input_", 6) != 0 || strstr(entry->d_name, CORPUS_META_SUFFIX)) {
+            continue;
+        }
+        snprintf(filepath, sizeof(filepath), "%s/%s", corpus_dir, entry->d_name);
+
+        // Check if it's a regular file before opening
+        struct stat path_stat;
+        if (stat(filepath, &path_stat) != 0 || !S_ISREG(path_stat.st_mode)) {
+             continue; // Skip directories, special files etc.
+        }
+
+        fp = fopen(filepath, "r");
+        if (!fp) {
+             fprintf(stderr, "Warning: Failed to open corpus file %s\n", filepath);
+             continue;
+        }
+        int parsed = fscanf(fp, "%d", &input_value);
+        fclose(fp);
+        if (parsed != 1) {
+             fprintf(stderr, "Warning: Failed to parse input value from corpus file %s\n", filepath);
+             continue;
+        }
+
+        CorpusHash* existing;
+        uint64_t content_hash = hash_input_value(input_value);
+        HASH_FIND(hh, corpus_table, &content_hash, sizeof(content_hash), existing);
+        if (existing) {
+            continue; // Duplicate input file from an earlier session
+        }
+
+        CorpusEntry* loaded = addCorpusEntry(input_value, NULL, 0.0, 0, 0, entry->d_name);
+        if (!loaded) {
+            continue;
+        }
+        loaded_count++;
+
+        if (readCorpusMetadata(filepath, loaded) == 0) {
+            // Coverage is known: no need to re-run this input
+            merge_global_coverage(loaded->coverage_map);
+            restored_count++;
+        } else {
+            // No usable metadata: the fuzzer should re-evaluate this input
+            loaded->needs_eval = 1;
         }
     }
 
     closedir(dir);
-    printf("Loaded %d entries from corpus directory.\n", loaded_count);
+    printf("Loaded %d entries from corpus directory (%d restored from metadata, %d need re-evaluation).\n",
+           loaded_count, restored_count, loaded_count - restored_count);
     return corpus_size; // Return total size after loading
 }
 
+// Entries in content-hash order, so minimization doesn't depend on insertion order
+static int compareByContentHash(const void* a, const void* b) {
+    const CorpusHash* x = *(CorpusHash* const*)a;
+    const CorpusHash* y = *(CorpusHash* const*)b;
+    return x->content_hash < y->content_hash ? -1 : x->content_hash > y->content_hash;
+}
 
-// Minimize corpus based on coverage (simple N^2 approach)
-// Assumes corpus entries have valid coverage maps loaded/evaluated.
+// Minimize corpus with a weighted greedy set cover over packed edge bitsets
 int minimizeCorpus() {
     if (corpus_size <= 1) {
         return corpus_size; // Nothing to minimize
@@ -291,94 +818,142 @@ int minimizeCorpus() {
 
     printf("Starting corpus minimization (initial size: %d)...\n", corpus_size);
 
+    int count = corpus_size;
+    CorpusHash** slots = malloc((size_t)count * sizeof(CorpusHash*));
+    cmin_item_t* items = malloc((size_t)count * sizeof(cmin_item_t));
+    uint8_t* keep = malloc((size_t)count);
+    if (!slots || !items || !keep) {
+        fprintf(stderr, "Error: Failed to allocate minimization state.\n");
+        free(slots);
+        free(items);
+        free(keep);
+        return -1;
+    }
+
     CorpusHash* current, *tmp;
-    int removed_count = 0;
-    int kept_count = 0;
+    int n = 0;
+    HASH_ITER(hh, corpus_table, current, tmp) {
+        slots[n++] = current;
+    }
+    qsort(slots, (size_t)n, sizeof(CorpusHash*), compareByContentHash);
 
-    // Build a combined coverage map of all entries we decide to *keep*.
-    coverage_t* combined_kept_coverage = calloc(COVERAGE_MAP_SIZE, sizeof(coverage_t));
-    if (!combined_kept_coverage) {
-         fprintf(stderr, "Error: Failed to allocate map for minimization.\n");
-         return -1;
+    for (int i = 0; i < n; i++) {
+        CorpusEntry* entry = slots[i]->entry;
+        items[i].edges = entry->edge_bits;
+        items[i].weight = entryWeight(entry);
+        items[i].required = entry->needs_eval; // Coverage unknown: can't prove it redundant
     }
 
-    // Use a temporary hash table to store entries to keep.
-    CorpusHash* kept_corpus_table = NULL;
+    int kept_count = cmin_greedy_cover(items, n, keep);
+    if (kept_count < 0) {
+        free(slots);
+        free(items);
+        free(keep);
+        return -1;
+    }
 
-    // Iterate through the current corpus. For each entry, check if it adds
-    // coverage not already covered by the 'kept' set.
-    // Process in some order? Maybe sort by fitness or size first? For now, hash order.
-    HASH_ITER(hh, corpus_table, current, tmp) {
-        int adds_new_coverage = 0;
+    for (int i = 0; i < n; i++) {
+        if (keep[i]) continue;
+        HASH_DEL(corpus_table, slots[i]);
+        freeCorpusEntry(slots[i]->entry);
+        free(slots[i]);
+        corpus_size--;
+    }
 
-        // Always keep entries marked as interesting (e.g., crashes)
-        if (current->entry->is_interesting) {
-            adds_new_coverage = 1;
-        } else {
-             // Check if this entry's map covers anything not in combined_kept_coverage
-             if (current->entry->coverage_map) {
-                  for (int i = 0; i < COVERAGE_MAP_SIZE; i++) {
-                       if (current->entry->coverage_map[i] > 0 && combined_kept_coverage[i] == 0) {
-                            adds_new_coverage = 1;
-                            break;
-                       }
-                  }
-             }
-        }
-
-
-        if (adds_new_coverage) {
-            // Keep this entry. Add it to the temporary 'kept' table.
-            // Add its coverage to the combined map.
-            if (current->entry->coverage_map) {
-                 for (int i = 0; i < COVERAGE_MAP_SIZE; i++) {
-                      if (current->entry->coverage_map[i] > 0) {
-                           combined_kept_coverage[i] = 1; // Mark as covered
-                      }
-                 }
-            }
+    free(slots);
+    free(items);
+    free(keep);
 
-            // Add a *copy* to the kept table (or just transfer ownership carefully)
-            // Simplest: Add pointer, will handle cleanup later.
-             CorpusHash* kept_entry_hash = (CorpusHash*)malloc(sizeof(CorpusHash)); // Need new hash handle
-             if (!kept_entry_hash) { /* error */ continue; }
-             kept_entry_hash->input_value = current->input_value;
-             kept_entry_hash->entry = current->entry; // Share the CorpusEntry pointer
-             HASH_ADD_INT(kept_corpus_table, input_value, kept_entry_hash);
-             kept_count++;
+    printf("Corpus minimized: Kept %d entries, removed %d redundant entries\n", kept_count, n - kept_count);
+    return corpus_size;
+}
 
+// Write all entries to out_dir in the per-file layout (input file + sidecar)
+int exportCorpus(const char* out_dir) {
+    struct stat st = {0};
+    char path[PATH_MAX];
+    char file_name[64];
+    int written = 0;
+    int n = 0;
+
+    if (stat(out_dir, &st) == -1 && mkdir(out_dir, 0755) == -1 && errno != EEXIST) {
+        fprintf(stderr, "Error: Failed to create %s: %s\n", out_dir, strerror(errno));
+        return -1;
+    }
+
+    CorpusHash* current, *tmp;
+    HASH_ITER(hh, corpus_table, current, tmp) {
+        CorpusEntry* entry = current->entry;
+        n++;
+        // Keep the original name when there is one (store entries have none)
+        if (entry->file_name[0] != '\0') {
+            snprintf(file_name, sizeof(file_name), "%s", entry->file_name);
         } else {
-            // This entry is redundant. Remove it from the original table and free resources.
-            HASH_DEL(corpus_table, current);
-            // Free only if not shared with kept_corpus_table!
-            // In this simple transfer, we don't free here. Cleanup happens below.
-            removed_count++;
+            snprintf(file_name, sizeof(file_name), "input_%d_%ld", n, (long)entry->timestamp);
+        }
+
+        snprintf(path, sizeof(path), "%s/%s", out_dir, file_name);
+        FILE* fp = fopen(path, "w");
+        if (!fp) {
+            fprintf(stderr, "Warning: Failed to write %s: %s\n", path, strerror(errno));
+            continue;
+        }
+        fprintf(fp, "%d\n", entry->input_value);
+        fclose(fp);
+
+        // Entries without known coverage are exported without a sidecar (re-evaluated on load)
+        if (!entry->needs_eval) {
+            size_t len;
+            uint8_t* buf = serializeCorpusMetadata(entry, &len);
+            if (buf) {
+                writeMetadataFile(out_dir, file_name, buf, len);
+                free(buf);
+            }
         }
+        written++;
     }
 
-    // Now, cleanup the *original* table. Entries pointed to by kept_corpus_table
-    // should NOT have their CorpusEntry freed yet.
-     HASH_ITER(hh, corpus_table, current, tmp) {
-          // These are the entries that were NOT kept
-           HASH_DEL(corpus_table, current);
-           if (current->entry) {
-                free(current->entry->coverage_map);
-                free(current->entry);
-           }
-           free(current); // Free the hash struct itself
-     }
+    printf("Exported %d corpus entries to %s\n", written, out_dir);
+    return written;
+}
 
+// Recompute the favored set from top_rated (AFL cull_queue): walk the edges,
+// and for each one not yet covered by a favored entry, favor its top_rated entry
+static void cullCorpus(void) {
+    CorpusHash* current, *tmp;
 
-    // Replace the global corpus table with the minimized one
-    corpus_table = kept_corpus_table;
-    corpus_size = kept_count;
+    if (top_rated_stale) {
+        // Some edges lost their entry: re-offer every entry
+        memset(top_rated, 0, sizeof(top_rated));
+        HASH_ITER(hh, corpus_table, current, tmp) {
+            offerTopRated(current->entry);
+        }
+        top_rated_stale = 0;
+        favored_dirty = 1;
+    }
+    if (!favored_dirty) {
+        return;
+    }
 
-    free(combined_kept_coverage);
+    uint64_t uncovered[CMIN_BITSET_WORDS];
+    memset(uncovered, 0xff, sizeof(uncovered));
 
-    printf("Corpus minimized: Kept %d entries, removed %d redundant entries\n", kept_count, removed_count);
-    return corpus_size;
-}
+    HASH_ITER(hh, corpus_table, current, tmp) {
+        current->entry->favored = 0;
+    }
+    favored_count = 0;
 
+    for (int i = 0; i < COVERAGE_MAP_SIZE; i++) {
+        CorpusEntry* top = top_rated[i];
+        if (!top || !(uncovered[i >> 6] & (1ULL << (i & 63)))) continue;
+        for (int w = 0; w < CMIN_BITSET_WORDS; w++) {
+            uncovered[w] &= ~top->edge_bits[w];
+        }
+        top->favored = 1;
+        favored_count++;
+    }
+    favored_dirty = 0;
+}
 
 // Select a corpus entry for mutation/fuzzing
 CorpusEntry* selectCorpusEntry() {
@@ -386,25 +961,92 @@ CorpusEntry* selectCorpusEntry() {
         return NULL;
     }
 
-    // --- Simple Strategy: Random Selection ---
-    int index = rand() % corpus_size;
-    CorpusHash* current = corpus_table; // Start at the beginning
-    int i = 0;
-    // Iterate through the hash table until the index-th element is reached
-    // Note: Hash table iteration order is not guaranteed, but consistent per run usually.
-    while (current != NULL && i < index) {
-        current = current->hh.next;
-        i++;
+    cullCorpus();
+
+    CorpusHash* current = NULL;
+    for (int attempt = 0; attempt < CORPUS_SELECT_ATTEMPTS; attempt++) {
+        // --- Random pick, skipping most non-favored entries (AFL-style) ---
+        int index = rand() % corpus_size;
+        current = corpus_table; // Start at the beginning
+        int i = 0;
+        // Iterate through the hash table until the index-th element is reached
+        while (current != NULL && i < index) {
+            current = current->hh.next;
+            i++;
+        }
+        // If current is NULL here, something is wrong (index out of bounds?)
+        if (current == NULL) {
+            return NULL;
+        }
+        if (!(current->entry->favored || favored_count == 0 ||
+              rand() % 100 >= CORPUS_SKIP_NONFAVORED_PCT)) {
+            continue;
+        }
+        // Directed mode: annealed preference for entries closer to an unreached label
+        if (!directed_enabled() || rand() / (RAND_MAX + 1.0) < directed_energy(current->entry->distance)) {
+            break;
+        }
+    }
+    if (rare_bias && corpus_size > 1) {
+        // Tournament of two: keep whichever has been picked less often
+        CorpusHash* other = corpus_table;
+        for (int i = rand() % corpus_size; other && i > 0; i--) other = other->hh.next;
+        if (other && other->entry->times_selected < current->entry->times_selected) current = other;
     }
-    // If current is NULL here, something is wrong (index out of bounds?)
-    return (current != NULL) ? current->entry : NULL;
+    current->entry->times_selected++;
+    current->entry->counters_dirty = 1;
+    return current->entry;
+}
 
+void setCorpusRareBias(int enabled) {
+    rare_bias = enabled;
+}
+
+typedef struct {
+    double rarity;
+    int input_value;
+} RareInput;
 
-    // --- TODO: Advanced Strategies ---
-    // - Weighted selection based on fitness score
-    // - Favor entries that haven't been fuzzed recently
-    // - Favor smaller entries? (if size is tracked)
-    // - Favor entries covering rarer paths?
+static int compareRarity(const void* a, const void* b) {
+    double ra = ((const RareInput*)a)->rarity, rb = ((const RareInput*)b)->rarity;
+    return (ra < rb) - (ra > rb); // Rarest first
+}
+
+int getRareCorpusInputs(int* inputs, int max) {
+    static uint32_t hits[COVERAGE_MAP_SIZE]; // Entries covering each edge
+    if (corpus_size == 0 || max <= 0) return 0;
+
+    RareInput* ranked = malloc((size_t)corpus_size * sizeof(*ranked));
+    if (!ranked) return 0;
+
+    memset(hits, 0, sizeof(hits));
+    CorpusHash* current;
+    for (current = corpus_table; current; current = current->hh.next) {
+        for (int w = 0; w < CMIN_BITSET_WORDS; w++) {
+            for (uint64_t bits = current->entry->edge_bits[w]; bits; bits &= bits - 1) {
+                hits[(w << 6) + __builtin_ctzll(bits)]++;
+            }
+        }
+    }
+
+    int n = 0;
+    for (current = corpus_table; current && n < corpus_size; current = current->hh.next) {
+        double rarity = 0.0;
+        for (int w = 0; w < CMIN_BITSET_WORDS; w++) {
+            for (uint64_t bits = current->entry->edge_bits[w]; bits; bits &= bits - 1) {
+                rarity += 1.0 / hits[(w << 6) + __builtin_ctzll(bits)];
+            }
+        }
+        ranked[n].rarity = rarity;
+        ranked[n].input_value = current->entry->input_value;
+        n++;
+    }
+    qsort(ranked, (size_t)n, sizeof(*ranked), compareRarity);
+
+    if (n > max) n = max;
+    for (int i = 0; i < n; i++) inputs[i] = ranked[i].input_value;
+    free(ranked);
+    return n;
 }
 
 // Cleanup corpus memory
@@ -413,15 +1055,16 @@ void cleanupCorpus(void) {
 
     HASH_ITER(hh, corpus_table, current, tmp) {
         HASH_DEL(corpus_table, current);
-        if (current->entry) {
-             free(current->entry->coverage_map); // Free the associated map
-             free(current->entry);              // Free the CorpusEntry struct
-        }
+        freeCorpusEntry(current->entry); // Frees the map and the CorpusEntry struct
         free(current); // Free the hash struct itself
     }
 
     corpus_table = NULL; // Ensure the global pointer is NULL
     corpus_size = 0;
+    memset(top_rated, 0, sizeof(top_rated));
+    top_rated_stale = 0;
+    favored_dirty = 0;
+    favored_count = 0;
     // corpus_directory remains set, not cleared here
 }
 
@@ -464,5 +1107,8 @@ void printCorpusStats(void) {
         }
     }
     printf("  Interesting entries: %d\n", interesting_count);
+    cullCorpus();
+    printf("  Favored entries:   %d\n", favored_count);
+    printf("  Duplicates skipped: %d inputs, %d paths\n", duplicate_inputs, duplicate_paths);
     printf("-------------------------\n");
 }
\ No newline at end of file
@@ -9,23 +9,38 @@
 #include <errno.h>
 
 #include "../headers/coverage.h"
+#include "../headers/hash.h"
+#include "../headers/perf.h"
+#include "../headers/bench.h"
 
 // Global shared memory structure
-shared_mem_t fuzz_shared_mem = { .shm_id = -1, .map = NULL };
+shared_mem_t fuzz_shared_mem = { .shm_id = -1, .map = NULL, .extra = NULL };
 volatile sig_atomic_t child_timed_out = 0;
 
 // Global coverage map accumulates all seen edges
 coverage_t global_cov_map[COVERAGE_MAP_SIZE] = {0};
+static int global_cov_edges = 0; // Edges set in global_cov_map, kept by every writer
+
+// Edges seen to come and go between runs of one input (calibration); never counted as new
+static uint8_t variable_map[COVERAGE_MAP_SIZE];
+static int variable_edges = 0;
+static int variable_uncovered = 0; // Variable edges not in global_cov_map
 
 // Alias for the shared coverage map written by the child
 #define shared_cov_map fuzz_shared_mem.map
 
+static int shm_quiet = 0;
+
+void set_shared_memory_quiet(int quiet) {
+    shm_quiet = quiet;
+}
+
 // Initialize shared memory for fuzzing
 int setup_shared_memory(void) {
     // Create shared memory segment
     // IPC_PRIVATE ensures a new segment
     // IPC_CREAT | 0600 sets permissions
-    fuzz_shared_mem.shm_id = shmget(IPC_PRIVATE, COVERAGE_MAP_SIZE, IPC_CREAT | 0600);
+    fuzz_shared_mem.shm_id = shmget(IPC_PRIVATE, SHM_TOTAL_SIZE, IPC_CREAT | 0600);
     if (fuzz_shared_mem.shm_id < 0) {
         perror("Fuzzer Error: shmget failed");
         return -1;
@@ -43,9 +58,12 @@ int setup_shared_memory(void) {
     }
 
     // Initialize map to zero
-    memset(fuzz_shared_mem.map, 0, COVERAGE_MAP_SIZE);
-    printf("Fuzzer Info: Shared memory created (ID: %d, Size: %d KB)\n",
-           fuzz_shared_mem.shm_id, COVERAGE_MAP_SIZE / 1024);
+    fuzz_shared_mem.extra = (shm_extra_t *)(fuzz_shared_mem.map + SHM_EXTRA_OFFSET);
+    memset(fuzz_shared_mem.map, 0, SHM_TOTAL_SIZE);
+    if (!shm_quiet) {
+        printf("Fuzzer Info: Shared memory created (ID: %d, Size: %d KB)\n",
+               fuzz_shared_mem.shm_id, COVERAGE_MAP_SIZE / 1024);
+    }
     return 0;
 }
 
@@ -56,6 +74,7 @@ void destroy_shared_memory(void) {
              perror("Fuzzer Warning: shmdt failed");
         }
         fuzz_shared_mem.map = NULL;
+        fuzz_shared_mem.extra = NULL;
     }
     if (fuzz_shared_mem.shm_id >= 0) {
         if (shmctl(fuzz_shared_mem.shm_id, IPC_RMID, NULL) < 0) {
@@ -63,13 +82,14 @@ void destroy_shared_memory(void) {
         }
         fuzz_shared_mem.shm_id = -1;
     }
-     printf("Fuzzer Info: Shared memory destroyed.\n");
+    if (!shm_quiet) printf("Fuzzer Info: Shared memory destroyed.\n");
 }
 
 // Reset the coverage map in shared memory (call before each run)
 void reset_coverage_map(void) {
     if (fuzz_shared_mem.map) {
         memset(fuzz_shared_mem.map, 0, COVERAGE_MAP_SIZE);
+        memset(fuzz_shared_mem.extra, 0, SHM_EXTRA_RUN_SIZE); // Keeps the directed distance table
     }
 }
 
@@ -90,17 +110,21 @@ int has_new_coverage(const coverage_t* global_map) {
 
 // Update a global map with coverage found in the shared memory map
 // Simple version: just mark presence (1) if hit count > 0
-void update_global_coverage(coverage_t* global_map) {
+int update_global_coverage(coverage_t* global_map) {
      if (!fuzz_shared_mem.map || !global_map) {
-        return; // Cannot update if maps are invalid
+        return 0; // Cannot update if maps are invalid
     }
 
+    int new_edges = 0;
     for (int i = 0; i < COVERAGE_MAP_SIZE; i++) {
         if (fuzz_shared_mem.map[i] > 0) {
+            new_edges += global_map[i] == 0;
             global_map[i] = 1; // Mark as covered in the global map
             // Could also use: global_map[i] |= fuzz_shared_mem.map[i]; for hit counts
         }
     }
+    bench_note_new_edges(new_edges);
+    return new_edges;
 }
 
 // Calculate a fitness score based on the coverage map (usually the one in shared memory)
@@ -162,29 +186,104 @@ void dump_coverage_summary(const coverage_t* map) {
            covered, COVERAGE_MAP_SIZE, density);
 }
 
+// Bucket a raw hit count into AFL-style classes (1, 2, 3, 4-7, 8-15, ...)
+// so that small loop count jitter doesn't change the path hash.
+static coverage_t classify_hit_count(coverage_t count) {
+    if (count <= 3) return count;
+    if (count <= 7) return 4;
+    if (count <= 15) return 8;
+    if (count <= 31) return 16;
+    if (count <= 127) return 32;
+    return 128;
+}
+
+// Hash the execution path of a map: XXH64 over (index, bucket) pairs of the
+// hit edges. Zero 8-byte words are skipped, so the cost follows the number of
+// hit edges rather than the map size.
+#define PATH_HASH_BATCH 64
+uint64_t coverage_path_hash(const coverage_t* map) {
+    uint32_t batch[PATH_HASH_BATCH];
+    int batched = 0;
+    hash64_state_t state;
+
+    if (!map) return 0;
+    hash64_init(&state, 0);
+
+    for (int w = 0; w < COVERAGE_MAP_SIZE; w += 8) {
+        uint64_t word;
+        memcpy(&word, map + w, sizeof(word));
+        if (!word) continue;
+
+        for (int i = w; i < w + 8; i++) {
+            if (map[i] == 0) continue;
+            batch[batched++] = ((uint32_t)i << 8) | classify_hit_count(map[i]);
+            if (batched == PATH_HASH_BATCH) {
+                hash64_update(&state, batch, sizeof(batch));
+                batched = 0;
+            }
+        }
+    }
+    hash64_update(&state, batch, batched * sizeof(batch[0]));
+    return hash64_digest(&state);
+}
+
 // Evaluate coverage: count new edges in shared_cov_map, merge into global_cov_map, return new edge count
 int evaluate_coverage(void) {
-    if (!shared_cov_map) return 0;
+    return evaluate_coverage_map(shared_cov_map);
+}
+
+// Same for a run map held elsewhere (e.g. copied back from an executor worker)
+int evaluate_coverage_map(const coverage_t* run_map) {
+    if (!run_map) return 0;
+    uint64_t start = perf_now_ns();
     // Debug: show how many edges the child hit in this run
     // int shared_hits = count_covered_edges(shared_cov_map);
     // fprintf(stderr, "[DBG] Shared run coverage edges: %d\n", shared_hits);
     int new_edges = 0;
     for (int i = 0; i < COVERAGE_MAP_SIZE; i++) {
-        if (shared_cov_map[i] > 0 && global_cov_map[i] == 0) {
+        if (run_map[i] > 0 && global_cov_map[i] == 0 && !variable_map[i]) {
             new_edges++;
             global_cov_map[i] = 1;
         }
     }
+    global_cov_edges += new_edges;
     // fprintf(stderr, "[DBG] New edges this run: %d\n", new_edges);
+    perf_record_since(PERF_STAGE_COVERAGE, start);
+    bench_note_new_edges(new_edges);
     return new_edges;
 }
 
+// Edges covered in global_cov_map (no map scan)
+int global_coverage_edges(void) {
+    return global_cov_edges;
+}
+
+int coverage_mark_variable(int index) {
+    if (index < 0 || index >= COVERAGE_MAP_SIZE || variable_map[index]) return 0;
+    variable_map[index] = 1;
+    variable_edges++;
+    if (!global_cov_map[index]) variable_uncovered++;
+    return 1;
+}
+
+int coverage_variable_edges(void) {
+    return variable_edges;
+}
+
+// Share of the edges seen so far that are stable, AFL-style
+double coverage_stability(void) {
+    int seen = global_cov_edges + variable_uncovered;
+    if (seen == 0) return 100.0;
+    return 100.0 * (1.0 - (double)variable_edges / seen);
+}
+
 // Merge a run's coverage map into the global map without counting new edges
 void merge_global_coverage(const coverage_t* run_cov) {
     if (!run_cov) return;
     for (int i = 0; i < COVERAGE_MAP_SIZE; i++) {
-        if (run_cov[i] > 0) {
+        if (run_cov[i] > 0 && global_cov_map[i] == 0 && !variable_map[i]) {
             global_cov_map[i] = 1;
+            global_cov_edges++;
         }
     }
 }
@@ -194,7 +293,10 @@ void __coverage_save(void) {
     if (fuzz_shared_mem.map) {
         // Merge current run's coverage into global map
         for (int i = 0; i < COVERAGE_MAP_SIZE; i++) {
-            if (fuzz_shared_mem.map[i] > 0) global_cov_map[i] = 1;
+            if (fuzz_shared_mem.map[i] > 0 && global_cov_map[i] == 0) {
+                global_cov_map[i] = 1;
+                global_cov_edges++;
+            }
         }
     }
 }
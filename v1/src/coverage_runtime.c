@@ -8,10 +8,20 @@
 #include <string.h>
 #include <limits.h>
 #include <errno.h>
+#include <signal.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <ucontext.h>
 
 // Define the shared memory size (must match fuzzer)
 #define COVERAGE_MAP_SIZE (1 << 16) // 64KB
 
+#include "../headers/shm_layout.h" // Area after the map (crash signature, directed table)
+
+// Targets built for directed fuzzing use -finstrument-functions; the runtime
+// itself must not call the profiling hooks
+#define RT_NO_INSTRUMENT __attribute__((no_instrument_function))
+
 // Shared memory pointer - global within this runtime
 static uint8_t *__coverage_map_ptr = NULL;
 static int __shm_id = -1;
@@ -20,12 +30,229 @@ static int __shm_id = -1;
 // Use thread-local storage for multi-threaded targets.
 static __thread uint32_t __prev_loc = 0;
 
+// Runtime-written area after the coverage map
+static shm_extra_t *__shm_extra = NULL;
+
+// Alternate stack so stack overflows still reach the crash handler
+static uint8_t __crash_altstack[1 << 16];
+
 // Pipe file descriptor for target -> fuzzer communication (e.g., ready signal)
 #define FUZZ_FD 198 // Arbitrary but potentially conflicting FD, use higher if needed
 // This FD is inherited from the fuzzer via fork
 
+// Normalise an address to "module name hash | offset from module base", so the
+// same code location gives the same value across runs despite ASLR
+RT_NO_INSTRUMENT
+static uint64_t __module_offset(uintptr_t addr) {
+    Dl_info info;
+    if (!addr || !dladdr((void *)addr, &info) || !info.dli_fbase) {
+        return (uint64_t)addr & ((1ULL << CRASH_SIG_OFFSET_BITS) - 1);
+    }
+
+    const char *name = info.dli_fname ? info.dli_fname : "";
+    const char *slash = strrchr(name, '/');
+    uint32_t h = 2166136261u; // FNV-1a over the file's base name
+    for (const char *c = slash ? slash + 1 : name; *c; c++) {
+        h = (h ^ (uint8_t)*c) * 16777619u;
+    }
+    uint64_t offset = (uint64_t)(addr - (uintptr_t)info.dli_fbase);
+    return ((uint64_t)(h & 0xffff) << CRASH_SIG_OFFSET_BITS) |
+           (offset & ((1ULL << CRASH_SIG_OFFSET_BITS) - 1));
+}
+
+// Program counter at the time of the fault
+RT_NO_INSTRUMENT
+static uintptr_t __context_pc(void *ucontext) {
+    ucontext_t *uc = (ucontext_t *)ucontext;
+    if (!uc) return 0;
+#if defined(__x86_64__)
+    return (uintptr_t)uc->uc_mcontext.gregs[REG_RIP];
+#elif defined(__i386__)
+    return (uintptr_t)uc->uc_mcontext.gregs[REG_EIP];
+#elif defined(__aarch64__)
+    return (uintptr_t)uc->uc_mcontext.pc;
+#else
+    return 0;
+#endif
+}
+
+// Fill the crash signature from trace[start..n) (signature written last)
+RT_NO_INSTRUMENT
+static void __record_crash_signature(int sig, uint64_t fault_addr, uintptr_t pc,
+                                     void **trace, int n, int start) {
+    crash_signature_t *cs = &__shm_extra->crash;
+
+    cs->magic = 0;
+    cs->signal = sig;
+    cs->fault_addr = fault_addr;
+    cs->pc = __module_offset(pc);
+    cs->frame_count = 0;
+    for (int i = start; i < n && cs->frame_count < CRASH_SIG_FRAMES; i++) {
+        cs->frames[cs->frame_count++] = __module_offset((uintptr_t)trace[i]);
+    }
+    __sync_synchronize();
+    cs->magic = CRASH_SIG_MAGIC;
+}
+
+// Fatal signal handler: record a crash signature for the fuzzer, then die with
+// the same signal (SA_RESETHAND restored the default action; the re-raised
+// signal is delivered once we return).
+RT_NO_INSTRUMENT
+static void __crash_handler(int sig, siginfo_t *info, void *ucontext) {
+    void *trace[CRASH_SIG_FRAMES + 8];
+    uintptr_t pc = __context_pc(ucontext);
+
+    int n = backtrace(trace, CRASH_SIG_FRAMES + 8);
+    // Skip this handler and the signal trampoline: start at the faulting PC if
+    // the unwinder reports it, else after the first two frames
+    int start = n > 2 ? 2 : n;
+    for (int i = 0; i < n; i++) {
+        if ((uintptr_t)trace[i] == pc) {
+            start = i + 1;
+            break;
+        }
+    }
+
+    __record_crash_signature(sig, info ? (uint64_t)(uintptr_t)info->si_addr : 0, pc, trace, n, start);
+    raise(sig);
+}
+
+// Label of the innermost "reach_error_<N>" function among the frames
+// (symbol names need the target linked with -rdynamic). Frames hold return
+// addresses: look up addr - 1, since a call to a noreturn function can be the
+// last instruction of its caller (the return address is then the next symbol).
+RT_NO_INSTRUMENT
+static int __error_label(void **trace, int n) {
+    for (int i = 0; i < n; i++) {
+        Dl_info info;
+        if (!dladdr((char *)trace[i] - 1, &info) || !info.dli_sname) continue;
+        if (strncmp(info.dli_sname, "reach_error_", 12) != 0) continue;
+
+        const char *digits = info.dli_sname + 12;
+        char *end;
+        long label = strtol(digits, &end, 10);
+        if (end != digits && *end == '\0' && label >= 0 && label <= INT32_MAX) {
+            return (int)label; // reach_error_a/_b are helpers: keep walking
+        }
+    }
+    return ERROR_LABEL_UNKNOWN;
+}
+
+// Interposes glibc's __assert_fail (reach_error() calls it). Under the fuzzer,
+// record which reach_error_N was hit plus a crash signature, then _exit at once
+// instead of going through abort() and the core dump machinery.
+__attribute__((noreturn)) RT_NO_INSTRUMENT
+void __assert_fail(const char *assertion, const char *file, unsigned int line, const char *function) {
+    if (!__shm_extra) {
+        fprintf(stderr, "%s: %s:%u: %s: Assertion `%s' failed.\n",
+                program_invocation_short_name, file, line, function ? function : "?", assertion);
+        abort();
+    }
+
+    void *trace[CRASH_SIG_FRAMES + 32];
+    int n = backtrace(trace, CRASH_SIG_FRAMES + 32);
+    uintptr_t caller = (uintptr_t)__builtin_return_address(0);
+
+    error_label_t *el = &__shm_extra->error;
+    el->magic = 0;
+    el->label = __error_label(trace, n);
+    el->line = (int32_t)line;
+    __sync_synchronize();
+    el->magic = ERROR_LABEL_MAGIC;
+
+    // Frame 0 is __assert_fail itself; the caller is the "faulting PC"
+    __record_crash_signature(SIGABRT, 0, caller, trace, n, n > 1 ? 2 : n);
+    _exit(ERROR_LABEL_EXIT_CODE);
+}
+
+RT_NO_INSTRUMENT
+static void __install_crash_handlers(void) {
+    static const int fatal_signals[] = {SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT, SIGTRAP};
+    void *warmup[1];
+    stack_t ss;
+    struct sigaction sa;
+
+    backtrace(warmup, 1); // First call may load libgcc/malloc: do it outside the handler
+
+    ss.ss_sp = __crash_altstack;
+    ss.ss_size = sizeof(__crash_altstack);
+    ss.ss_flags = 0;
+    sigaltstack(&ss, NULL);
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = __crash_handler;
+    sa.sa_flags = SA_SIGINFO | SA_RESETHAND | SA_ONSTACK;
+    sigemptyset(&sa.sa_mask);
+    for (size_t i = 0; i < sizeof(fatal_signals) / sizeof(fatal_signals[0]); i++) {
+        sigaction(fatal_signals[i], &sa, NULL);
+    }
+}
+
+// --- Directed fuzzing: distance of the functions a run enters ---
+
+// Small direct-mapped cache: function address -> distance (one lookup per function)
+#define DIRECTED_CACHE_SIZE 1024
+static struct {
+    void *fn;
+    uint32_t distance;
+} __directed_cache[DIRECTED_CACHE_SIZE];
+
+// Distance of the function at 'fn' from the fuzzer's table (symbol names need
+// the target linked with -rdynamic; functions without a symbol get none)
+RT_NO_INSTRUMENT
+static uint32_t __directed_lookup(void *fn) {
+    const directed_table_t *table = &__shm_extra->table;
+    Dl_info info;
+
+    if (!dladdr(fn, &info) || !info.dli_sname || info.dli_saddr != fn) {
+        return DIRECTED_DIST_NONE;
+    }
+    uint64_t h = shm_name_hash(info.dli_sname);
+    uint32_t lo = 0, hi = table->func_count < DIRECTED_MAX_FUNCS ? table->func_count : DIRECTED_MAX_FUNCS;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (table->funcs[mid].name_hash < h) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo < table->func_count && table->funcs[lo].name_hash == h) {
+        return table->funcs[lo].distance;
+    }
+    return DIRECTED_DIST_NONE;
+}
+
+RT_NO_INSTRUMENT
+void __cyg_profile_func_enter(void *fn, void *call_site) {
+    (void)call_site;
+    if (!__shm_extra || __shm_extra->table.func_count == 0) return;
+
+    uint32_t slot = (uint32_t)(((uintptr_t)fn >> 4) % DIRECTED_CACHE_SIZE);
+    uint32_t distance;
+    if (__directed_cache[slot].fn == fn) {
+        distance = __directed_cache[slot].distance;
+    } else {
+        distance = __directed_lookup(fn);
+        __directed_cache[slot].fn = fn;
+        __directed_cache[slot].distance = distance;
+    }
+    if (distance == DIRECTED_DIST_NONE) return;
+
+    directed_run_t *run = &__shm_extra->directed;
+    if (run->entered == 0 || distance < run->min_distance) {
+        run->min_distance = distance;
+    }
+    run->distance_sum += distance;
+    run->entered++;
+}
+
+RT_NO_INSTRUMENT
+void __cyg_profile_func_exit(void *fn, void *call_site) {
+    (void)fn;
+    (void)call_site;
+}
+
 // Called once at program startup.
 // 'start' and 'stop' delimit the guard locations.
+RT_NO_INSTRUMENT
 void __sanitizer_cov_trace_pc_guard_init(uint32_t *start, uint32_t *stop) {
     // Don't instrument the instrumentation itself
     if (start == stop || *start) return;
@@ -55,6 +282,9 @@ void __sanitizer_cov_trace_pc_guard_init(uint32_t *start, uint32_t *stop) {
         return; // Cannot proceed without shared memory
     }
 
+    __shm_extra = (shm_extra_t *)(__coverage_map_ptr + SHM_EXTRA_OFFSET);
+    __install_crash_handlers();
+
     // 3. Instrument all guard points to call __sanitizer_cov_trace_pc_guard
     // The guards initially point to this function (__sanitizer_cov_trace_pc_guard).
     // We transform them into indices.
@@ -73,6 +303,7 @@ void __sanitizer_cov_trace_pc_guard_init(uint32_t *start, uint32_t *stop) {
 
 // Called on every edge execution (if trace-pc-guard is used).
 // 'guard' now holds the unique index we assigned in the init function.
+RT_NO_INSTRUMENT
 void __sanitizer_cov_trace_pc_guard(uint32_t *guard) {
     // If shared memory setup failed, do nothing.
     if (!__coverage_map_ptr) return;
@@ -98,6 +329,7 @@ void __sanitizer_cov_trace_pc_guard(uint32_t *guard) {
 
 // Called on every comparison if trace-cmp instrumentation is enabled.
 // Records (Arg1 ^ Arg2) into the coverage map.
+RT_NO_INSTRUMENT
 void __sanitizer_cov_trace_cmp(uint64_t Arg1, uint64_t Arg2) {
     if (!__coverage_map_ptr) return;
     uint32_t idx = (uint32_t)((Arg1 ^ Arg2) % COVERAGE_MAP_SIZE);
@@ -113,6 +345,7 @@ void __sanitizer_cov_trace_cmp(uint64_t Arg1, uint64_t Arg2) {
 static int fuzz_input_value = 0;
 static int fuzz_input_read = 0;
 
+RT_NO_INSTRUMENT
 int __VERIFIER_nondet_int() {
     if (!fuzz_input_read) {
         // Read the integer input provided by the fuzzer (e.g., from stdin)
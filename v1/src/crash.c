@@ -0,0 +1,163 @@
+// filepath: src/crash.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../headers/crash.h"
+#include "../headers/hash.h"
+#include "../headers/tmin.h" // For tmin_is_simpler
+#include "../headers/uthash.h"
+
+// One bucket per unique crash signature
+typedef struct {
+    uint64_t sig_hash;          // key
+    int signal;
+    uint64_t pc;                // Faulting PC (module offset), 0 if unknown
+    int hits;                   // Crashing runs in this bucket
+    int reproducer;             // Simplest input seen for this bucket
+    UT_hash_handle hh;
+} crash_bucket_t;
+
+// Per-label accounting for reach_error_N hits
+typedef struct {
+    int label;                  // key
+    int hits;
+    int first_input;            // First input that reached the label
+    UT_hash_handle hh;
+} error_label_entry_t;
+
+static crash_bucket_t* crash_buckets = NULL;
+static error_label_entry_t* error_labels = NULL;
+static int error_label_count = 0;
+static int unique_crashes = 0;
+static int total_crashes = 0;
+
+static int signatureIsValid(const crash_signature_t* sig, int signal) {
+    return sig && sig->magic == CRASH_SIG_MAGIC && sig->signal == signal &&
+           sig->frame_count <= CRASH_SIG_FRAMES;
+}
+
+uint64_t crash_signature_hash(const crash_signature_t* sig, int signal) {
+    // Hashed: signal, faulting PC, frames. The fault address is left out since
+    // it usually depends on the input (e.g. an out-of-bounds index).
+    uint64_t key[2 + CRASH_SIG_FRAMES];
+    size_t n = 0;
+
+    key[n++] = (uint64_t)(uint32_t)signal;
+    if (signatureIsValid(sig, signal)) {
+        key[n++] = sig->pc;
+        for (uint32_t i = 0; i < sig->frame_count; i++) {
+            key[n++] = sig->frames[i];
+        }
+    }
+    return hash64(key, n * sizeof(uint64_t), 0);
+}
+
+crash_record_result_t crash_record(const crash_signature_t* sig, int signal, int input, int* previous) {
+    crash_bucket_t* bucket;
+    uint64_t sig_hash = crash_signature_hash(sig, signal);
+
+    total_crashes++;
+    HASH_FIND(hh, crash_buckets, &sig_hash, sizeof(sig_hash), bucket);
+    if (bucket) {
+        bucket->hits++;
+        if (tmin_is_simpler(input, bucket->reproducer)) {
+            if (previous) *previous = bucket->reproducer;
+            bucket->reproducer = input;
+            return CRASH_SIMPLER_REPRODUCER;
+        }
+        return CRASH_DUPLICATE;
+    }
+
+    bucket = (crash_bucket_t*)calloc(1, sizeof(crash_bucket_t));
+    if (!bucket) {
+        fprintf(stderr, "Warning: Failed to allocate crash bucket\n");
+        return CRASH_NEW_BUCKET; // Still report it so the input gets saved
+    }
+    bucket->sig_hash = sig_hash;
+    bucket->signal = signal;
+    bucket->pc = signatureIsValid(sig, signal) ? sig->pc : 0;
+    bucket->hits = 1;
+    bucket->reproducer = input;
+    HASH_ADD(hh, crash_buckets, sig_hash, sizeof(bucket->sig_hash), bucket);
+    unique_crashes++;
+    return CRASH_NEW_BUCKET;
+}
+
+int crash_record_error_label(int label, int input) {
+    error_label_entry_t* entry;
+
+    HASH_FIND_INT(error_labels, &label, entry);
+    if (entry) {
+        entry->hits++;
+        return 0;
+    }
+    entry = (error_label_entry_t*)malloc(sizeof(error_label_entry_t));
+    if (!entry) {
+        fprintf(stderr, "Warning: Failed to allocate error label entry\n");
+        return 0;
+    }
+    entry->label = label;
+    entry->hits = 1;
+    entry->first_input = input;
+    HASH_ADD_INT(error_labels, label, entry);
+    error_label_count++;
+    return 1;
+}
+
+int crash_error_label_count(void) {
+    return error_label_count;
+}
+
+static int compareLabels(error_label_entry_t* a, error_label_entry_t* b) {
+    return (a->label > b->label) - (a->label < b->label);
+}
+
+int crash_bucket_count(void) {
+    return unique_crashes;
+}
+
+int crash_total_count(void) {
+    return total_crashes;
+}
+
+void crash_print_summary(void) {
+    crash_bucket_t* bucket, *tmp;
+
+    printf("--- Unique Crashes: %d (from %d crashing runs) ---\n", unique_crashes, total_crashes);
+    HASH_ITER(hh, crash_buckets, bucket, tmp) {
+        printf("  %016llx  signal %2d  pc %012llx  hits %6d  reproducer %d\n",
+               (unsigned long long)bucket->sig_hash, bucket->signal,
+               (unsigned long long)(bucket->pc & ((1ULL << CRASH_SIG_OFFSET_BITS) - 1)),
+               bucket->hits, bucket->reproducer);
+    }
+
+    if (error_label_count == 0) return;
+    HASH_SORT(error_labels, compareLabels);
+    printf("--- Error Labels Reached: %d ---\n", error_label_count);
+    error_label_entry_t* entry, *next;
+    HASH_ITER(hh, error_labels, entry, next) {
+        if (entry->label == ERROR_LABEL_UNKNOWN) {
+            printf("  (other assertion)  hits %6d  first input %d\n", entry->hits, entry->first_input);
+        } else {
+            printf("  reach_error_%-6d  hits %6d  first input %d\n", entry->label, entry->hits, entry->first_input);
+        }
+    }
+}
+
+void crash_cleanup(void) {
+    crash_bucket_t* bucket, *tmp;
+
+    HASH_ITER(hh, crash_buckets, bucket, tmp) {
+        HASH_DEL(crash_buckets, bucket);
+        free(bucket);
+    }
+    error_label_entry_t* entry, *next;
+    HASH_ITER(hh, error_labels, entry, next) {
+        HASH_DEL(error_labels, entry);
+        free(entry);
+    }
+    error_label_count = 0;
+    unique_crashes = 0;
+    total_crashes = 0;
+}
@@ -0,0 +1,358 @@
+// filepath: src/deterministic.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "../headers/deterministic.h"
+
+// "Interesting" values that tend to trigger edge cases (same set as AFL)
+static const int8_t interesting_8[] = {
+    -128, -1, 0, 1, 16, 32, 64, 100, 127
+};
+static const int16_t interesting_16[] = {
+    -32768, -129, 128, 255, 256, 512, 1000, 1024, 4096, 32767
+};
+static const int32_t interesting_32[] = {
+    INT32_MIN, -100663046, -32769, 32768, 65535, 65536, 100663045, INT32_MAX
+};
+
+#define ARRAY_LEN(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+// Pending batch of candidates waiting to be handed to the executor
+typedef struct {
+    uint8_t *bufs;                      // DET_BATCH_SIZE candidates, len bytes each
+    size_t len;
+    int count;
+    int pos[DET_BATCH_SIZE];            // Byte position each candidate modified
+    uint64_t hashes[DET_BATCH_SIZE];    // Path hashes reported by the executor
+    det_exec_batch_fn exec_batch;
+    void *ctx;
+    uint64_t base_hash;
+    uint8_t *eff_map;                   // Set when the current pass builds the effector map
+    det_stats_t *stats;
+    int aborted;                        // Callback asked to stop: drop everything else
+} det_batch_t;
+
+static uint16_t swap16(uint16_t v) {
+    return (uint16_t)((v << 8) | (v >> 8));
+}
+
+static uint32_t swap32(uint32_t v) {
+    return (v << 24) | ((v << 8) & 0x00FF0000) | ((v >> 8) & 0x0000FF00) | (v >> 24);
+}
+
+// Run everything queued so far and, if requested, record which bytes mattered
+static void flush_batch(det_batch_t *batch) {
+    if (batch->count == 0 || batch->aborted) {
+        batch->count = 0;
+        return;
+    }
+
+    for (int i = 0; i < batch->count; i++) {
+        batch->hashes[i] = batch->base_hash;
+    }
+    batch->aborted = batch->exec_batch(batch->bufs, batch->len, batch->count, batch->hashes, batch->ctx) != 0;
+    batch->stats->execs += batch->count;
+
+    if (batch->eff_map) {
+        for (int i = 0; i < batch->count; i++) {
+            if (batch->hashes[i] != batch->base_hash) {
+                batch->eff_map[batch->pos[i]] = 1;
+            }
+        }
+    }
+    batch->count = 0;
+}
+
+// Queue one candidate (copy of 'buf'); flushes automatically when the batch is full
+static void queue_candidate(det_batch_t *batch, const uint8_t *buf, int pos) {
+    if (batch->aborted) return;
+    memcpy(batch->bufs + (size_t)batch->count * batch->len, buf, batch->len);
+    batch->pos[batch->count] = pos;
+    batch->count++;
+    if (batch->count == DET_BATCH_SIZE) {
+        flush_batch(batch);
+    }
+}
+
+// Could 'xor_val' (old ^ new) have been produced by one of the flip passes?
+static int could_be_bitflip(uint32_t xor_val) {
+    int sh = 0;
+    if (!xor_val) return 1;
+
+    // Shift left until first bit set
+    while (!(xor_val & 1)) {
+        sh++;
+        xor_val >>= 1;
+    }
+
+    // 1-, 2-, and 4-bit patterns are OK anywhere
+    if (xor_val == 1 || xor_val == 3 || xor_val == 15) return 1;
+
+    // 8-, 16-, and 32-bit patterns are OK only if shift factor is divisible by 8
+    if (sh & 7) return 0;
+    if (xor_val == 0xff || xor_val == 0xffff || xor_val == 0xffffffff) return 1;
+
+    return 0;
+}
+
+// Could 'new_val' have been produced from 'old_val' by the arithmetic pass?
+static int could_be_arith(uint32_t old_val, uint32_t new_val, int blen) {
+    uint32_t ov = 0, nv = 0;
+    int diffs = 0;
+
+    if (old_val == new_val) return 1;
+
+    // One-byte adjustments to any byte
+    for (int i = 0; i < blen; i++) {
+        uint8_t a = (uint8_t)(old_val >> (8 * i));
+        uint8_t b = (uint8_t)(new_val >> (8 * i));
+        if (a != b) { diffs++; ov = a; nv = b; }
+    }
+    if (diffs == 1) {
+        if ((uint8_t)(ov - nv) <= DET_ARITH_MAX || (uint8_t)(nv - ov) <= DET_ARITH_MAX) return 1;
+    }
+    if (blen == 1) return 0;
+
+    // Two-byte adjustments (both endians)
+    diffs = 0;
+    for (int i = 0; i < blen / 2; i++) {
+        uint16_t a = (uint16_t)(old_val >> (16 * i));
+        uint16_t b = (uint16_t)(new_val >> (16 * i));
+        if (a != b) { diffs++; ov = a; nv = b; }
+    }
+    if (diffs == 1) {
+        if ((uint16_t)(ov - nv) <= DET_ARITH_MAX || (uint16_t)(nv - ov) <= DET_ARITH_MAX) return 1;
+        ov = swap16((uint16_t)ov);
+        nv = swap16((uint16_t)nv);
+        if ((uint16_t)(ov - nv) <= DET_ARITH_MAX || (uint16_t)(nv - ov) <= DET_ARITH_MAX) return 1;
+    }
+
+    // Four-byte adjustments (both endians)
+    if (blen == 4) {
+        if (old_val - new_val <= DET_ARITH_MAX || new_val - old_val <= DET_ARITH_MAX) return 1;
+        new_val = swap32(new_val);
+        old_val = swap32(old_val);
+        if (old_val - new_val <= DET_ARITH_MAX || new_val - old_val <= DET_ARITH_MAX) return 1;
+    }
+
+    return 0;
+}
+
+// Walking bit flips: 1, 2 and 4 consecutive bits at every bit offset
+static void stage_bitflips(det_batch_t *batch, uint8_t *work) {
+    size_t bits = batch->len * 8;
+    static const int widths[] = { 1, 2, 4 };
+
+    for (int w = 0; w < ARRAY_LEN(widths); w++) {
+        for (size_t bit = 0; bit + widths[w] <= bits; bit++) {
+            for (int b = 0; b < widths[w]; b++) {
+                work[(bit + b) >> 3] ^= (uint8_t)(128 >> ((bit + b) & 7));
+            }
+            queue_candidate(batch, work, (int)(bit >> 3));
+            for (int b = 0; b < widths[w]; b++) {
+                work[(bit + b) >> 3] ^= (uint8_t)(128 >> ((bit + b) & 7));
+            }
+        }
+    }
+}
+
+// Byte flips (8/16/32 bits). The 8-bit pass builds the effector map.
+static void stage_byteflips(det_batch_t *batch, uint8_t *work, uint8_t *eff_map) {
+    size_t len = batch->len;
+
+    batch->eff_map = eff_map;
+    for (size_t i = 0; i < len; i++) {
+        work[i] ^= 0xFF;
+        queue_candidate(batch, work, (int)i);
+        work[i] ^= 0xFF;
+    }
+    flush_batch(batch);
+    batch->eff_map = NULL;
+
+    for (size_t i = 0; i + 1 < len; i++) {
+        if (!eff_map[i] && !eff_map[i + 1]) continue;
+        work[i] ^= 0xFF; work[i + 1] ^= 0xFF;
+        queue_candidate(batch, work, (int)i);
+        work[i] ^= 0xFF; work[i + 1] ^= 0xFF;
+    }
+
+    for (size_t i = 0; i + 3 < len; i++) {
+        if (!eff_map[i] && !eff_map[i + 1] && !eff_map[i + 2] && !eff_map[i + 3]) continue;
+        for (int b = 0; b < 4; b++) work[i + b] ^= 0xFF;
+        queue_candidate(batch, work, (int)i);
+        for (int b = 0; b < 4; b++) work[i + b] ^= 0xFF;
+    }
+}
+
+// Add/subtract 1..DET_ARITH_MAX to 8, 16 and 32 bit words, both endians
+static void stage_arith(det_batch_t *batch, uint8_t *work, const uint8_t *eff_map) {
+    size_t len = batch->len;
+
+    for (size_t i = 0; i < len; i++) {
+        if (!eff_map[i]) continue;
+        uint8_t orig = work[i];
+        for (int j = 1; j <= DET_ARITH_MAX; j++) {
+            uint8_t r1 = orig ^ (uint8_t)(orig + j);
+            uint8_t r2 = orig ^ (uint8_t)(orig - j);
+            if (!could_be_bitflip(r1)) {
+                work[i] = (uint8_t)(orig + j);
+                queue_candidate(batch, work, (int)i);
+            }
+            if (!could_be_bitflip(r2)) {
+                work[i] = (uint8_t)(orig - j);
+                queue_candidate(batch, work, (int)i);
+            }
+            work[i] = orig;
+        }
+    }
+
+    for (size_t i = 0; i + 1 < len; i++) {
+        if (!eff_map[i] && !eff_map[i + 1]) continue;
+        uint16_t orig, val;
+        memcpy(&orig, work + i, sizeof(orig));
+        for (int j = 1; j <= DET_ARITH_MAX; j++) {
+            uint16_t le_plus = (uint16_t)(orig + j), le_minus = (uint16_t)(orig - j);
+            uint16_t be_plus = swap16((uint16_t)(swap16(orig) + j));
+            uint16_t be_minus = swap16((uint16_t)(swap16(orig) - j));
+            // Only bother when the operation carries over into the second byte,
+            // otherwise the 8-bit pass already produced it
+            if ((orig & 0xFF) + j > 0xFF && !could_be_bitflip(orig ^ le_plus)) {
+                val = le_plus; memcpy(work + i, &val, sizeof(val)); queue_candidate(batch, work, (int)i);
+            }
+            if ((orig & 0xFF) < j && !could_be_bitflip(orig ^ le_minus)) {
+                val = le_minus; memcpy(work + i, &val, sizeof(val)); queue_candidate(batch, work, (int)i);
+            }
+            if ((orig >> 8) + j > 0xFF && !could_be_bitflip(orig ^ be_plus)) {
+                val = be_plus; memcpy(work + i, &val, sizeof(val)); queue_candidate(batch, work, (int)i);
+            }
+            if ((orig >> 8) < j && !could_be_bitflip(orig ^ be_minus)) {
+                val = be_minus; memcpy(work + i, &val, sizeof(val)); queue_candidate(batch, work, (int)i);
+            }
+            memcpy(work + i, &orig, sizeof(orig));
+        }
+    }
+
+    for (size_t i = 0; i + 3 < len; i++) {
+        if (!eff_map[i] && !eff_map[i + 1] && !eff_map[i + 2] && !eff_map[i + 3]) continue;
+        uint32_t orig, val;
+        memcpy(&orig, work + i, sizeof(orig));
+        for (int j = 1; j <= DET_ARITH_MAX; j++) {
+            uint32_t le_plus = orig + j, le_minus = orig - j;
+            uint32_t be_plus = swap32(swap32(orig) + j);
+            uint32_t be_minus = swap32(swap32(orig) - j);
+            if ((orig & 0xFFFF) + j > 0xFFFF && !could_be_bitflip(orig ^ le_plus)) {
+                val = le_plus; memcpy(work + i, &val, sizeof(val)); queue_candidate(batch, work, (int)i);
+            }
+            if ((orig & 0xFFFF) < (uint32_t)j && !could_be_bitflip(orig ^ le_minus)) {
+                val = le_minus; memcpy(work + i, &val, sizeof(val)); queue_candidate(batch, work, (int)i);
+            }
+            if ((swap32(orig) & 0xFFFF) + j > 0xFFFF && !could_be_bitflip(orig ^ be_plus)) {
+                val = be_plus; memcpy(work + i, &val, sizeof(val)); queue_candidate(batch, work, (int)i);
+            }
+            if ((swap32(orig) & 0xFFFF) < (uint32_t)j && !could_be_bitflip(orig ^ be_minus)) {
+                val = be_minus; memcpy(work + i, &val, sizeof(val)); queue_candidate(batch, work, (int)i);
+            }
+            memcpy(work + i, &orig, sizeof(orig));
+        }
+    }
+}
+
+// Overwrite 8, 16 and 32 bit words with interesting values, both endians
+static void stage_interesting(det_batch_t *batch, uint8_t *work, const uint8_t *eff_map) {
+    size_t len = batch->len;
+
+    for (size_t i = 0; i < len; i++) {
+        if (!eff_map[i]) continue;
+        uint8_t orig = work[i];
+        for (int j = 0; j < ARRAY_LEN(interesting_8); j++) {
+            uint8_t val = (uint8_t)interesting_8[j];
+            if (could_be_bitflip(orig ^ val) || could_be_arith(orig, val, 1)) continue;
+            work[i] = val;
+            queue_candidate(batch, work, (int)i);
+        }
+        work[i] = orig;
+    }
+
+    for (size_t i = 0; i + 1 < len; i++) {
+        if (!eff_map[i] && !eff_map[i + 1]) continue;
+        uint16_t orig;
+        memcpy(&orig, work + i, sizeof(orig));
+        for (int j = 0; j < ARRAY_LEN(interesting_16); j++) {
+            uint16_t candidates[2] = { (uint16_t)interesting_16[j], swap16((uint16_t)interesting_16[j]) };
+            for (int e = 0; e < 2; e++) {
+                uint16_t val = candidates[e];
+                if (e == 1 && val == candidates[0]) continue;
+                if (could_be_bitflip(orig ^ val) || could_be_arith(orig, val, 2)) continue;
+                memcpy(work + i, &val, sizeof(val));
+                queue_candidate(batch, work, (int)i);
+            }
+        }
+        memcpy(work + i, &orig, sizeof(orig));
+    }
+
+    for (size_t i = 0; i + 3 < len; i++) {
+        if (!eff_map[i] && !eff_map[i + 1] && !eff_map[i + 2] && !eff_map[i + 3]) continue;
+        uint32_t orig;
+        memcpy(&orig, work + i, sizeof(orig));
+        for (int j = 0; j < ARRAY_LEN(interesting_32); j++) {
+            uint32_t candidates[2] = { (uint32_t)interesting_32[j], swap32((uint32_t)interesting_32[j]) };
+            for (int e = 0; e < 2; e++) {
+                uint32_t val = candidates[e];
+                if (e == 1 && val == candidates[0]) continue;
+                if (could_be_bitflip(orig ^ val) || could_be_arith(orig, val, 4)) continue;
+                memcpy(work + i, &val, sizeof(val));
+                queue_candidate(batch, work, (int)i);
+            }
+        }
+        memcpy(work + i, &orig, sizeof(orig));
+    }
+}
+
+// Run the full deterministic stage over one input
+int det_stage_run(const uint8_t *buf, size_t len, uint64_t base_hash,
+                  det_exec_batch_fn exec_batch, void *ctx, det_stats_t *stats) {
+    if (!buf || len == 0 || !exec_batch || !stats) {
+        return -1;
+    }
+    memset(stats, 0, sizeof(*stats));
+
+    det_batch_t batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.len = len;
+    batch.exec_batch = exec_batch;
+    batch.ctx = ctx;
+    batch.base_hash = base_hash;
+    batch.stats = stats;
+    batch.bufs = malloc(DET_BATCH_SIZE * len);
+
+    uint8_t *work = malloc(len);
+    uint8_t *eff_map = calloc(len, 1);
+    if (!batch.bufs || !work || !eff_map) {
+        fprintf(stderr, "[Det] Error: Failed to allocate deterministic stage buffers\n");
+        free(batch.bufs);
+        free(work);
+        free(eff_map);
+        return -1;
+    }
+    memcpy(work, buf, len);
+
+    stage_bitflips(&batch, work);
+    stage_byteflips(&batch, work, eff_map);
+
+    for (size_t i = 0; i < len; i++) {
+        if (eff_map[i]) stats->effective_bytes++;
+        else stats->skipped_bytes++;
+    }
+
+    stage_arith(&batch, work, eff_map);
+    stage_interesting(&batch, work, eff_map);
+    flush_batch(&batch);
+    stats->aborted = batch.aborted;
+
+    free(batch.bufs);
+    free(work);
+    free(eff_map);
+    return 0;
+}
@@ -0,0 +1,529 @@
+// filepath: src/directed.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+
+#include "../headers/directed.h"
+#include "../headers/uthash.h"
+
+// One function defined in the target source
+typedef struct {
+    char* name;
+    int label;          // N for reach_error_N, else -1
+    int reached;        // Label already reached (no longer a target)
+    uint32_t distance;  // Current distance (DIRECTED_DIST_NONE if no target reachable)
+} directed_func_info_t;
+
+typedef struct {
+    char* name;         // key
+    int index;
+    UT_hash_handle hh;
+} FuncName;
+
+// Call edge recorded during the scan; the callee is resolved once every
+// definition is known (calls to undefined names are dropped)
+typedef struct {
+    int caller;
+    char* callee;
+} RawCall;
+
+static directed_func_info_t* funcs = NULL;
+static int func_count = 0;
+static FuncName* func_names = NULL;
+
+// Reverse call graph in CSR form: callers of f are caller_list[caller_start[f] .. caller_start[f+1])
+static int* caller_start = NULL;
+static int* caller_list = NULL;
+
+static directed_table_t table;
+static int enabled = 0;
+static int label_count = 0;
+static int target_count = 0;
+static struct timespec start_time;
+
+// Distances of the corpus seeds, for normalisation
+static uint32_t seen_min = DIRECTED_DIST_NONE;
+static uint32_t seen_max = 0;
+
+// Label number of a reach_error_<digits> name, or -1
+static int labelOf(const char* name) {
+    size_t prefix = strlen(DIRECTED_LABEL_PREFIX);
+    if (strncmp(name, DIRECTED_LABEL_PREFIX, prefix) != 0) return -1;
+    const char* digits = name + prefix;
+    if (!*digits) return -1;
+    for (const char* c = digits; *c; c++) {
+        if (!isdigit((unsigned char)*c)) return -1;
+    }
+    return atoi(digits);
+}
+
+static int findFunc(const char* name) {
+    FuncName* fn;
+    HASH_FIND_STR(func_names, name, fn);
+    return fn ? fn->index : -1;
+}
+
+static int addFunc(const char* name) {
+    int index = findFunc(name);
+    if (index >= 0) return index; // Redefinition (e.g. under #if): keep the first
+
+    directed_func_info_t* grown = realloc(funcs, (size_t)(func_count + 1) * sizeof(*funcs));
+    FuncName* fn = malloc(sizeof(FuncName));
+    if (!grown || !fn) {
+        free(fn);
+        if (grown) funcs = grown;
+        return -1;
+    }
+    funcs = grown;
+    funcs[func_count].name = strdup(name);
+    funcs[func_count].label = labelOf(name);
+    funcs[func_count].reached = 0;
+    funcs[func_count].distance = DIRECTED_DIST_NONE;
+    if (!funcs[func_count].name) {
+        free(fn);
+        return -1;
+    }
+    fn->name = funcs[func_count].name;
+    fn->index = func_count;
+    HASH_ADD_KEYPTR(hh, func_names, fn->name, strlen(fn->name), fn);
+    return func_count++;
+}
+
+// --- Source scanner ---
+
+typedef enum { TOK_END, TOK_IDENT, TOK_PUNCT, TOK_OTHER } tok_kind_t;
+
+typedef struct {
+    const char* src;
+    size_t pos;
+    size_t len;
+    int line_start;     // Only whitespace since the last newline
+} scanner_t;
+
+// Next token: identifiers and single punctuation characters; comments,
+// literals and preprocessor lines are skipped
+static tok_kind_t nextToken(scanner_t* s, char* ident, size_t ident_size, char* punct) {
+    while (s->pos < s->len) {
+        char c = s->src[s->pos];
+
+        if (c == '\n') {
+            s->line_start = 1;
+            s->pos++;
+        } else if (isspace((unsigned char)c)) {
+            s->pos++;
+        } else if (c == '#' && s->line_start) {
+            while (s->pos < s->len && s->src[s->pos] != '\n') {
+                if (s->src[s->pos] == '\\' && s->pos + 1 < s->len) s->pos++; // Continuation
+                s->pos++;
+            }
+        } else if (c == '/' && s->pos + 1 < s->len && s->src[s->pos + 1] == '/') {
+            while (s->pos < s->len && s->src[s->pos] != '\n') s->pos++;
+        } else if (c == '/' && s->pos + 1 < s->len && s->src[s->pos + 1] == '*') {
+            s->pos += 2;
+            while (s->pos + 1 < s->len && !(s->src[s->pos] == '*' && s->src[s->pos + 1] == '/')) s->pos++;
+            s->pos += 2;
+        } else {
+            break;
+        }
+    }
+    if (s->pos >= s->len) return TOK_END;
+
+    char c = s->src[s->pos];
+    s->line_start = 0;
+
+    if (c == '"' || c == '\'') {
+        s->pos++;
+        while (s->pos < s->len && s->src[s->pos] != c) {
+            if (s->src[s->pos] == '\\') s->pos++;
+            s->pos++;
+        }
+        s->pos++;
+        return TOK_OTHER;
+    }
+    if (isalpha((unsigned char)c) || c == '_') {
+        size_t n = 0;
+        while (s->pos < s->len && (isalnum((unsigned char)s->src[s->pos]) || s->src[s->pos] == '_')) {
+            if (n + 1 < ident_size) ident[n++] = s->src[s->pos];
+            s->pos++;
+        }
+        ident[n] = '\0';
+        return TOK_IDENT;
+    }
+    if (isdigit((unsigned char)c)) {
+        while (s->pos < s->len && (isalnum((unsigned char)s->src[s->pos]) || s->src[s->pos] == '.')) s->pos++;
+        return TOK_OTHER;
+    }
+    *punct = c;
+    s->pos++;
+    return TOK_PUNCT;
+}
+
+static int isAttributeKeyword(const char* ident) {
+    return strcmp(ident, "__attribute__") == 0 || strcmp(ident, "__asm__") == 0 ||
+           strcmp(ident, "asm") == 0 || strcmp(ident, "__declspec") == 0;
+}
+
+// Scan definitions ("name(...) {" at file scope) and calls ("name(" inside a body)
+static int scanSource(const char* src, size_t len, RawCall** calls, int* call_count) {
+    scanner_t s = {src, 0, len, 1};
+    char ident[256], last_ident[256] = "", candidate[256] = "";
+    int depth = 0, paren = 0, have_signature = 0, current = -1, call_capacity = 0;
+    char punct;
+    tok_kind_t kind;
+
+    while ((kind = nextToken(&s, ident, sizeof(ident), &punct)) != TOK_END) {
+        if (kind == TOK_IDENT) {
+            snprintf(last_ident, sizeof(last_ident), "%s", isAttributeKeyword(ident) ? "" : ident);
+            continue;
+        }
+        if (kind != TOK_PUNCT) {
+            last_ident[0] = '\0';
+            continue;
+        }
+
+        if (depth == 0) {
+            if (punct == '(') {
+                if (paren == 0 && last_ident[0]) {
+                    snprintf(candidate, sizeof(candidate), "%s", last_ident);
+                    have_signature = 0;
+                }
+                paren++;
+            } else if (punct == ')') {
+                if (paren > 0 && --paren == 0 && candidate[0]) have_signature = 1;
+            } else if (punct == '{') {
+                depth = 1;
+                current = (have_signature && paren == 0) ? addFunc(candidate) : -1;
+                candidate[0] = '\0';
+                have_signature = 0;
+            } else if (paren == 0 && (punct == ';' || punct == ',' || punct == '=')) {
+                candidate[0] = '\0';
+                have_signature = 0;
+            }
+        } else if (punct == '{') {
+            depth++;
+        } else if (punct == '}') {
+            if (--depth == 0) current = -1;
+        } else if (punct == '(' && last_ident[0] && current >= 0) {
+            if (*call_count == call_capacity) {
+                int capacity = call_capacity ? call_capacity * 2 : 256;
+                RawCall* grown = realloc(*calls, (size_t)capacity * sizeof(RawCall));
+                if (!grown) return -1;
+                *calls = grown;
+                call_capacity = capacity;
+            }
+            (*calls)[*call_count].caller = current;
+            (*calls)[*call_count].callee = strdup(last_ident);
+            if (!(*calls)[*call_count].callee) return -1;
+            (*call_count)++;
+        }
+        last_ident[0] = '\0';
+    }
+    return 0;
+}
+
+// Build the reverse call graph from the raw calls (self-calls and duplicates kept;
+// BFS ignores them)
+static int buildCallers(const RawCall* calls, int call_count) {
+    int* callee_of = malloc((size_t)(call_count ? call_count : 1) * sizeof(int));
+    caller_start = calloc((size_t)func_count + 1, sizeof(int));
+    if (!callee_of || !caller_start) {
+        free(callee_of);
+        return -1;
+    }
+
+    int edges = 0;
+    for (int i = 0; i < call_count; i++) {
+        callee_of[i] = findFunc(calls[i].callee);
+        if (callee_of[i] >= 0) {
+            caller_start[callee_of[i] + 1]++;
+            edges++;
+        }
+    }
+    for (int f = 0; f < func_count; f++) {
+        caller_start[f + 1] += caller_start[f];
+    }
+
+    caller_list = malloc((size_t)(edges ? edges : 1) * sizeof(int));
+    int* fill = malloc((size_t)(func_count ? func_count : 1) * sizeof(int));
+    if (!caller_list || !fill) {
+        free(callee_of);
+        free(fill);
+        return -1;
+    }
+    memcpy(fill, caller_start, (size_t)func_count * sizeof(int));
+    for (int i = 0; i < call_count; i++) {
+        if (callee_of[i] >= 0) {
+            caller_list[fill[callee_of[i]]++] = calls[i].caller;
+        }
+    }
+
+    free(callee_of);
+    free(fill);
+    return 0;
+}
+
+static int compareByDistance(const void* a, const void* b) {
+    const directed_func_t* x = a;
+    const directed_func_t* y = b;
+    if (x->distance != y->distance) return x->distance < y->distance ? -1 : 1;
+    return x->name_hash < y->name_hash ? -1 : x->name_hash > y->name_hash;
+}
+
+static int compareByNameHash(const void* a, const void* b) {
+    const directed_func_t* x = a;
+    const directed_func_t* y = b;
+    return x->name_hash < y->name_hash ? -1 : x->name_hash > y->name_hash;
+}
+
+// Harmonic-mean distance of every function to the unreached labels (one BFS
+// over the callers per label), then the shared memory table
+static int computeDistances(void) {
+    double* inverse_sum = calloc((size_t)func_count + 1, sizeof(double));
+    int* hops = malloc((size_t)(func_count ? func_count : 1) * sizeof(int));
+    int* queue = malloc((size_t)(func_count ? func_count : 1) * sizeof(int));
+    if (!inverse_sum || !hops || !queue) {
+        fprintf(stderr, "[Directed] Error: Failed to allocate distance state\n");
+        free(inverse_sum);
+        free(hops);
+        free(queue);
+        return -1;
+    }
+
+    target_count = 0;
+    for (int t = 0; t < func_count; t++) {
+        if (funcs[t].label < 0 || funcs[t].reached) continue;
+        target_count++;
+
+        for (int f = 0; f < func_count; f++) hops[f] = -1;
+        int head = 0, tail = 0;
+        hops[t] = 0;
+        queue[tail++] = t;
+        while (head < tail) {
+            int f = queue[head++];
+            inverse_sum[f] += 1.0 / (1.0 + hops[f]);
+            for (int e = caller_start[f]; e < caller_start[f + 1]; e++) {
+                int caller = caller_list[e];
+                if (hops[caller] < 0) {
+                    hops[caller] = hops[f] + 1;
+                    queue[tail++] = caller;
+                }
+            }
+        }
+    }
+
+    // Table: closest functions first if there are more than fit, then by name hash
+    directed_func_t* entries = malloc((size_t)(func_count ? func_count : 1) * sizeof(directed_func_t));
+    int count = 0;
+    if (!entries) {
+        fprintf(stderr, "[Directed] Error: Failed to allocate distance table\n");
+        free(inverse_sum);
+        free(hops);
+        free(queue);
+        return -1;
+    }
+    for (int f = 0; f < func_count; f++) {
+        if (inverse_sum[f] <= 0.0) {
+            funcs[f].distance = DIRECTED_DIST_NONE;
+            continue;
+        }
+        funcs[f].distance = (uint32_t)lround(DIRECTED_DIST_SCALE / inverse_sum[f]);
+        entries[count].name_hash = shm_name_hash(funcs[f].name);
+        entries[count].distance = funcs[f].distance;
+        entries[count].reserved = 0;
+        count++;
+    }
+    if (count > DIRECTED_MAX_FUNCS) {
+        qsort(entries, (size_t)count, sizeof(directed_func_t), compareByDistance);
+        count = DIRECTED_MAX_FUNCS;
+    }
+    qsort(entries, (size_t)count, sizeof(directed_func_t), compareByNameHash);
+
+    memset(&table, 0, sizeof(table));
+    memcpy(table.funcs, entries, (size_t)count * sizeof(directed_func_t));
+    table.func_count = (uint32_t)count;
+
+    free(entries);
+    free(inverse_sum);
+    free(hops);
+    free(queue);
+    return 0;
+}
+
+int directed_init(const char* source_path) {
+    RawCall* calls = NULL;
+    int call_count = 0;
+    int result = -1;
+
+    directed_cleanup();
+
+    FILE* f = fopen(source_path, "rb");
+    if (!f) {
+        perror("[Directed] Error: Cannot open target source");
+        return -1;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* src = size > 0 ? malloc((size_t)size) : NULL;
+    if (!src || fread(src, 1, (size_t)size, f) != (size_t)size) {
+        fprintf(stderr, "[Directed] Error: Failed to read %s\n", source_path);
+        fclose(f);
+        free(src);
+        return -1;
+    }
+    fclose(f);
+
+    if (scanSource(src, (size_t)size, &calls, &call_count) != 0 || buildCallers(calls, call_count) != 0) {
+        fprintf(stderr, "[Directed] Error: Failed to build the call graph\n");
+        goto out;
+    }
+
+    label_count = 0;
+    for (int i = 0; i < func_count; i++) {
+        if (funcs[i].label >= 0) label_count++;
+    }
+    if (computeDistances() != 0) goto out;
+
+    printf("[Directed] Call graph: %d functions, %d calls, %d error labels, %d functions can reach one\n",
+           func_count, call_count, label_count, table.func_count);
+    if (target_count == 0) {
+        fprintf(stderr, "[Directed] Warning: No %s<N> functions in %s, directed mode off\n",
+                DIRECTED_LABEL_PREFIX, source_path);
+        result = 0;
+        goto out;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    seen_min = DIRECTED_DIST_NONE;
+    seen_max = 0;
+    enabled = 1;
+    result = target_count;
+
+out:
+    for (int i = 0; i < call_count; i++) free(calls[i].callee);
+    free(calls);
+    free(src);
+    return result;
+}
+
+int directed_enabled(void) {
+    return enabled;
+}
+
+void directed_sync_table(shm_extra_t* extra) {
+    if (!extra) return;
+    if (!enabled) {
+        extra->table.func_count = 0;
+        return;
+    }
+    memcpy(&extra->table, &table, offsetof(directed_table_t, funcs) +
+           table.func_count * sizeof(directed_func_t));
+}
+
+int directed_mark_reached(int label) {
+    if (!enabled || label < 0) return 0;
+
+    int changed = 0;
+    for (int i = 0; i < func_count; i++) {
+        if (funcs[i].label == label && !funcs[i].reached) {
+            funcs[i].reached = 1;
+            changed = 1;
+        }
+    }
+    if (!changed) return 0;
+
+    computeDistances();
+    if (target_count == 0) {
+        printf("[Directed] Every error label reached\n");
+        table.func_count = 0;
+    }
+    directed_sync_table(fuzz_shared_mem.extra);
+    return 1;
+}
+
+uint32_t directed_last_distance(void) {
+    const shm_extra_t* extra = fuzz_shared_mem.extra;
+    if (!enabled || !extra || extra->directed.entered == 0) return DIRECTED_DIST_NONE;
+    return extra->directed.min_distance;
+}
+
+int directed_observe(uint32_t distance) {
+    if (!enabled || distance == DIRECTED_DIST_NONE) return 0;
+    int closer = distance < seen_min;
+    if (distance < seen_min) seen_min = distance;
+    if (distance > seen_max) seen_max = distance;
+    return closer;
+}
+
+// Annealing temperature: 1 at the start, 0.05 after DIRECTED_TIME_TO_EXPLOIT
+static double temperature(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double elapsed = (double)(now.tv_sec - start_time.tv_sec) +
+                     (double)(now.tv_nsec - start_time.tv_nsec) / 1e9;
+    return pow(20.0, -elapsed / DIRECTED_TIME_TO_EXPLOIT);
+}
+
+// Distance normalised to [0, 1] over the seeds seen (unknown = farthest)
+static double normalizedDistance(uint32_t distance) {
+    if (distance == DIRECTED_DIST_NONE || seen_min == DIRECTED_DIST_NONE) return 1.0;
+    if (seen_max <= seen_min) return 0.0;
+    if (distance <= seen_min) return 0.0;
+    if (distance >= seen_max) return 1.0;
+    return (double)(distance - seen_min) / (double)(seen_max - seen_min);
+}
+
+double directed_energy(uint32_t distance) {
+    if (!enabled) return 1.0;
+    double t = temperature();
+    return (1.0 - normalizedDistance(distance)) * (1.0 - t) + 0.5 * t;
+}
+
+double directed_fitness_bonus(uint32_t distance) {
+    if (!enabled || distance == DIRECTED_DIST_NONE) return 0.0;
+    return DIRECTED_FITNESS_WEIGHT * directed_energy(distance);
+}
+
+uint32_t directed_best_distance(void) {
+    return seen_min;
+}
+
+int directed_target_count(void) {
+    return target_count;
+}
+
+int directed_label_count(void) {
+    return label_count;
+}
+
+void directed_print_summary(void) {
+    if (!enabled) return;
+    printf("Directed: %d/%d error labels reached", label_count - target_count, label_count);
+    if (seen_min != DIRECTED_DIST_NONE) {
+        printf(", closest seed distance %.2f", (double)seen_min / DIRECTED_DIST_SCALE);
+    }
+    printf("\n");
+}
+
+void directed_cleanup(void) {
+    FuncName* fn, *tmp;
+    HASH_ITER(hh, func_names, fn, tmp) {
+        HASH_DEL(func_names, fn);
+        free(fn);
+    }
+    for (int i = 0; i < func_count; i++) free(funcs[i].name);
+    free(funcs);
+    free(caller_start);
+    free(caller_list);
+    funcs = NULL;
+    func_count = 0;
+    caller_start = NULL;
+    caller_list = NULL;
+    table.func_count = 0;
+    enabled = 0;
+    label_count = 0;
+    target_count = 0;
+}
@@ -0,0 +1,192 @@
+// filepath: src/execcache.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+
+#include "../headers/execcache.h"
+#include "../headers/target.h"
+#include "../headers/logger.h"
+#include "../headers/uthash.h"
+
+typedef struct {
+    int input;                 // key
+    int status;
+    unsigned int exec_us;
+    int used;
+    int referenced;            // Hit since the clock hand last passed
+    uint32_t edge_count;
+    uint32_t edge_capacity;
+    uint32_t* edges;           // (map index << 8) | hit count, ascending index
+    uint8_t extra[SHM_EXTRA_RUN_SIZE];
+    UT_hash_handle hh;
+} cache_entry_t;
+
+static int enabled = 1;
+static int nondeterministic = 0; // Disabled by a failed verification
+static cache_entry_t* slots = NULL; // EXEC_CACHE_SLOTS entries, allocated on first insert
+static cache_entry_t* index_by_input = NULL;
+static int clock_hand = 0;
+static exec_cache_stats_t counters;
+
+#define COUNT(field) __atomic_store_n(&counters.field, counters.field + 1, __ATOMIC_RELAXED)
+
+// Sparse edge list of a map: zero 8-byte words are skipped with one compare
+static uint32_t collectEdges(const coverage_t* map, uint32_t* out) {
+    uint32_t n = 0;
+    for (int word = 0; word < COVERAGE_MAP_SIZE; word += 8) {
+        uint64_t bits;
+        memcpy(&bits, map + word, sizeof(bits));
+        if (!bits) continue;
+        for (int i = word; i < word + 8; i++) {
+            if (map[i]) out[n++] = ((uint32_t)i << 8) | map[i];
+        }
+    }
+    return n;
+}
+
+static void freeEntries(void) {
+    HASH_CLEAR(hh, index_by_input);
+    if (slots) {
+        for (int i = 0; i < EXEC_CACHE_SLOTS; i++) free(slots[i].edges);
+        free(slots);
+    }
+    slots = NULL;
+    clock_hand = 0;
+}
+
+void exec_cache_set_enabled(int on) {
+    if (!on) freeEntries();
+    enabled = on;
+}
+
+int exec_cache_enabled(void) {
+    return enabled;
+}
+
+int exec_cache_lookup(int input, coverage_t* map, void* extra, int* status, unsigned int* exec_us) {
+    if (!enabled) return 0;
+    COUNT(lookups);
+
+    cache_entry_t* entry;
+    HASH_FIND_INT(index_by_input, &input, entry);
+    if (!entry) return 0;
+
+    COUNT(hits);
+    entry->referenced = 1;
+    if (map) {
+        memset(map, 0, COVERAGE_MAP_SIZE);
+        for (uint32_t i = 0; i < entry->edge_count; i++) {
+            map[entry->edges[i] >> 8] = (coverage_t)(entry->edges[i] & 0xFF);
+        }
+    }
+    if (extra) memcpy(extra, entry->extra, sizeof(entry->extra));
+    *status = entry->status;
+    *exec_us = entry->exec_us;
+    return 1;
+}
+
+int exec_cache_should_verify(void) {
+    return enabled && counters.hits % EXEC_CACHE_VERIFY_INTERVAL == 0;
+}
+
+void exec_cache_verify(int input, const coverage_t* map, int status) {
+    static uint32_t edges[COVERAGE_MAP_SIZE];
+    cache_entry_t* entry;
+
+    if (!enabled || !map) return;
+    if (status == FUZZER_EXEC_ERROR || status == -SIGALRM) return; // Inconclusive: host trouble
+    HASH_FIND_INT(index_by_input, &input, entry);
+    if (!entry) return;
+    COUNT(verified);
+
+    uint32_t n = collectEdges(map, edges);
+    if (status == entry->status && n == entry->edge_count &&
+        memcmp(edges, entry->edges, n * sizeof(uint32_t)) == 0) {
+        return;
+    }
+    LOG_W("Cache", "Input %d ran differently than when cached (status %d vs %d, %u vs %u edges): "
+                   "target is nondeterministic, execution cache disabled",
+          input, status, entry->status, n, entry->edge_count);
+    nondeterministic = 1;
+    exec_cache_set_enabled(0);
+}
+
+// Next slot to fill: a free one, else the first the clock hand finds unreferenced
+static cache_entry_t* claimSlot(void) {
+    for (;;) {
+        cache_entry_t* slot = &slots[clock_hand];
+        clock_hand = (clock_hand + 1) % EXEC_CACHE_SLOTS;
+        if (!slot->used) return slot;
+        if (slot->referenced) {
+            slot->referenced = 0; // Second chance
+            continue;
+        }
+        HASH_DEL(index_by_input, slot);
+        slot->used = 0;
+        COUNT(evictions);
+        return slot;
+    }
+}
+
+void exec_cache_insert(int input, const coverage_t* map, const void* extra, int status, unsigned int exec_us) {
+    static uint32_t edges[COVERAGE_MAP_SIZE];
+    cache_entry_t* entry;
+
+    if (!enabled || !map) return;
+    if (status == FUZZER_EXEC_ERROR || status == -SIGALRM) return; // Depend on the host, not the input
+
+    HASH_FIND_INT(index_by_input, &input, entry);
+    if (entry) return;
+    if (!slots) {
+        slots = calloc(EXEC_CACHE_SLOTS, sizeof(*slots));
+        if (!slots) return;
+    }
+
+    uint32_t n = collectEdges(map, edges);
+    entry = claimSlot();
+    if (entry->edge_capacity < n) {
+        uint32_t* grown = realloc(entry->edges, n * sizeof(uint32_t));
+        if (!grown) return;
+        entry->edges = grown;
+        entry->edge_capacity = n;
+    }
+    memcpy(entry->edges, edges, n * sizeof(uint32_t));
+    entry->edge_count = n;
+    entry->input = input;
+    entry->status = status;
+    entry->exec_us = exec_us;
+    entry->referenced = 0;
+    entry->used = 1;
+    if (extra) memcpy(entry->extra, extra, sizeof(entry->extra));
+    else memset(entry->extra, 0, sizeof(entry->extra));
+    HASH_ADD_INT(index_by_input, input, entry);
+    COUNT(inserts);
+}
+
+void exec_cache_clear(void) {
+    if (!slots) return;
+    HASH_CLEAR(hh, index_by_input);
+    for (int i = 0; i < EXEC_CACHE_SLOTS; i++) slots[i].used = 0;
+    clock_hand = 0;
+}
+
+exec_cache_stats_t exec_cache_stats(void) {
+    exec_cache_stats_t s;
+    s.lookups = __atomic_load_n(&counters.lookups, __ATOMIC_RELAXED);
+    s.hits = __atomic_load_n(&counters.hits, __ATOMIC_RELAXED);
+    s.inserts = __atomic_load_n(&counters.inserts, __ATOMIC_RELAXED);
+    s.evictions = __atomic_load_n(&counters.evictions, __ATOMIC_RELAXED);
+    s.verified = __atomic_load_n(&counters.verified, __ATOMIC_RELAXED);
+    return s;
+}
+
+void exec_cache_print_summary(void) {
+    exec_cache_stats_t s = exec_cache_stats();
+    if (s.lookups == 0) return;
+    printf("Execution cache: %llu hits / %llu lookups (%.1f%%), %llu entries cached, %llu evicted, "
+           "%llu hits re-verified%s\n",
+           (unsigned long long)s.hits, (unsigned long long)s.lookups, 100.0 * (double)s.hits / (double)s.lookups,
+           (unsigned long long)s.inserts, (unsigned long long)s.evictions, (unsigned long long)s.verified,
+           nondeterministic ? " (disabled: nondeterministic target)" : "");
+}
@@ -0,0 +1,299 @@
+// filepath: src/executor.c
+#define _GNU_SOURCE // For pipe2
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/shm.h>
+#include <sys/wait.h>
+
+#include "../headers/executor.h"
+#include "../headers/target.h"
+#include "../headers/coverage.h"
+#include "../headers/logger.h"
+#include "../headers/directed.h"
+#include "../headers/execcache.h"
+
+// Read/write exactly len bytes, retrying on EINTR. Returns 0 or -1 (EOF/error).
+static int readFull(int fd, void* buf, size_t len) {
+    uint8_t* p = buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int writeFull(int fd, const void* buf, size_t len) {
+    const uint8_t* p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// Ctrl-C reaches the whole process group; the parent stops the pool by closing
+// our input pipe. A handler (not SIG_IGN) so the targets still get the default.
+static void workerIgnoreSignal(int sig) {
+    (void)sig;
+}
+
+// Worker process: own coverage map, run inputs until the input pipe closes
+static void workerLoop(int in_fd, int out_fd, const char* exePath, unsigned int timeout_ms) {
+    // Drop the parent's mapping (without removing it) and create our own,
+    // carrying over the directed distance table
+    coverage_t* parent_map = fuzz_shared_mem.map;
+    const shm_extra_t* parent_extra = fuzz_shared_mem.extra;
+    fuzz_shared_mem.map = NULL;
+    fuzz_shared_mem.extra = NULL;
+    fuzz_shared_mem.shm_id = -1;
+    set_shared_memory_quiet(1);
+    signal(SIGINT, workerIgnoreSignal);
+    signal(SIGTERM, SIG_DFL);
+    if (setup_shared_memory() != 0) {
+        _exit(1);
+    }
+    if (parent_extra) {
+        memcpy(&fuzz_shared_mem.extra->table, &parent_extra->table, sizeof(directed_table_t));
+    }
+    if (parent_map) {
+        shmdt(parent_map);
+    }
+    exec_cache_set_enabled(0); // The parent consults its cache before dispatching
+
+    // Tell the parent which segment is ours so it can read our maps
+    if (writeFull(out_fd, &fuzz_shared_mem.shm_id, sizeof(int)) != 0) {
+        destroy_shared_memory();
+        _exit(1);
+    }
+
+    int input;
+    while (readFull(in_fd, &input, sizeof(input)) == 0) {
+        exec_result_t result;
+        result.status = execute_target_fork(exePath, input, timeout_ms);
+        result.cov_hash = coverage_path_hash(fuzz_shared_mem.map);
+        result.exec_us = get_last_exec_time_us();
+        result.cached = 0;
+        if (writeFull(out_fd, &result, sizeof(result)) != 0) {
+            break;
+        }
+    }
+
+    destroy_shared_memory();
+    fflush(stdout);
+    _exit(0);
+}
+
+int executor_pool_start(executor_pool_t* pool, const char* exePath, int workers, unsigned int timeout_ms) {
+    memset(pool, 0, sizeof(*pool));
+    pool->timeout_ms = timeout_ms;
+    if (workers < 1) workers = 1;
+    if (workers > EXECUTOR_MAX_WORKERS) workers = EXECUTOR_MAX_WORKERS;
+
+    // A worker dying mid-batch must not kill the fuzzer on write
+    signal(SIGPIPE, SIG_IGN);
+    fflush(stdout);
+    fflush(stderr);
+
+    for (int w = 0; w < workers; w++) {
+        int to_pipe[2], from_pipe[2];
+        if (pipe2(to_pipe, O_CLOEXEC) < 0) {
+            LOG_E("Exec", "pipe2 failed: %s", strerror(errno));
+            executor_pool_stop(pool);
+            return -1;
+        }
+        if (pipe2(from_pipe, O_CLOEXEC) < 0) {
+            LOG_E("Exec", "pipe2 failed: %s", strerror(errno));
+            close(to_pipe[0]);
+            close(to_pipe[1]);
+            executor_pool_stop(pool);
+            return -1;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            LOG_E("Exec", "fork failed: %s", strerror(errno));
+            close(to_pipe[0]); close(to_pipe[1]);
+            close(from_pipe[0]); close(from_pipe[1]);
+            executor_pool_stop(pool);
+            return -1;
+        }
+        if (pid == 0) {
+            // Only keep our own pipe ends (earlier workers' fds are O_CLOEXEC but still open here)
+            for (int i = 0; i < pool->workers; i++) {
+                close(pool->to_worker[i]);
+                close(pool->from_worker[i]);
+            }
+            close(to_pipe[1]);
+            close(from_pipe[0]);
+            workerLoop(to_pipe[0], from_pipe[1], exePath, timeout_ms);
+        }
+
+        close(to_pipe[0]);
+        close(from_pipe[1]);
+        pool->pids[w] = pid;
+        pool->to_worker[w] = to_pipe[1];
+        pool->from_worker[w] = from_pipe[0];
+        pool->workers++;
+
+        int shm_id;
+        coverage_t* map = (void*)-1;
+        if (readFull(from_pipe[0], &shm_id, sizeof(shm_id)) == 0) {
+            map = shmat(shm_id, NULL, 0);
+        }
+        if (map == (void*)-1) {
+            LOG_E("Exec", "Cannot attach executor worker %d's shared memory", w);
+            executor_pool_stop(pool);
+            return -1;
+        }
+        // Both the worker and we are attached now: mark the segment for removal
+        // so it goes away with the last detach, even if the fuzzer is killed
+        shmctl(shm_id, IPC_RMID, NULL);
+        pool->maps[w] = map;
+    }
+    return 0;
+}
+
+static void failResult(exec_result_t* result, coverage_t* map) {
+    result->status = FUZZER_EXEC_ERROR;
+    result->cov_hash = 0;
+    result->exec_us = 0;
+    result->cached = 0;
+    if (map) memset(map, 0, COVERAGE_MAP_SIZE);
+}
+
+int executor_pool_run(executor_pool_t* pool, const int* inputs, int count, exec_result_t* results) {
+    return executor_pool_run_maps(pool, inputs, count, results, NULL, NULL);
+}
+
+int executor_pool_run_maps(executor_pool_t* pool, const int* inputs, int count, exec_result_t* results,
+                           coverage_t* const* maps, exec_run_extra_t* extras) {
+    int busy[EXECUTOR_MAX_WORKERS]; // Input index a worker is running, or -1
+    int dead[EXECUTOR_MAX_WORKERS] = {0};
+    struct pollfd fds[EXECUTOR_MAX_WORKERS];
+    int pending[count]; // Inputs to dispatch, in order
+    uint8_t verify[count]; // Cache hits run anyway to check determinism
+    int pending_count = 0;
+    int next = 0, done = 0, failed = 0;
+
+    for (int w = 0; w < pool->workers; w++) busy[w] = -1;
+
+    // Runs the execution cache already knows are restored here instead of
+    // dispatched, except the hits due for a determinism check
+    for (int i = 0; i < count; i++) {
+        exec_result_t* result = &results[i];
+        verify[i] = 0;
+        if (maps && exec_cache_lookup(inputs[i], maps[i], extras ? extras[i].bytes : NULL, &result->status,
+                                      &result->exec_us)) {
+            if (!exec_cache_should_verify()) {
+                result->cov_hash = coverage_path_hash(maps[i]);
+                result->cached = 1;
+                done++;
+                continue;
+            }
+            verify[i] = 1;
+        }
+        pending[pending_count++] = i;
+    }
+
+    while (done < count) {
+        int nfds = 0;
+        int worker_of[EXECUTOR_MAX_WORKERS];
+
+        for (int w = 0; w < pool->workers; w++) {
+            if (dead[w]) continue;
+            if (busy[w] < 0 && next < pending_count) {
+                if (writeFull(pool->to_worker[w], &inputs[pending[next]], sizeof(int)) != 0) {
+                    LOG_W("Exec", "Executor worker %d stopped accepting inputs", w);
+                    dead[w] = 1;
+                    continue;
+                }
+                busy[w] = pending[next++];
+            }
+            if (busy[w] >= 0) {
+                fds[nfds].fd = pool->from_worker[w];
+                fds[nfds].events = POLLIN;
+                worker_of[nfds++] = w;
+            }
+        }
+
+        if (nfds == 0) {
+            // Every worker is gone: fail the remaining inputs
+            for (; next < pending_count; next++, done++) {
+                failResult(&results[pending[next]], maps ? maps[pending[next]] : NULL);
+            }
+            failed = 1;
+            break;
+        }
+
+        if (poll(fds, (nfds_t)nfds, -1) < 0) {
+            if (errno == EINTR) continue;
+            LOG_E("Exec", "poll failed: %s", strerror(errno));
+            return -1;
+        }
+
+        for (int i = 0; i < nfds; i++) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            int w = worker_of[i];
+            int index = busy[w];
+            exec_result_t* result = &results[index];
+            if (readFull(pool->from_worker[w], result, sizeof(*result)) != 0) {
+                LOG_W("Exec", "Executor worker %d exited unexpectedly", w);
+                failResult(result, maps ? maps[index] : NULL);
+                dead[w] = 1;
+                failed = 1;
+            } else {
+                // The worker waits for its next input, so its map is stable until we send one
+                const coverage_t* map = pool->maps[w];
+                if (maps) memcpy(maps[index], map, COVERAGE_MAP_SIZE);
+                if (extras) memcpy(extras[index].bytes, map + SHM_EXTRA_OFFSET, SHM_EXTRA_RUN_SIZE);
+                if (verify[index]) exec_cache_verify(inputs[index], maps[index], result->status);
+                else if (maps) exec_cache_insert(inputs[index], maps[index], map + SHM_EXTRA_OFFSET,
+                                                 result->status, result->exec_us);
+            }
+            busy[w] = -1;
+            done++;
+        }
+    }
+    return failed ? -1 : 0;
+}
+
+void executor_replay_result(const exec_result_t* result, const exec_run_extra_t* extra) {
+    if (fuzz_shared_mem.extra) {
+        if (extra) memcpy(fuzz_shared_mem.extra, extra->bytes, SHM_EXTRA_RUN_SIZE);
+        else memset(fuzz_shared_mem.extra, 0, SHM_EXTRA_RUN_SIZE);
+    }
+    if (result->cached) set_last_exec_time_us(result->exec_us); // Not an execution
+    else if (result->status != FUZZER_EXEC_ERROR) record_pooled_exec(result->exec_us);
+}
+
+void executor_pool_sync_directed(executor_pool_t* pool) {
+    for (int w = 0; w < pool->workers; w++) {
+        directed_sync_table((shm_extra_t*)(pool->maps[w] + SHM_EXTRA_OFFSET));
+    }
+}
+
+void executor_pool_stop(executor_pool_t* pool) {
+    // Closing the input pipe makes each worker clean up and exit
+    for (int w = 0; w < pool->workers; w++) {
+        close(pool->to_worker[w]);
+    }
+    for (int w = 0; w < pool->workers; w++) {
+        waitpid(pool->pids[w], NULL, 0);
+        close(pool->from_worker[w]);
+        if (pool->maps[w]) shmdt(pool->maps[w]);
+        pool->maps[w] = NULL;
+    }
+    pool->workers = 0;
+}
@@ -0,0 +1,340 @@
+// filepath: src/fitness.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../headers/fitness.h"
+
+#define NOVELTY_ROWS (NOVELTY_HASHES / NOVELTY_BANDS)
+#define NOVELTY_MAX_CANDIDATES 64 // Archive entries compared per lookup
+#define NOVELTY_NONE (-1)
+
+static fitness_mode_t mode = FITNESS_EDGES;
+static const char* const mode_names[FITNESS_MODE_COUNT] = {"edges", "novelty", "rarity", "pareto"};
+
+// Novelty archive: MinHash signatures in a ring (the oldest is replaced),
+// indexed by one LSH table per band. Bucket chains are linked through next[].
+typedef struct {
+    uint32_t signatures[NOVELTY_ARCHIVE_SIZE][NOVELTY_HASHES];
+    int heads[NOVELTY_BANDS][NOVELTY_BUCKETS];
+    int next[NOVELTY_BANDS][NOVELTY_ARCHIVE_SIZE];
+    uint16_t buckets[NOVELTY_ARCHIVE_SIZE][NOVELTY_BANDS]; // Bucket of each entry, for unlinking
+    uint32_t seen[NOVELTY_ARCHIVE_SIZE];                   // Lookup stamp: candidate already compared
+    uint32_t stamp;
+    int count;
+    int oldest;
+} novelty_archive_t;
+
+static novelty_archive_t* archive = NULL;
+static uint64_t hash_mul[NOVELTY_HASHES]; // Multiply-shift hash family, fixed seeds
+static uint64_t hash_add[NOVELTY_HASHES];
+
+static uint32_t* edge_runs = NULL; // Rarity: runs that hit each edge
+
+// Fixed generator for the hash family: the fuzzer's rand() stream (and so seeded runs) is untouched
+static uint64_t splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static int initNovelty(void) {
+    if (archive) return 0;
+    archive = malloc(sizeof(*archive));
+    if (!archive) return -1;
+    archive->stamp = 0;
+    archive->count = 0;
+    archive->oldest = 0;
+    memset(archive->seen, 0, sizeof(archive->seen));
+    for (int b = 0; b < NOVELTY_BANDS; b++) {
+        for (int k = 0; k < NOVELTY_BUCKETS; k++) archive->heads[b][k] = NOVELTY_NONE;
+    }
+
+    uint64_t state = 0x6E6F76656C747931ULL;
+    for (int j = 0; j < NOVELTY_HASHES; j++) {
+        hash_mul[j] = splitmix64(&state) | 1; // Odd multiplier
+        hash_add[j] = splitmix64(&state);
+    }
+    return 0;
+}
+
+int fitness_set_mode(const char* name) {
+    for (int m = 0; m < FITNESS_MODE_COUNT; m++) {
+        if (strcmp(name, mode_names[m]) != 0) continue;
+        if (m == FITNESS_NOVELTY && initNovelty() != 0) return -1;
+        if (m == FITNESS_RARITY && !edge_runs) {
+            edge_runs = calloc(COVERAGE_MAP_SIZE, sizeof(*edge_runs));
+            if (!edge_runs) return -1;
+        }
+        mode = (fitness_mode_t)m;
+        return 0;
+    }
+    return -1;
+}
+
+fitness_mode_t fitness_mode(void) {
+    return mode;
+}
+
+const char* fitness_mode_name(void) {
+    return mode_names[mode];
+}
+
+// Run body for every hit edge of a map. Run maps are sparse: zero 8-byte
+// words are skipped with one compare.
+#define FOR_EACH_HIT(map, edge, count, body)                               \
+    for (int word_ = 0; word_ < COVERAGE_MAP_SIZE; word_ += 8) {           \
+        uint64_t bits_;                                                    \
+        memcpy(&bits_, (map) + word_, sizeof(bits_));                      \
+        if (!bits_) continue;                                              \
+        for (int edge = word_; edge < word_ + 8; edge++) {                 \
+            coverage_t count = (map)[edge];                                \
+            if (count) { body; }                                           \
+        }                                                                  \
+    }
+
+// log2 bucket of a hit count: 1 -> 1, 2-3 -> 2, 4-7 -> 3, ...
+static int hitDepth(coverage_t count) {
+    return 32 - __builtin_clz((unsigned int)count);
+}
+
+// --- Novelty ---
+
+static void minhash(const coverage_t* map, uint32_t* signature, int* edges) {
+    int n = 0;
+    for (int j = 0; j < NOVELTY_HASHES; j++) signature[j] = UINT32_MAX;
+    FOR_EACH_HIT(map, e, count, {
+        (void)count;
+        n++;
+        for (int j = 0; j < NOVELTY_HASHES; j++) {
+            uint32_t h = (uint32_t)((hash_mul[j] * (uint64_t)(e + 1) + hash_add[j]) >> 32);
+            if (h < signature[j]) signature[j] = h;
+        }
+    });
+    *edges = n;
+}
+
+static uint32_t bandBucket(const uint32_t* signature, int band) {
+    uint64_t h = 0xCBF29CE484222325ULL ^ (uint64_t)band;
+    for (int r = 0; r < NOVELTY_ROWS; r++) {
+        h ^= signature[band * NOVELTY_ROWS + r];
+        h *= 0x100000001B3ULL;
+    }
+    return (uint32_t)(h ^ (h >> 29)) % NOVELTY_BUCKETS;
+}
+
+// Estimated Jaccard distance: share of MinHash values that differ
+static double signatureDistance(const uint32_t* a, const uint32_t* b) {
+    int same = 0;
+    for (int j = 0; j < NOVELTY_HASHES; j++) same += a[j] == b[j];
+    return 1.0 - (double)same / NOVELTY_HASHES;
+}
+
+static void unlinkEntry(int slot) {
+    for (int b = 0; b < NOVELTY_BANDS; b++) {
+        int* link = &archive->heads[b][archive->buckets[slot][b]];
+        while (*link != NOVELTY_NONE && *link != slot) link = &archive->next[b][*link];
+        if (*link == slot) *link = archive->next[b][slot];
+    }
+}
+
+static void archiveSignature(const uint32_t* signature, const uint32_t* buckets) {
+    int slot;
+    if (archive->count < NOVELTY_ARCHIVE_SIZE) {
+        slot = archive->count++;
+    } else {
+        slot = archive->oldest;
+        archive->oldest = (archive->oldest + 1) % NOVELTY_ARCHIVE_SIZE;
+        unlinkEntry(slot);
+    }
+    memcpy(archive->signatures[slot], signature, sizeof(archive->signatures[slot]));
+    for (int b = 0; b < NOVELTY_BANDS; b++) {
+        archive->buckets[slot][b] = (uint16_t)buckets[b];
+        archive->next[b][slot] = archive->heads[b][buckets[b]];
+        archive->heads[b][buckets[b]] = slot;
+    }
+}
+
+// Mean distance to the NOVELTY_K nearest archived runs that share an LSH
+// bucket with this one. Runs sharing no bucket are far apart, so missing
+// neighbours count as distance 1.
+static double noveltyScore(const coverage_t* map) {
+    uint32_t signature[NOVELTY_HASHES];
+    uint32_t buckets[NOVELTY_BANDS];
+    double nearest[NOVELTY_K];
+    int edges;
+
+    minhash(map, signature, &edges);
+    if (edges == 0) return 0.0; // Nothing ran (exec error): not novel
+
+    for (int k = 0; k < NOVELTY_K; k++) nearest[k] = 1.0;
+    if (++archive->stamp == 0) { // Stamp wrapped: forget old marks
+        memset(archive->seen, 0, sizeof(archive->seen));
+        archive->stamp = 1;
+    }
+
+    int compared = 0;
+    for (int b = 0; b < NOVELTY_BANDS; b++) {
+        buckets[b] = bandBucket(signature, b);
+        for (int slot = archive->heads[b][buckets[b]];
+             slot != NOVELTY_NONE && compared < NOVELTY_MAX_CANDIDATES; slot = archive->next[b][slot]) {
+            if (archive->seen[slot] == archive->stamp) continue;
+            archive->seen[slot] = archive->stamp;
+            compared++;
+
+            double d = signatureDistance(signature, archive->signatures[slot]);
+            if (d >= nearest[NOVELTY_K - 1]) continue;
+            int k = NOVELTY_K - 1; // Insert into the sorted k-nearest list
+            while (k > 0 && nearest[k - 1] > d) {
+                nearest[k] = nearest[k - 1];
+                k--;
+            }
+            nearest[k] = d;
+        }
+    }
+
+    double novelty = 0.0;
+    for (int k = 0; k < NOVELTY_K; k++) novelty += nearest[k];
+    novelty /= NOVELTY_K;
+    if (novelty >= NOVELTY_ADD_THRESHOLD) archiveSignature(signature, buckets);
+    return novelty;
+}
+
+// --- Rarity ---
+
+static double rarityScore(const coverage_t* map) {
+    double score = 0.0;
+    FOR_EACH_HIT(map, e, count, {
+        (void)count;
+        if (edge_runs[e] < UINT32_MAX) edge_runs[e]++;
+        score += 1.0 / edge_runs[e];
+    });
+    return score;
+}
+
+double fitness_evaluate(const coverage_t* map, int new_edges, unsigned int exec_us,
+                        fitness_objectives_t* objectives) {
+    double fitness = new_edges;
+    if (!map) {
+        if (objectives) *objectives = (fitness_objectives_t){0, 0, exec_us};
+        return fitness;
+    }
+
+    switch (mode) {
+    case FITNESS_NOVELTY:
+        fitness += NOVELTY_WEIGHT * noveltyScore(map);
+        break;
+    case FITNESS_RARITY:
+        fitness += rarityScore(map);
+        break;
+    case FITNESS_PARETO:
+        if (objectives) {
+            objectives->edges = 0;
+            objectives->depth = 0;
+            objectives->exec_us = exec_us;
+            FOR_EACH_HIT(map, e, count, {
+                (void)e;
+                objectives->edges++;
+                objectives->depth += hitDepth(count);
+            });
+        }
+        break;
+    default:
+        break;
+    }
+    return fitness;
+}
+
+// --- Pareto ranking ---
+
+// a dominates b: no worse on every objective, better on one
+static int dominates(const fitness_objectives_t* a, const fitness_objectives_t* b) {
+    if (a->edges < b->edges || a->depth < b->depth || a->exec_us > b->exec_us) return 0;
+    return a->edges > b->edges || a->depth > b->depth || a->exec_us < b->exec_us;
+}
+
+static double objectiveValue(const fitness_objectives_t* o, int objective) {
+    if (objective == 0) return o->edges;
+    if (objective == 1) return o->depth;
+    return o->exec_us;
+}
+
+// Crowding distance of each member of one front, normalized to [0, 1]
+// (boundary members get 1, so the extremes of the front are kept)
+static void crowding(const fitness_objectives_t* objectives, const int* members, int n, double* out) {
+    int order[n];
+    for (int i = 0; i < n; i++) out[i] = 0.0;
+    if (n <= 2) {
+        for (int i = 0; i < n; i++) out[i] = 1.0;
+        return;
+    }
+
+    for (int objective = 0; objective < 3; objective++) {
+        for (int i = 0; i < n; i++) order[i] = i;
+        for (int i = 1; i < n; i++) { // Insertion sort: fronts are small
+            int cur = order[i];
+            double v = objectiveValue(&objectives[members[cur]], objective);
+            int j = i;
+            while (j > 0 && objectiveValue(&objectives[members[order[j - 1]]], objective) > v) {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = cur;
+        }
+        double lo = objectiveValue(&objectives[members[order[0]]], objective);
+        double hi = objectiveValue(&objectives[members[order[n - 1]]], objective);
+        out[order[0]] += 1.0;
+        out[order[n - 1]] += 1.0;
+        if (hi <= lo) continue;
+        for (int i = 1; i < n - 1; i++) {
+            double gap = objectiveValue(&objectives[members[order[i + 1]]], objective) -
+                         objectiveValue(&objectives[members[order[i - 1]]], objective);
+            out[order[i]] += gap / (hi - lo);
+        }
+    }
+    for (int i = 0; i < n; i++) out[i] = out[i] > 3.0 ? 1.0 : out[i] / 3.0;
+}
+
+// Non-dominated sort: score = (fronts - front) + half the crowding distance,
+// so every member of a better front outranks the next front
+void fitness_pareto_scores(const fitness_objectives_t* objectives, int count, double* scores) {
+    int front_of[count];
+    int members[count];
+    double crowd[count];
+    int assigned = 0;
+    int fronts = 0;
+
+    for (int i = 0; i < count; i++) front_of[i] = -1;
+    while (assigned < count) {
+        int n = 0;
+        for (int i = 0; i < count; i++) {
+            if (front_of[i] >= 0) continue;
+            int dominated = 0;
+            for (int j = 0; j < count && !dominated; j++) {
+                dominated = j != i && front_of[j] < 0 && dominates(&objectives[j], &objectives[i]);
+            }
+            if (!dominated) members[n++] = i;
+        }
+        for (int m = 0; m < n; m++) front_of[members[m]] = fronts;
+        assigned += n;
+        fronts++;
+    }
+
+    for (int f = 0; f < fronts; f++) {
+        int n = 0;
+        for (int i = 0; i < count; i++) {
+            if (front_of[i] == f) members[n++] = i;
+        }
+        crowding(objectives, members, n, crowd);
+        for (int m = 0; m < n; m++) scores[members[m]] = (fronts - f) + 0.5 * crowd[m];
+    }
+}
+
+void fitness_cleanup(void) {
+    free(archive);
+    archive = NULL;
+    free(edge_runs);
+    edge_runs = NULL;
+    mode = FITNESS_EDGES;
+}
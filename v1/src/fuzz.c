@@ -13,6 +13,15 @@
 
 static unsigned int counter = 0;
 
+// Havoc strategy; raised while coverage has plateaued (see plateau.h)
+static int havoc_max_stack = HAVOC_DEFAULT_STACK;
+static int havoc_dictionary_pct = HAVOC_DEFAULT_DICTIONARY_PCT;
+
+void setHavocStrategy(int max_stack, int dictionary_pct) {
+    havoc_max_stack = max_stack > 0 ? max_stack : 1;
+    havoc_dictionary_pct = dictionary_pct;
+}
+
 // Bit-level mutation implementation
 int mutateBitFlip(int value) {
     // Choose a random bit to flip
@@ -75,10 +84,15 @@ int mutateDictionary(int value) {
 
 // Havoc mutation - apply multiple random mutations
 int mutateHavoc(int value) {
-    int mutations = rand() % 5 + 1; // Apply 1-5 random mutations
+    int mutations = rand() % havoc_max_stack + 1; // Apply 1-havoc_max_stack random mutations
     int result = value;
     
     for (int i = 0; i < mutations; i++) {
+        // Above the default share, magic values get an extra draw of their own
+        if (havoc_dictionary_pct > HAVOC_DEFAULT_DICTIONARY_PCT && rand() % 100 < havoc_dictionary_pct) {
+            result = mutateDictionary(result);
+            continue;
+        }
         switch (rand() % 4) {
             case 0:
                 result = mutateBitFlip(result);
@@ -190,6 +204,53 @@ int crossover(int parent1, int parent2) {
     return child;
 }
 
+// Find the first and last differing byte in the region both buffers share
+static void locateDiffs(const uint8_t *a, const uint8_t *b, size_t len, long *first, long *last) {
+    *first = -1;
+    *last = -1;
+    for (size_t i = 0; i < len; i++) {
+        if (a[i] != b[i]) {
+            if (*first == -1) *first = (long)i;
+            *last = (long)i;
+        }
+    }
+}
+
+// Splice implementation (AFL-style): split somewhere in [first_diff, last_diff)
+size_t spliceBuffers(uint8_t *out, size_t out_cap, const uint8_t *a, size_t a_len,
+                     const uint8_t *b, size_t b_len) {
+    if (!out || !a || !b || out_cap == 0) {
+        return 0;
+    }
+
+    long first_diff, last_diff;
+    size_t common = a_len < b_len ? a_len : b_len;
+    locateDiffs(a, b, common, &first_diff, &last_diff);
+
+    // Need at least two differing positions, otherwise the result equals a parent
+    if (first_diff < 0 || last_diff < 2 || first_diff == last_diff) {
+        return 0;
+    }
+
+    size_t split_at = (size_t)(first_diff + rand() % (last_diff - first_diff));
+    size_t out_len = b_len < out_cap ? b_len : out_cap;
+    if (split_at > out_len) split_at = out_len;
+
+    memcpy(out, a, split_at);
+    memcpy(out + split_at, b + split_at, out_len - split_at);
+    return out_len;
+}
+
+// Splice two integers as 4-byte buffers
+int mutateSplice(int value, int other) {
+    int child;
+    if (spliceBuffers((uint8_t *)&child, sizeof(child), (const uint8_t *)&value, sizeof(value),
+                      (const uint8_t *)&other, sizeof(other)) == 0) {
+        return value;
+    }
+    return child;
+}
+
 int generateSequence(int length) {
     int sum = 0;
     for (int i = 0; i < length; i++) {
@@ -8,77 +8,62 @@
 #include "../headers/coverage.h" // For COVERAGE_MAP_SIZE, coverage_t, calculate_coverage_fitness
 #include "../headers/corpus.h"
 
-// Global population arrays 
+// Double-buffered populations: two fixed Individual arrays whose coverage maps
+// point into one preallocated arena. population/next_generation point at the
+// two buffers and swapPopulations exchanges them, so a generation turnover
+// neither allocates nor copies maps.
+static Individual generation_buffers[2][POPULATION_SIZE];
+static coverage_t *map_arena = NULL; // 2 * POPULATION_SIZE maps, then MIGRANT_MAPS scratch maps
+
+// Emigrants' maps are copied out before any island is overwritten
+#define MAX_ISLANDS (POPULATION_SIZE / ISLAND_MIN_SIZE)
+#define MIGRANT_MAPS (MAX_ISLANDS * MIGRATION_SIZE)
 Individual *population = NULL;
 Individual *next_generation = NULL;
-int populationIndex = 0; // Use static if only used here?
 
 // Initialize memory for populations and their coverage maps
 void initializePopulations(void)
 {
-    population = malloc(POPULATION_SIZE * sizeof(Individual));
-    next_generation = malloc(POPULATION_SIZE * sizeof(Individual));
-    // global_coverage_map = calloc(COVERAGE_MAP_SIZE, sizeof(coverage_t)); // Moved to main
-
-    if (!population || !next_generation)
+    map_arena = calloc((size_t)2 * POPULATION_SIZE + MIGRANT_MAPS, COVERAGE_MAP_SIZE * sizeof(coverage_t));
+    if (!map_arena)
     {
-        fprintf(stderr, "Failed to allocate memory for populations\n");
+        fprintf(stderr, "Failed to allocate memory for population coverage maps\n");
         exit(1);
     }
 
-    // Initialize coverage maps for each individual within the population structures
-    for (int i = 0; i < POPULATION_SIZE; i++)
+    for (int g = 0; g < 2; g++)
     {
-
-// Assuming Individual struct has 'coverage_map' field defined as:
-// coverage_t coverage_map[COVERAGE_MAP_SIZE]; OR coverage_t* coverage_map;
-#ifdef INDIVIDUAL_MAP_IS_POINTER
-        // If it's a pointer, allocate memory for each map
-        population[i].coverage_map = calloc(COVERAGE_MAP_SIZE, sizeof(coverage_t));
-        next_generation[i].coverage_map = calloc(COVERAGE_MAP_SIZE, sizeof(coverage_t));
-        if (!population[i].coverage_map || !next_generation[i].coverage_map)
+        for (int i = 0; i < POPULATION_SIZE; i++)
         {
-            fprintf(stderr, "Failed to allocate memory for individual coverage maps\n");
-            // Need better cleanup here
-            exit(1);
+            Individual *ind = &generation_buffers[g][i];
+            ind->input_value = 0;
+            ind->fitness_score = 0.0;
+            ind->timestamp = 0;
+            ind->coverage_map = map_arena + ((size_t)g * POPULATION_SIZE + i) * COVERAGE_MAP_SIZE;
         }
-#else
-        // If coverage_map is an array member, just zero it out (implicitly done by calloc if struct is calloc'd)
-        memset(population[i].coverage_map, 0, COVERAGE_MAP_SIZE * sizeof(coverage_t));
-        memset(next_generation[i].coverage_map, 0, COVERAGE_MAP_SIZE * sizeof(coverage_t));
-#endif
     }
-
-    populationIndex = 0;
+    population = generation_buffers[0];
+    next_generation = generation_buffers[1];
 }
 
 // Cleanup memory allocated for populations
 void cleanupPopulations(void)
 {
-#ifdef INDIVIDUAL_MAP_IS_POINTER
-    // If maps were dynamically allocated, free them
-    if (population)
-    {
-        for (int i = 0; i < POPULATION_SIZE; i++)
-        {
-            free(population[i].coverage_map);
-        }
-    }
-    if (next_generation)
-    {
-        for (int i = 0; i < POPULATION_SIZE; i++)
-        {
-            free(next_generation[i].coverage_map);
-        }
-    }
-#endif
-
-    free(population);
+    free(map_arena);
+    map_arena = NULL;
     population = NULL;
-    free(next_generation);
     next_generation = NULL;
 }
 
+// Make next_generation the current population. The old population's buffer
+// (maps included) is reused for the generation after.
+void swapPopulations(void)
+{
+    Individual *old = population;
+    population = next_generation;
+    next_generation = old;
+}
+
 // --- Functions operating on individual coverage maps ---
 
 // Reset an individual's coverage map
@@ -100,99 +85,175 @@ int compareCoverageMaps(const coverage_t *map1, const coverage_t *map2)
 
 // --- GA Specific Functions ---
 
-// Tournament selection function (unchanged conceptually)
-Individual selectParent(Individual population[], int population_size)
+// Tournament selection: index of the fittest of TOURNAMENT_SIZE random contenders
+int selectParent(const Individual population[], int population_size)
 {
     // Ensure tournament size is valid
     int tournament_size = (TOURNAMENT_SIZE > population_size) ? population_size : TOURNAMENT_SIZE;
     if (tournament_size <= 0)
-        return population[0]; // Should not happen
+        return 0; // Should not happen
 
     // Select the first contender randomly
-    Individual best_individual = population[rand() % population_size];
+    int best = rand() % population_size;
 
     // Run the tournament
     for (int i = 1; i < tournament_size; i++)
     {
-        Individual current_individual = population[rand() % population_size];
+        int current = rand() % population_size;
         // Compare fitness scores
-        if (current_individual.fitness_score > best_individual.fitness_score)
+        if (population[current].fitness_score > population[best].fitness_score)
         {
-            best_individual = current_individual; // Found a better contender
+            best = current; // Found a better contender
         }
     }
-    return best_individual; // Return the fittest from the tournament
+    return best; // Return the fittest from the tournament
 }
 
-// Generate the next generation based on selection, crossover, and mutation
+// Generate the next generation based on selection, crossover, and mutation.
+// Children are written in place: each keeps its preallocated map, which the
+// evaluation of the generation overwrites (so it is not cleared here).
 void generateNewPopulation(Individual population[], int population_size, Individual next_generation[], int min_range, int max_range) {
     for (int i = 0; i < population_size; i++) {
+        Individual *child = &next_generation[i];
 
         // Selection
-        Individual parent1 = selectParent(population, population_size);
-
-        // --- Initialize the child struct ---
-        Individual child;
-        child.input_value = 0; // Default
-        child.fitness_score = 0.0;
-        child.timestamp = time(NULL); // Set timestamp
-#ifdef INDIVIDUAL_MAP_IS_POINTER
-        child.coverage_map = NULL; 
-#endif
+        const Individual *parent1 = &population[selectParent(population, population_size)];
 
         // --- Crossover or Mutation ---
         if ((double)rand() / RAND_MAX < CROSSOVER_RATE && population_size >= 2) {
-             Individual parent2 = selectParent(population, population_size);
-             child.input_value = crossover(parent1.input_value, parent2.input_value);
+             const Individual *parent2 = &population[selectParent(population, population_size)];
+             child->input_value = crossover(parent1->input_value, parent2->input_value);
         } else {
-             child.input_value = mutateInteger(parent1.input_value, min_range, max_range);
+             child->input_value = mutateInteger(parent1->input_value, min_range, max_range);
         }
 
         // --- Clamp input ---
-        if (child.input_value < min_range) child.input_value = min_range;
-        if (child.input_value > max_range) child.input_value = max_range;
-
-        // --- Reset fitness (redundant if initialized above, but harmless) ---
-        child.fitness_score = 0.0;
-
-        // --- Allocate and Reset Map ---
-#ifdef INDIVIDUAL_MAP_IS_POINTER
-        // Allocate map for the child *if it doesn't have one* (check is now reliable)
-        if (!child.coverage_map) {
-             child.coverage_map = calloc(COVERAGE_MAP_SIZE, sizeof(coverage_t));
-             if (!child.coverage_map) {
-                 // Handle allocation failure
-                 fprintf(stderr, "[GA] FATAL: Failed to allocate map for child in generateNewPopulation\n");
-                 exit(1);
-             }
-             // No need to call resetIndividualCoverageMap right after calloc,
-             // as calloc already zeroes memory.
-        } else {
-             // This case shouldn't happen if we just initialized to NULL,
-             // but if it did, reset the existing map.
-             resetIndividualCoverageMap(child.coverage_map);
-        }
-        // If we want to be absolutely sure it's zeroed AFTER allocation check:
-        // resetIndividualCoverageMap(child.coverage_map); 
+        if (child->input_value < min_range) child->input_value = min_range;
+        if (child->input_value > max_range) child->input_value = max_range;
 
-#else // coverage_map is an array member
-        // Just reset the array contents
-        resetIndividualCoverageMap(child.coverage_map);
-#endif
+        child->fitness_score = 0.0;
+        child->timestamp = time(NULL);
+    }
+    //fprintf(stderr, "[GA] New generation created.\n");
+}
+
+// --- Island model ---
 
+static int island_count = 1;
+static int generation = 0; // Generations since the last setIslandCount
 
-        // --- Assign child to the next generation ---
-        next_generation[i] = child;
+int setIslandCount(int islands)
+{
+    int max_islands = POPULATION_SIZE / ISLAND_MIN_SIZE;
+    if (islands < 1)
+        islands = 1;
+    if (islands > max_islands)
+        islands = max_islands;
+    island_count = islands;
+    generation = 0;
+    return island_count;
+}
+
+int getIslandCount(void)
+{
+    return island_count;
+}
+
+// Island k holds individuals [islandStart(k), islandStart(k + 1)); the last
+// island takes the remainder when the population doesn't split evenly
+static int islandStart(int k)
+{
+    return k * (POPULATION_SIZE / island_count);
+}
+
+static int islandEnd(int k)
+{
+    return k == island_count - 1 ? POPULATION_SIZE : islandStart(k + 1);
+}
+
+void generateIslandPopulations(Individual population[], Individual next_generation[], int min_range, int max_range)
+{
+    // Selection never crosses an island boundary
+    for (int k = 0; k < island_count; k++)
+    {
+        int start = islandStart(k);
+        generateNewPopulation(&population[start], islandEnd(k) - start, &next_generation[start], min_range, max_range);
+    }
+}
+
+// Indices of the n fittest (best first) or n least fit (worst first) individuals
+// of an island. Ties go to the lower index for the fittest and to the higher
+// index for the least fit, so the two sets never overlap while the island has
+// at least 2n individuals, even when most fitness scores are equal.
+static void rankIsland(const Individual population[], int k, int n, int best, int out[])
+{
+    int count = 0;
+    for (int i = islandStart(k); i < islandEnd(k); i++)
+    {
+        // Insertion into the sorted prefix out[0..count)
+        int pos = count < n ? count++ : n;
+        while (pos > 0)
+        {
+            double other = population[out[pos - 1]].fitness_score;
+            int before = best ? population[i].fitness_score > other : population[i].fitness_score <= other;
+            if (!before)
+                break;
+            if (pos < n)
+                out[pos] = out[pos - 1];
+            pos--;
+        }
+        if (pos < n)
+            out[pos] = i;
     }
-    //fprintf(stderr, "[GA] New generation created.\n");
 }
 
-// Byte-level one-point crossover for TestCase data
-void tc_crossover(uint8_t *out, TestCase *p1, TestCase *p2) {
-    size_t len = p1->len < p2->len ? p1->len : p2->len;
-    size_t cp = rand() % len;
-    memcpy(out, p1->data, cp);
-    memcpy(out + cp, p2->data + cp, len - cp);
+int migrateIslands(Individual population[])
+{
+    if (island_count < 2 || ++generation % MIGRATION_INTERVAL != 0)
+        return 0;
+
+    // Ring topology: island k sends copies of its MIGRATION_SIZE fittest
+    // individuals to island k+1, replacing that island's least fit ones.
+    // All emigrants, maps included, are copied out before any island is overwritten.
+    static Individual migrants[MAX_ISLANDS][MIGRATION_SIZE];
+    coverage_t *scratch = map_arena + (size_t)2 * POPULATION_SIZE * COVERAGE_MAP_SIZE;
+    int index[MIGRATION_SIZE];
+    for (int k = 0; k < island_count; k++)
+    {
+        rankIsland(population, k, MIGRATION_SIZE, 1, index);
+        for (int m = 0; m < MIGRATION_SIZE; m++)
+        {
+            migrants[k][m] = population[index[m]];
+            migrants[k][m].coverage_map = scratch + ((size_t)k * MIGRATION_SIZE + m) * COVERAGE_MAP_SIZE;
+            memcpy(migrants[k][m].coverage_map, population[index[m]].coverage_map,
+                   COVERAGE_MAP_SIZE * sizeof(coverage_t));
+        }
+    }
+    for (int k = 0; k < island_count; k++)
+    {
+        const Individual *incoming = migrants[(k + island_count - 1) % island_count];
+        rankIsland(population, k, MIGRATION_SIZE, 0, index);
+        for (int m = 0; m < MIGRATION_SIZE; m++)
+        {
+            Individual *slot = &population[index[m]];
+            slot->input_value = incoming[m].input_value;
+            slot->fitness_score = incoming[m].fitness_score;
+            slot->timestamp = incoming[m].timestamp;
+            memcpy(slot->coverage_map, incoming[m].coverage_map, COVERAGE_MAP_SIZE * sizeof(coverage_t));
+        }
+    }
+    return 1;
+}
+
+// Byte-level splice crossover for TestCase data
+// Falls back to a copy of p1 when the parents are too similar to splice
+size_t tc_crossover(uint8_t *out, const TestCase *p1, const TestCase *p2) {
+    size_t len = spliceBuffers(out, MAX_TESTCASE_LEN, p1->data, p1->len, p2->data, p2->len);
+    if (len == 0) {
+        memcpy(out, p1->data, p1->len);
+        len = p1->len;
+    }
+    return len;
 }
 
 // Mutate a buffer of given length by random byte flips
@@ -209,12 +270,10 @@ void make_offspring(TestCase *child) {
     TestCase *p1 = select_parent();
     TestCase *p2 = select_parent();
     if (!p1 || !p2) return;
-    // Determine child length based on first parent
-    child->len = p1->len;
     // Allocate or reset coverage map
     child->coverage_map = calloc(COVERAGE_MAP_SIZE, sizeof(coverage_t));
-    // Generate data
-    tc_crossover(child->data, p1, p2);
+    // Generate data (child length comes from the splice)
+    child->len = tc_crossover(child->data, p1, p2);
     // Apply mutation
     tc_mutate(child->data, child->len);
     // Initialize fitness
@@ -0,0 +1,158 @@
+// filepath: src/hash.c
+#include <string.h>
+#include <stdint.h>
+
+#include "../headers/hash.h"
+
+// XXH64 primes
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+static inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t read32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t xxh_round(uint64_t acc, uint64_t input) {
+    acc += input * PRIME64_2;
+    acc = rotl64(acc, 31);
+    acc *= PRIME64_1;
+    return acc;
+}
+
+static inline uint64_t xxh_merge_round(uint64_t acc, uint64_t val) {
+    val = xxh_round(0, val);
+    acc ^= val;
+    acc = acc * PRIME64_1 + PRIME64_4;
+    return acc;
+}
+
+// Remaining < 32 bytes and avalanche (shared by one-shot and streaming)
+static uint64_t xxh_finalize(uint64_t h, const uint8_t *p, const uint8_t *end) {
+    while (p + 8 <= end) {
+        h ^= xxh_round(0, read64(p));
+        h = rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= (uint64_t)read32(p) * PRIME64_1;
+        h = rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * PRIME64_5;
+        h = rotl64(h, 11) * PRIME64_1;
+        p++;
+    }
+
+    // Avalanche
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+static uint64_t xxh_converge(const uint64_t v[4]) {
+    uint64_t h = rotl64(v[0], 1) + rotl64(v[1], 7) + rotl64(v[2], 12) + rotl64(v[3], 18);
+    h = xxh_merge_round(h, v[0]);
+    h = xxh_merge_round(h, v[1]);
+    h = xxh_merge_round(h, v[2]);
+    h = xxh_merge_round(h, v[3]);
+    return h;
+}
+
+static void xxh_reset_lanes(uint64_t v[4], uint64_t seed) {
+    v[0] = seed + PRIME64_1 + PRIME64_2;
+    v[1] = seed + PRIME64_2;
+    v[2] = seed;
+    v[3] = seed - PRIME64_1;
+}
+
+// Consume whole 32-byte stripes; returns the first unconsumed byte
+static const uint8_t *xxh_stripes(uint64_t v[4], const uint8_t *p, const uint8_t *end) {
+    while (p + 32 <= end) {
+        v[0] = xxh_round(v[0], read64(p)); p += 8;
+        v[1] = xxh_round(v[1], read64(p)); p += 8;
+        v[2] = xxh_round(v[2], read64(p)); p += 8;
+        v[3] = xxh_round(v[3], read64(p)); p += 8;
+    }
+    return p;
+}
+
+// XXH64 (little-endian hosts)
+uint64_t hash64(const void *data, size_t len, uint64_t seed) {
+    const uint8_t *p = (const uint8_t *)data;
+    const uint8_t *end = p + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        uint64_t v[4];
+        xxh_reset_lanes(v, seed);
+        p = xxh_stripes(v, p, end);
+        h = xxh_converge(v);
+    } else {
+        h = seed + PRIME64_5;
+    }
+
+    h += (uint64_t)len;
+    return xxh_finalize(h, p, end);
+}
+
+void hash64_init(hash64_state_t *state, uint64_t seed) {
+    xxh_reset_lanes(state->v, seed);
+    state->seed = seed;
+    state->total_len = 0;
+    state->buf_len = 0;
+}
+
+void hash64_update(hash64_state_t *state, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    const uint8_t *end = p + len;
+
+    state->total_len += len;
+    if (state->buf_len + len < sizeof(state->buf)) {
+        memcpy(state->buf + state->buf_len, p, len);
+        state->buf_len += (uint32_t)len;
+        return;
+    }
+    if (state->buf_len) { // Complete the buffered stripe
+        size_t fill = sizeof(state->buf) - state->buf_len;
+        memcpy(state->buf + state->buf_len, p, fill);
+        xxh_stripes(state->v, state->buf, state->buf + sizeof(state->buf));
+        p += fill;
+        state->buf_len = 0;
+    }
+    p = xxh_stripes(state->v, p, end);
+    memcpy(state->buf, p, (size_t)(end - p));
+    state->buf_len = (uint32_t)(end - p);
+}
+
+uint64_t hash64_digest(const hash64_state_t *state) {
+    uint64_t h = state->total_len >= 32 ? xxh_converge(state->v) : state->seed + PRIME64_5;
+    h += state->total_len;
+    return xxh_finalize(h, state->buf, state->buf + state->buf_len);
+}
+
+uint64_t hash_input_value(int input_value) {
+    return hash64(&input_value, sizeof(input_value), 0);
+}
+
+uint64_t hash_finding(int input_value, int is_timeout) {
+    return hash64(&input_value, sizeof(input_value), is_timeout ? 1 : 0);
+}
@@ -1,29 +1,229 @@
+// filepath: src/logger.c
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
 #include <stdarg.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "../headers/logger.h"
 
-void app_log(const char* level, const char* message) {
-    time_t now;
-    time(&now);
-    char* timestamp = ctime(&now);
-    timestamp[strlen(timestamp) - 1] = '\0'; // Remove newline
-    printf("%s %s%s\n", timestamp, level, message);
-}
-
-void app_log_with_value(const char* level, const char* message, const char* format, ...) {
-    time_t now;
-    time(&now);
-    char* timestamp = ctime(&now);
-    timestamp[strlen(timestamp) - 1] = '\0';
-    
-    printf("%s %s%s ", timestamp, level, message);
-    
+#define LOG_WRITE_BUFFER (64 * 1024) // Writer batches records into one write(2)
+#define LOG_LINE_MAX (LOG_MSG_SIZE + 64)
+
+typedef struct {
+    uint64_t time_ns; // Wall clock
+    int level;
+    const char* tag;
+    char message[LOG_MSG_SIZE];
+} log_record_t;
+
+// Single producer (the owning thread), single consumer (the writer)
+typedef struct log_ring {
+    log_record_t slots[LOG_RING_SLOTS];
+    uint32_t head;    // Next slot to fill, written by the owner
+    uint32_t tail;    // Next slot to drain, written by the writer
+    uint64_t dropped; // Messages lost to a full ring
+    struct log_ring* next;
+} log_ring_t;
+
+int log_level = LOG_LEVEL_INFO;
+
+static log_ring_t* rings = NULL; // Every thread's ring; rings live until exit
+static __thread log_ring_t* thread_ring = NULL;
+static pthread_t writer;
+static int running = 0;  // Writer thread alive in this process
+static int stopping = 0;
+static int registered = 0; // atfork/atexit handlers installed
+static uint64_t reported_drops = 0;
+
+static const char* const level_prefixes[] = {"Debug: ", "", "Warning: ", "Error: "};
+static const char* const level_names[] = {"debug", "info", "warn", "error", "off"};
+
+static uint64_t wallNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// "HH:MM:SS.mmm [Tag] Warning: message\n"; returns the length written
+static size_t formatRecord(char* buf, size_t size, uint64_t time_ns, int level, const char* tag,
+                           const char* message) {
+    time_t sec = (time_t)(time_ns / 1000000000ULL);
+    struct tm tm;
+    localtime_r(&sec, &tm);
+    int n = snprintf(buf, size, "%02d:%02d:%02d.%03d [%s] %s%s\n", tm.tm_hour, tm.tm_min, tm.tm_sec,
+                     (int)(time_ns / 1000000ULL % 1000), tag, level_prefixes[level], message);
+    if (n < 0) return 0;
+    if ((size_t)n >= size) { // Truncated: keep the line terminated
+        n = (int)size - 1;
+        buf[n - 1] = '\n';
+    }
+    return (size_t)n;
+}
+
+static void writeAll(const char* buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(STDERR_FILENO, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+}
+
+static void stripNewline(char* message) {
+    size_t len = strlen(message);
+    if (len > 0 && message[len - 1] == '\n') message[len - 1] = '\0';
+}
+
+static log_ring_t* registerRing(void) {
+    log_ring_t* ring = calloc(1, sizeof(*ring));
+    if (!ring) return NULL;
+    ring->next = __atomic_load_n(&rings, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&rings, &ring->next, ring, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+    thread_ring = ring;
+    return ring;
+}
+
+void log_write(int level, const char* tag, const char* format, ...) {
+    va_list args;
+    if (level < LOG_LEVEL_DEBUG) level = LOG_LEVEL_DEBUG;
+    if (level > LOG_LEVEL_ERROR) level = LOG_LEVEL_ERROR;
+
+    log_ring_t* ring = NULL;
+    if (__atomic_load_n(&running, __ATOMIC_ACQUIRE)) {
+        ring = thread_ring ? thread_ring : registerRing();
+    }
+    if (!ring) { // No writer: format and write right away
+        char message[LOG_MSG_SIZE];
+        char line[LOG_LINE_MAX];
+        va_start(args, format);
+        vsnprintf(message, sizeof(message), format, args);
+        va_end(args);
+        stripNewline(message);
+        writeAll(line, formatRecord(line, sizeof(line), wallNs(), level, tag, message));
+        return;
+    }
+
+    uint32_t head = ring->head;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= LOG_RING_SLOTS) {
+        __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    log_record_t* record = &ring->slots[head & (LOG_RING_SLOTS - 1)];
+    record->time_ns = wallNs();
+    record->level = level;
+    record->tag = tag;
+    va_start(args, format);
+    vsnprintf(record->message, sizeof(record->message), format, args);
+    va_end(args);
+    stripNewline(record->message);
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+// Move every queued record into buf (flushing it with write(2) as it fills).
+// Returns the number of records drained.
+static int drainRings(char* buf, size_t size) {
+    size_t used = 0;
+    int drained = 0;
+    uint64_t drops = 0;
+
+    for (log_ring_t* ring = __atomic_load_n(&rings, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+        uint32_t tail = ring->tail;
+        uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        for (; tail != head; tail++) {
+            const log_record_t* record = &ring->slots[tail & (LOG_RING_SLOTS - 1)];
+            if (size - used < LOG_LINE_MAX) {
+                writeAll(buf, used);
+                used = 0;
+            }
+            used += formatRecord(buf + used, size - used, record->time_ns, record->level, record->tag,
+                                 record->message);
+            drained++;
+        }
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+        drops += __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+    }
+
+    if (drops > reported_drops) {
+        char message[LOG_MSG_SIZE];
+        snprintf(message, sizeof(message), "%llu messages dropped (ring full)",
+                 (unsigned long long)(drops - reported_drops));
+        if (size - used < LOG_LINE_MAX) {
+            writeAll(buf, used);
+            used = 0;
+        }
+        used += formatRecord(buf + used, size - used, wallNs(), LOG_LEVEL_WARN, "Log", message);
+        reported_drops = drops;
+    }
+    writeAll(buf, used);
+    return drained;
+}
+
+static void* writerThread(void* arg) {
+    static char buf[LOG_WRITE_BUFFER];
+    const struct timespec idle = {0, LOG_FLUSH_INTERVAL_MS * 1000000L};
+    (void)arg;
+
+    while (!__atomic_load_n(&stopping, __ATOMIC_ACQUIRE)) {
+        if (drainRings(buf, sizeof(buf)) == 0) nanosleep(&idle, NULL);
+    }
+    drainRings(buf, sizeof(buf));
+    return NULL;
+}
+
+// The writer thread does not survive fork: children log synchronously
+static void afterForkChild(void) {
+    running = 0;
+}
+
+int log_init(void) {
+    if (running) return 0;
+    if (!registered) {
+        pthread_atfork(NULL, NULL, afterForkChild);
+        atexit(log_shutdown);
+        registered = 1;
+    }
+    stopping = 0;
+    if (pthread_create(&writer, NULL, writerThread, NULL) != 0) {
+        fprintf(stderr, "[Log] Warning: Cannot start the writer thread, logging synchronously\n");
+        return -1;
+    }
+    __atomic_store_n(&running, 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+void log_shutdown(void) {
+    if (!running) return;
+    __atomic_store_n(&running, 0, __ATOMIC_RELEASE); // New messages are written synchronously
+    __atomic_store_n(&stopping, 1, __ATOMIC_RELEASE);
+    pthread_join(writer, NULL); // The writer drains what is still queued
+}
+
+int log_parse_level(const char* name) {
+    for (int level = LOG_LEVEL_DEBUG; level <= LOG_LEVEL_OFF; level++) {
+        if (strcmp(name, level_names[level]) == 0) return level;
+    }
+    return -1;
+}
+
+void app_log(int level, const char* message) {
+    LOG_AT(level, "App", "%s", message);
+}
+
+void app_log_with_value(int level, const char* message, const char* format, ...) {
+    if (level < LOG_COMPILE_LEVEL || level < log_level) return;
+
+    char value[LOG_MSG_SIZE];
     va_list args;
     va_start(args, format);
-    vprintf(format, args);
+    vsnprintf(value, sizeof(value), format, args);
     va_end(args);
-    printf("\n");
-}
\ No newline at end of file
+    log_write(level, "App", "%s %s", message, value);
+}
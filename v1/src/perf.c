@@ -0,0 +1,153 @@
+// filepath: src/perf.c
+#include <stdio.h>
+#include <string.h>
+
+#include "../headers/perf.h"
+
+static perf_histogram_t stage_hist[PERF_STAGE_COUNT];
+static uint64_t start_ns = 0;
+
+static const char* const stage_names[PERF_STAGE_COUNT] = {
+    "exec", "fork", "write", "wait", "coverage", "save", "mutation"
+};
+
+// Bucket of a value: group 0 holds 0..SUB_COUNT-1 exactly; group g >= 1 covers
+// [SUB_COUNT << (g-1), SUB_COUNT << g) in SUB_COUNT buckets of 2^(g-1) ns
+static int bucketOf(uint64_t v) {
+    if (v < PERF_HIST_SUB_COUNT) return (int)v;
+    int msb = 63 - __builtin_clzll(v);
+    int group = msb - PERF_HIST_SUB_BITS + 1;
+    int sub = (int)((v >> (group - 1)) - PERF_HIST_SUB_COUNT);
+    return group * PERF_HIST_SUB_COUNT + sub;
+}
+
+// Largest value that falls in a bucket
+static uint64_t bucketUpperBound(int index) {
+    int group = index / PERF_HIST_SUB_COUNT;
+    int sub = index % PERF_HIST_SUB_COUNT;
+    if (group == 0) return (uint64_t)sub;
+    uint64_t lower = (uint64_t)(PERF_HIST_SUB_COUNT + sub) << (group - 1);
+    return lower + ((1ULL << (group - 1)) - 1);
+}
+
+void perf_histogram_reset(perf_histogram_t* hist) {
+    memset(hist, 0, sizeof(*hist));
+    hist->min_ns = UINT64_MAX;
+}
+
+// One writer (the fuzzing thread), readers on the stats thread: fields are
+// stored and loaded with relaxed atomics, so a reader never sees a torn value
+#define HIST_LOAD(field) __atomic_load_n(&(field), __ATOMIC_RELAXED)
+#define HIST_STORE(field, value) __atomic_store_n(&(field), (value), __ATOMIC_RELAXED)
+
+void perf_histogram_add(perf_histogram_t* hist, uint64_t ns) {
+    int b = bucketOf(ns);
+    HIST_STORE(hist->buckets[b], hist->buckets[b] + 1);
+    HIST_STORE(hist->count, hist->count + 1);
+    HIST_STORE(hist->total_ns, hist->total_ns + ns);
+    if (ns < hist->min_ns) HIST_STORE(hist->min_ns, ns);
+    if (ns > hist->max_ns) HIST_STORE(hist->max_ns, ns);
+}
+
+uint64_t perf_histogram_percentile(const perf_histogram_t* hist, double pct) {
+    uint64_t count = HIST_LOAD(hist->count);
+    uint64_t max_ns = HIST_LOAD(hist->max_ns);
+    if (count == 0) return 0;
+    if (pct <= 0.0) return HIST_LOAD(hist->min_ns);
+    if (pct >= 100.0) return max_ns;
+
+    uint64_t rank = (uint64_t)(pct / 100.0 * (double)count);
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < PERF_HIST_BUCKETS; i++) {
+        seen += HIST_LOAD(hist->buckets[i]);
+        if (seen >= rank) {
+            uint64_t upper = bucketUpperBound(i);
+            return upper < max_ns ? upper : max_ns;
+        }
+    }
+    return max_ns;
+}
+
+void perf_init(void) {
+    for (int s = 0; s < PERF_STAGE_COUNT; s++) {
+        perf_histogram_reset(&stage_hist[s]);
+    }
+    start_ns = perf_now_ns();
+}
+
+void perf_record(perf_stage_t stage, uint64_t ns) {
+    perf_histogram_add(&stage_hist[stage], ns);
+}
+
+const perf_histogram_t* perf_stage_histogram(perf_stage_t stage) {
+    return &stage_hist[stage];
+}
+
+const char* perf_stage_name(perf_stage_t stage) {
+    return stage_names[stage];
+}
+
+static double elapsedSeconds(void) {
+    if (start_ns == 0) return 0.0;
+    return (double)(perf_now_ns() - start_ns) / 1e9;
+}
+
+double perf_execs_per_sec(void) {
+    double elapsed = elapsedSeconds();
+    return elapsed > 0.0 ? (double)HIST_LOAD(stage_hist[PERF_STAGE_EXEC].count) / elapsed : 0.0;
+}
+
+// Share of the wall time spent in a stage (percent)
+static double stageShare(perf_stage_t stage, double elapsed) {
+    return elapsed > 0.0 ? (double)HIST_LOAD(stage_hist[stage].total_ns) / (elapsed * 1e7) : 0.0;
+}
+
+void perf_format_status(char* buf, size_t size) {
+    const perf_histogram_t* exec = &stage_hist[PERF_STAGE_EXEC];
+    double elapsed = elapsedSeconds();
+    int n = snprintf(buf, size, "%.1f execs/s, exec p50 %.2fms p99 %.2fms |",
+                     perf_execs_per_sec(),
+                     (double)perf_histogram_percentile(exec, 50.0) / 1e6,
+                     (double)perf_histogram_percentile(exec, 99.0) / 1e6);
+
+    for (int s = PERF_STAGE_FORK; s < PERF_STAGE_COUNT && n >= 0 && (size_t)n < size; s++) {
+        n += snprintf(buf + n, size - (size_t)n, " %s %.1f%%", stage_names[s], stageShare(s, elapsed));
+    }
+}
+
+void perf_write_csv_header(FILE* f) {
+    fprintf(f, ",ExecsPerSec,ExecP50Us,ExecP99Us");
+    for (int s = PERF_STAGE_FORK; s < PERF_STAGE_COUNT; s++) {
+        fprintf(f, ",%c%sPct", stage_names[s][0] - 'a' + 'A', stage_names[s] + 1);
+    }
+}
+
+void perf_write_csv_row(FILE* f) {
+    const perf_histogram_t* exec = &stage_hist[PERF_STAGE_EXEC];
+    double elapsed = elapsedSeconds();
+    fprintf(f, ",%.1f,%.1f,%.1f", perf_execs_per_sec(),
+            (double)perf_histogram_percentile(exec, 50.0) / 1e3,
+            (double)perf_histogram_percentile(exec, 99.0) / 1e3);
+    for (int s = PERF_STAGE_FORK; s < PERF_STAGE_COUNT; s++) {
+        fprintf(f, ",%.2f", stageShare(s, elapsed));
+    }
+}
+
+void perf_print_summary(void) {
+    double elapsed = elapsedSeconds();
+
+    printf("\n=== Performance (%.1fs, %.1f execs/s) ===\n", elapsed, perf_execs_per_sec());
+    printf("%-10s %10s %10s %10s %10s %10s %7s\n", "stage", "count", "mean(us)", "p50(us)", "p99(us)", "max(us)", "time%");
+    for (int s = 0; s < PERF_STAGE_COUNT; s++) {
+        const perf_histogram_t* h = &stage_hist[s];
+        if (h->count == 0) continue;
+        printf("%-10s %10llu %10.1f %10.1f %10.1f %10.1f %6.1f%%\n", stage_names[s],
+               (unsigned long long)h->count,
+               (double)h->total_ns / (double)h->count / 1e3,
+               (double)perf_histogram_percentile(h, 50.0) / 1e3,
+               (double)perf_histogram_percentile(h, 99.0) / 1e3,
+               (double)h->max_ns / 1e3,
+               stageShare(s, elapsed));
+    }
+}
@@ -0,0 +1,262 @@
+// filepath: src/pipeline.c
+#define _GNU_SOURCE // For syscall
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/shm.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+#include "../headers/pipeline.h"
+#include "../headers/target.h"
+#include "../headers/coverage.h"
+#include "../headers/perf.h"
+#include "../headers/logger.h"
+#include "../headers/directed.h"
+#include "../headers/execcache.h"
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
+static int pidfdOpen(pid_t pid) {
+    return (int)syscall(SYS_pidfd_open, pid, 0); // Close-on-exec by default
+}
+
+static shm_extra_t* slotExtra(const pipeline_slot_t* slot) {
+    return (shm_extra_t*)(slot->map + SHM_EXTRA_OFFSET);
+}
+
+static void failRun(exec_pipeline_t* pipeline, int index) {
+    exec_result_t* result = &pipeline->results[index];
+    result->status = FUZZER_EXEC_ERROR;
+    result->cov_hash = 0;
+    result->exec_us = 0;
+    result->cached = 0;
+    if (pipeline->maps[index]) memset(pipeline->maps[index], 0, COVERAGE_MAP_SIZE);
+    memset(pipeline->extras[index].bytes, 0, SHM_EXTRA_RUN_SIZE);
+    pipeline->done[index] = 1;
+}
+
+int exec_pipeline_start(exec_pipeline_t* pipeline, const char* exePath, int depth, unsigned int timeout_ms) {
+    memset(pipeline, 0, sizeof(*pipeline));
+    pipeline->exe_path = exePath;
+    pipeline->timeout_ms = timeout_ms;
+    pipeline->epoll_fd = -1;
+    for (int s = 0; s < PIPELINE_MAX_DEPTH; s++) pipeline->slots[s].shm_id = -1;
+    if (depth < 1) depth = 1;
+    if (depth > PIPELINE_MAX_DEPTH) depth = PIPELINE_MAX_DEPTH;
+
+    // pidfds need Linux 5.3: probe with our own pid
+    int probe = pidfdOpen(getpid());
+    if (probe < 0) {
+        LOG_W("Exec", "pidfd_open unavailable: %s", strerror(errno));
+        return -1;
+    }
+    close(probe);
+
+    pipeline->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (pipeline->epoll_fd < 0) {
+        LOG_E("Exec", "epoll_create1 failed: %s", strerror(errno));
+        return -1;
+    }
+
+    for (int s = 0; s < depth; s++) {
+        pipeline_slot_t* slot = &pipeline->slots[s];
+        slot->shm_id = shmget(IPC_PRIVATE, SHM_TOTAL_SIZE, IPC_CREAT | 0600);
+        if (slot->shm_id < 0) {
+            LOG_E("Exec", "shmget failed for pipeline slot %d: %s", s, strerror(errno));
+            exec_pipeline_stop(pipeline);
+            return -1;
+        }
+        slot->map = shmat(slot->shm_id, NULL, 0);
+        if (slot->map == (void*)-1) {
+            LOG_E("Exec", "shmat failed for pipeline slot %d: %s", s, strerror(errno));
+            slot->map = NULL;
+            exec_pipeline_stop(pipeline);
+            return -1;
+        }
+        // Removed now, freed on our last detach: Linux still lets the children
+        // attach by id, and nothing is left behind if the fuzzer is killed
+        shmctl(slot->shm_id, IPC_RMID, NULL);
+        memset(slot->map, 0, SHM_TOTAL_SIZE);
+        if (fuzz_shared_mem.extra) {
+            memcpy(&slotExtra(slot)->table, &fuzz_shared_mem.extra->table, sizeof(directed_table_t));
+        }
+        pipeline->depth++;
+    }
+    return 0;
+}
+
+int exec_pipeline_submit(exec_pipeline_t* pipeline, const int* inputs, int count, coverage_t* const* maps) {
+    if (count > PIPELINE_QUEUE_SIZE || pipeline->retired < pipeline->count) return -1;
+
+    pipeline->count = count;
+    pipeline->launched = 0;
+    pipeline->retired = 0;
+    for (int i = 0; i < count; i++) {
+        exec_result_t* result = &pipeline->results[i];
+        pipeline->inputs[i] = inputs[i];
+        pipeline->maps[i] = maps[i];
+        pipeline->done[i] = 0;
+        pipeline->verify[i] = 0;
+        // Runs the execution cache already knows are restored here instead of
+        // started, except the hits due for a determinism check
+        if (maps[i] && exec_cache_lookup(inputs[i], maps[i], pipeline->extras[i].bytes, &result->status,
+                                         &result->exec_us)) {
+            if (exec_cache_should_verify()) {
+                pipeline->verify[i] = 1;
+                continue;
+            }
+            result->cov_hash = coverage_path_hash(maps[i]);
+            result->cached = 1;
+            pipeline->done[i] = 1;
+        }
+    }
+    return 0;
+}
+
+// Start queued inputs on every free slot
+static void fillSlots(exec_pipeline_t* pipeline) {
+    for (int s = 0; s < pipeline->depth; s++) {
+        pipeline_slot_t* slot = &pipeline->slots[s];
+        if (slot->pid) continue;
+        while (pipeline->launched < pipeline->count && pipeline->done[pipeline->launched]) pipeline->launched++;
+        if (pipeline->launched >= pipeline->count) return;
+
+        int index = pipeline->launched++;
+        memset(slot->map, 0, COVERAGE_MAP_SIZE);
+        memset(slotExtra(slot), 0, SHM_EXTRA_RUN_SIZE); // Keeps the directed distance table
+
+        slot->start_ns = perf_now_ns();
+        pid_t pid = launch_target(pipeline->exe_path, pipeline->inputs[index], slot->shm_id);
+        if (pid < 0) {
+            failRun(pipeline, index);
+            continue;
+        }
+        int pidfd = pidfdOpen(pid);
+        struct epoll_event ev = {.events = EPOLLIN, .data.u32 = (uint32_t)s};
+        if (pidfd < 0 || epoll_ctl(pipeline->epoll_fd, EPOLL_CTL_ADD, pidfd, &ev) < 0) {
+            LOG_E("Exec", "Cannot watch target pid %d: %s", pid, strerror(errno));
+            if (pidfd >= 0) close(pidfd);
+            kill(pid, SIGKILL);
+            waitpid(pid, NULL, 0);
+            failRun(pipeline, index);
+            continue;
+        }
+        slot->pid = pid;
+        slot->pidfd = pidfd;
+        slot->index = index;
+        slot->deadline_ns = slot->start_ns + (uint64_t)pipeline->timeout_ms * 1000000ULL;
+    }
+}
+
+// Reap a slot's child (killing it first on timeout) and store its result
+static void finishSlot(exec_pipeline_t* pipeline, pipeline_slot_t* slot, int timed_out) {
+    int wait_status = 0;
+    int index = slot->index;
+    exec_result_t* result = &pipeline->results[index];
+
+    if (timed_out) kill(slot->pid, SIGKILL);
+    while (waitpid(slot->pid, &wait_status, 0) < 0 && errno == EINTR) {
+    }
+    uint64_t elapsed_ns = perf_now_ns() - slot->start_ns;
+    // Deregister explicitly: a child forked meanwhile may still hold a copy of
+    // the pidfd until it execs, and close alone would leave it in the epoll set
+    epoll_ctl(pipeline->epoll_fd, EPOLL_CTL_DEL, slot->pidfd, NULL);
+    close(slot->pidfd);
+    slot->pid = 0;
+
+    result->status = timed_out ? -SIGALRM : decode_target_status(wait_status, slotExtra(slot));
+    result->exec_us = (unsigned int)(elapsed_ns / 1000);
+    result->cov_hash = coverage_path_hash(slot->map);
+    result->cached = 0;
+    if (pipeline->maps[index]) memcpy(pipeline->maps[index], slot->map, COVERAGE_MAP_SIZE);
+    memcpy(pipeline->extras[index].bytes, slotExtra(slot), SHM_EXTRA_RUN_SIZE);
+    if (pipeline->verify[index]) {
+        exec_cache_verify(pipeline->inputs[index], pipeline->maps[index], result->status);
+    } else if (pipeline->maps[index]) {
+        exec_cache_insert(pipeline->inputs[index], pipeline->maps[index], slotExtra(slot), result->status,
+                          result->exec_us);
+    }
+    pipeline->done[index] = 1;
+}
+
+// Block until at least one child exits or reaches its deadline
+static void waitForChildren(exec_pipeline_t* pipeline) {
+    struct epoll_event events[PIPELINE_MAX_DEPTH];
+    uint64_t now = perf_now_ns();
+    uint64_t earliest = UINT64_MAX;
+    for (int s = 0; s < pipeline->depth; s++) {
+        if (pipeline->slots[s].pid && pipeline->slots[s].deadline_ns < earliest) {
+            earliest = pipeline->slots[s].deadline_ns;
+        }
+    }
+    if (earliest == UINT64_MAX) return; // Nothing running
+
+    int timeout = earliest > now ? (int)((earliest - now + 999999) / 1000000) : 0;
+    uint64_t stage_start = now;
+    int n = epoll_wait(pipeline->epoll_fd, events, pipeline->depth, timeout);
+    perf_record_since(PERF_STAGE_WAIT, stage_start);
+    if (n < 0 && errno != EINTR) {
+        LOG_E("Exec", "epoll_wait failed: %s", strerror(errno));
+    }
+    for (int e = 0; e < n; e++) {
+        pipeline_slot_t* slot = &pipeline->slots[events[e].data.u32];
+        if (slot->pid) finishSlot(pipeline, slot, 0);
+    }
+
+    now = perf_now_ns();
+    for (int s = 0; s < pipeline->depth; s++) {
+        pipeline_slot_t* slot = &pipeline->slots[s];
+        if (slot->pid && now >= slot->deadline_ns) {
+            LOG_D("Exec", "Timeout (PID: %d)", slot->pid);
+            finishSlot(pipeline, slot, 1);
+        }
+    }
+}
+
+int exec_pipeline_next(exec_pipeline_t* pipeline, exec_result_t* result, exec_run_extra_t* extra) {
+    if (pipeline->retired >= pipeline->count) return -1;
+
+    int index = pipeline->retired;
+    fillSlots(pipeline);
+    while (!pipeline->done[index]) {
+        waitForChildren(pipeline);
+        fillSlots(pipeline);
+    }
+    *result = pipeline->results[index];
+    if (extra) *extra = pipeline->extras[index];
+    pipeline->retired++;
+    return index;
+}
+
+void exec_pipeline_sync_directed(exec_pipeline_t* pipeline) {
+    for (int s = 0; s < pipeline->depth; s++) {
+        directed_sync_table(slotExtra(&pipeline->slots[s]));
+    }
+}
+
+void exec_pipeline_stop(exec_pipeline_t* pipeline) {
+    for (int s = 0; s < PIPELINE_MAX_DEPTH; s++) {
+        pipeline_slot_t* slot = &pipeline->slots[s];
+        if (slot->pid) {
+            kill(slot->pid, SIGKILL);
+            waitpid(slot->pid, NULL, 0);
+            close(slot->pidfd);
+            slot->pid = 0;
+        }
+        if (slot->map) shmdt(slot->map);
+        else if (slot->shm_id >= 0) shmctl(slot->shm_id, IPC_RMID, NULL); // Created but never attached
+        slot->map = NULL;
+        slot->shm_id = -1;
+    }
+    if (pipeline->epoll_fd >= 0) close(pipeline->epoll_fd);
+    pipeline->epoll_fd = -1;
+    pipeline->depth = 0;
+    pipeline->count = pipeline->retired = 0;
+}
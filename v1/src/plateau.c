@@ -0,0 +1,83 @@
+// filepath: src/plateau.c
+#include <stdio.h>
+
+#include "../headers/plateau.h"
+#include "../headers/fuzz.h"
+#include "../headers/corpus.h"
+#include "../headers/logger.h"
+
+static plateau_level_t level = PLATEAU_LEVEL_DEFAULT;
+static uint64_t switches = 0;
+static uint64_t window_start = 0; // Execs at the last new edge or escalation
+static int last_edges = -1;
+static plateau_level_t peak_level = PLATEAU_LEVEL_DEFAULT;
+
+static const char* const strategy_names[PLATEAU_LEVEL_COUNT] = {
+    "default", "dictionary", "deep-havoc", "rare-selection", "ga-reseed", "widen-range"};
+
+// Set the mutation and selection knobs for a level
+static void applyLevel(plateau_level_t l) {
+    setHavocStrategy(l >= PLATEAU_LEVEL_DEEP_HAVOC ? PLATEAU_HAVOC_STACK : HAVOC_DEFAULT_STACK,
+                     l >= PLATEAU_LEVEL_DICTIONARY ? PLATEAU_DICTIONARY_PCT : HAVOC_DEFAULT_DICTIONARY_PCT);
+    setCorpusRareBias(l >= PLATEAU_LEVEL_RARE_SELECTION);
+}
+
+static void switchTo(plateau_level_t l, uint64_t execs) {
+    if (l != level) {
+        LOG_I("Plateau", "%s after %llu execs: strategy %s -> %s", l > level ? "Plateau" : "Progress",
+              (unsigned long long)execs, strategy_names[level], strategy_names[l]);
+        applyLevel(l);
+        __atomic_store_n(&level, l, __ATOMIC_RELAXED); // Read by the stats thread
+    }
+    __atomic_store_n(&switches, switches + 1, __ATOMIC_RELAXED);
+    if (l > peak_level) peak_level = l;
+}
+
+void plateau_start(void) {
+    level = PLATEAU_LEVEL_DEFAULT;
+    switches = 0;
+    window_start = 0;
+    last_edges = -1;
+    peak_level = PLATEAU_LEVEL_DEFAULT;
+    applyLevel(level);
+}
+
+int plateau_update(uint64_t execs, int edges) {
+    if (edges > last_edges) {
+        if (last_edges >= 0 && level > PLATEAU_LEVEL_DEFAULT) switchTo(level - 1, execs);
+        last_edges = edges;
+        window_start = execs;
+        return 0;
+    }
+    if (execs - window_start < PLATEAU_WINDOW_EXECS) return 0;
+
+    window_start = execs;
+    plateau_level_t next = level < PLATEAU_LEVEL_WIDEN_RANGE ? level + 1 : level;
+    if (next == level) {
+        LOG_I("Plateau", "Plateau after %llu execs: repeating %s", (unsigned long long)execs, strategy_names[level]);
+    }
+    switchTo(next, execs);
+
+    int actions = 0;
+    if (next >= PLATEAU_LEVEL_GA_RESEED) actions |= PLATEAU_ACTION_RESEED_GA;
+    if (next >= PLATEAU_LEVEL_WIDEN_RANGE) actions |= PLATEAU_ACTION_WIDEN_RANGE;
+    return actions;
+}
+
+plateau_level_t plateau_level(void) {
+    return __atomic_load_n(&level, __ATOMIC_RELAXED);
+}
+
+uint64_t plateau_switches(void) {
+    return __atomic_load_n(&switches, __ATOMIC_RELAXED);
+}
+
+const char* plateau_strategy_name(plateau_level_t l) {
+    return l < PLATEAU_LEVEL_COUNT ? strategy_names[l] : "unknown";
+}
+
+void plateau_print_summary(void) {
+    if (switches == 0) return;
+    printf("Plateau strategy: %llu switches, highest %s, ended on %s\n", (unsigned long long)switches,
+           strategy_names[peak_level], strategy_names[level]);
+}
@@ -0,0 +1,256 @@
+// filepath: src/stats.c
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "../headers/stats.h"
+#include "../headers/perf.h"
+#include "../headers/directed.h"
+#include "../headers/execcache.h"
+#include "../headers/calibrate.h"
+#include "../headers/coverage.h"
+#include "../headers/campaign.h"
+#include "../headers/plateau.h"
+
+fuzz_stats_t fuzz_stats;
+
+static stats_config_t config;
+static FILE* progress_file = NULL;
+static pthread_t thread;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wakeup = PTHREAD_COND_INITIALIZER;
+static int running = 0;
+static int stopping = 0;
+
+static uint64_t start_ns = 0;
+static time_t start_time = 0;
+static uint64_t last_file_ns = 0;
+static uint64_t last_find_ns = 0; // Last tick at which the edge count grew
+static uint64_t seen_edges = 0;
+
+// The reporting thread only reads: the counters with relaxed loads, the perf
+// histograms as they are (a status line may mix two neighbouring iterations)
+static fuzz_stats_t snapshotCounters(void) {
+    fuzz_stats_t s;
+    s.iterations = __atomic_load_n(&fuzz_stats.iterations, __ATOMIC_RELAXED);
+    s.edges = __atomic_load_n(&fuzz_stats.edges, __ATOMIC_RELAXED);
+    s.corpus_size = __atomic_load_n(&fuzz_stats.corpus_size, __ATOMIC_RELAXED);
+    s.crashes = __atomic_load_n(&fuzz_stats.crashes, __ATOMIC_RELAXED);
+    s.timeouts = __atomic_load_n(&fuzz_stats.timeouts, __ATOMIC_RELAXED);
+    return s;
+}
+
+static void printStatusLine(const fuzz_stats_t* s, double elapsed) {
+    char perf_status[256];
+    perf_format_status(perf_status, sizeof(perf_status));
+    printf("[Stats] %.0fs: iter %llu, cov %llu, corpus %llu, crashes %llu, timeouts %llu",
+           elapsed, (unsigned long long)s->iterations, (unsigned long long)s->edges,
+           (unsigned long long)s->corpus_size, (unsigned long long)s->crashes,
+           (unsigned long long)s->timeouts);
+    if (directed_enabled()) {
+        printf(", labels %d/%d", directed_label_count() - directed_target_count(), directed_label_count());
+    }
+    printf(", %s\n", perf_status);
+    fflush(stdout);
+}
+
+static void drawDashboard(const fuzz_stats_t* s, double elapsed, int final) {
+    const perf_histogram_t* exec = perf_stage_histogram(PERF_STAGE_EXEC);
+    double since_find = last_find_ns ? (double)(perf_now_ns() - last_find_ns) / 1e9 : elapsed;
+
+    printf("\033[H\033[2J"); // Home + clear screen
+    printf("=== fuzzer (%s) %s===\n\n", config.mode, final ? "- finished " : "");
+    printf("  run time       : %.0fs\n", elapsed);
+    printf("  iterations     : %llu\n", (unsigned long long)s->iterations);
+    if (config.planned_execs) {
+        printf("  execs          : %llu / %llu (%.1f/s)\n", (unsigned long long)campaign_execs(),
+               (unsigned long long)config.planned_execs, perf_execs_per_sec());
+    } else {
+        printf("  execs          : %llu (%.1f/s)\n", (unsigned long long)campaign_execs(), perf_execs_per_sec());
+    }
+    printf("  exec latency   : p50 %.2fms, p99 %.2fms\n",
+           (double)perf_histogram_percentile(exec, 50.0) / 1e6,
+           (double)perf_histogram_percentile(exec, 99.0) / 1e6);
+    exec_cache_stats_t cache = exec_cache_stats();
+    printf("  cache hits     : %llu (%.1f%%)\n", (unsigned long long)cache.hits,
+           cache.lookups ? 100.0 * (double)cache.hits / (double)cache.lookups : 0.0);
+    printf("\n");
+    printf("  edges          : %llu\n", (unsigned long long)s->edges);
+    printf("  stability      : %.2f%% (%d variable edges)\n", coverage_stability(), coverage_variable_edges());
+    printf("  corpus         : %llu\n", (unsigned long long)s->corpus_size);
+    printf("  last new edge  : %.0fs ago\n", since_find);
+    printf("  strategy       : %s (%llu switches)\n", plateau_strategy_name(plateau_level()),
+           (unsigned long long)plateau_switches());
+    printf("  crashes        : %llu\n", (unsigned long long)s->crashes);
+    printf("  timeouts       : %llu\n", (unsigned long long)s->timeouts);
+    if (directed_enabled()) {
+        printf("  labels reached : %d / %d\n", directed_label_count() - directed_target_count(),
+               directed_label_count());
+    }
+    printf("\n  stage time     :");
+    for (int st = PERF_STAGE_FORK; st < PERF_STAGE_COUNT; st++) {
+        const perf_histogram_t* h = perf_stage_histogram(st);
+        printf(" %s %.1f%%", perf_stage_name(st),
+               elapsed > 0.0 ? (double)__atomic_load_n(&h->total_ns, __ATOMIC_RELAXED) / (elapsed * 1e7) : 0.0);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+static void writeProgressRow(const fuzz_stats_t* s) {
+    if (!progress_file) return;
+    fprintf(progress_file, "%llu,%llu,%s,%llu,%llu,%llu", (unsigned long long)s->iterations,
+            (unsigned long long)s->edges, config.mode, (unsigned long long)s->corpus_size,
+            (unsigned long long)s->crashes, (unsigned long long)s->timeouts);
+    perf_write_csv_row(progress_file);
+    fprintf(progress_file, "\n");
+    fflush(progress_file);
+}
+
+// key: value snapshot, written to a temporary file and renamed over the old one
+// so readers never see a partial file
+static void writeSnapshot(const fuzz_stats_t* s, double elapsed) {
+    if (!config.snapshot_path) return;
+
+    char tmp_path[4096];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", config.snapshot_path);
+    FILE* f = fopen(tmp_path, "we"); // Close-on-exec: targets must not inherit it
+    if (!f) return;
+
+    const perf_histogram_t* exec = perf_stage_histogram(PERF_STAGE_EXEC);
+    fprintf(f, "start_time        : %lld\n", (long long)start_time);
+    fprintf(f, "last_update       : %lld\n", (long long)time(NULL));
+    fprintf(f, "run_time          : %.0f\n", elapsed);
+    fprintf(f, "fuzzer_pid        : %d\n", (int)getpid());
+    fprintf(f, "mode              : %s\n", config.mode);
+    fprintf(f, "iterations        : %llu\n", (unsigned long long)s->iterations);
+    fprintf(f, "execs_done        : %llu\n", (unsigned long long)campaign_execs());
+    fprintf(f, "execs_per_sec     : %.1f\n", perf_execs_per_sec());
+    fprintf(f, "exec_p50_us       : %.1f\n", (double)perf_histogram_percentile(exec, 50.0) / 1e3);
+    fprintf(f, "exec_p99_us       : %.1f\n", (double)perf_histogram_percentile(exec, 99.0) / 1e3);
+    exec_cache_stats_t cache = exec_cache_stats();
+    fprintf(f, "cache_lookups     : %llu\n", (unsigned long long)cache.lookups);
+    fprintf(f, "cache_hits        : %llu\n", (unsigned long long)cache.hits);
+    fprintf(f, "cache_hit_rate    : %.1f%%\n",
+            cache.lookups ? 100.0 * (double)cache.hits / (double)cache.lookups : 0.0);
+    fprintf(f, "edges_found       : %llu\n", (unsigned long long)s->edges);
+    fprintf(f, "variable_edges    : %d\n", coverage_variable_edges());
+    fprintf(f, "stability         : %.2f%%\n", coverage_stability());
+    fprintf(f, "calibration_execs : %llu\n", (unsigned long long)calibration_stats().execs);
+    fprintf(f, "corpus_count      : %llu\n", (unsigned long long)s->corpus_size);
+    fprintf(f, "last_find         : %lld\n",
+            last_find_ns ? (long long)start_time + (long long)((last_find_ns - start_ns) / 1000000000ULL) : 0LL);
+    fprintf(f, "plateau_level     : %d\n", (int)plateau_level());
+    fprintf(f, "last_strategy     : %s\n", plateau_strategy_name(plateau_level()));
+    fprintf(f, "strategy_switches : %llu\n", (unsigned long long)plateau_switches());
+    fprintf(f, "unique_crashes    : %llu\n", (unsigned long long)s->crashes);
+    fprintf(f, "timeouts          : %llu\n", (unsigned long long)s->timeouts);
+    if (directed_enabled()) {
+        fprintf(f, "labels_reached    : %d\n", directed_label_count() - directed_target_count());
+        fprintf(f, "labels_total      : %d\n", directed_label_count());
+    }
+    if (campaign_stop_reason()) fprintf(f, "stop_reason       : %s\n", campaign_stop_reason());
+    if (fclose(f) != 0 || rename(tmp_path, config.snapshot_path) != 0) {
+        unlink(tmp_path);
+    }
+}
+
+// One reporting tick: console always, files every STATS_FILE_INTERVAL_MS
+static void tick(int final) {
+    fuzz_stats_t s = snapshotCounters();
+    uint64_t now = perf_now_ns();
+    double elapsed = (double)(now - start_ns) / 1e9;
+
+    if (s.edges > seen_edges) {
+        seen_edges = s.edges;
+        last_find_ns = now;
+    }
+
+    if (config.dashboard) drawDashboard(&s, elapsed, final);
+    else printStatusLine(&s, elapsed);
+
+    if (final || now - last_file_ns >= (uint64_t)STATS_FILE_INTERVAL_MS * 1000000ULL) {
+        writeProgressRow(&s);
+        writeSnapshot(&s, elapsed);
+        last_file_ns = now;
+    }
+}
+
+static void* statsThread(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&lock);
+    while (!stopping) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += STATS_RENDER_INTERVAL_MS / 1000;
+        deadline.tv_nsec += (long)(STATS_RENDER_INTERVAL_MS % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        // Sleep a full interval unless stats_stop wakes us early
+        int rc = 0;
+        while (!stopping && rc != ETIMEDOUT) {
+            rc = pthread_cond_timedwait(&wakeup, &lock, &deadline);
+        }
+        if (stopping) break;
+
+        pthread_mutex_unlock(&lock);
+        tick(0);
+        pthread_mutex_lock(&lock);
+    }
+    pthread_mutex_unlock(&lock);
+    return NULL;
+}
+
+int stats_start(const stats_config_t* cfg) {
+    config = *cfg;
+    memset(&fuzz_stats, 0, sizeof(fuzz_stats));
+    start_ns = perf_now_ns();
+    start_time = time(NULL);
+    last_file_ns = start_ns;
+    last_find_ns = 0;
+    seen_edges = 0;
+
+    if (config.dashboard && !isatty(STDOUT_FILENO)) {
+        fprintf(stderr, "[Stats] stdout is not a terminal, printing status lines instead of the dashboard\n");
+        config.dashboard = 0;
+    }
+
+    if (config.progress_path) {
+        progress_file = fopen(config.progress_path, "ae"); // Append mode, close-on-exec
+        if (progress_file && ftell(progress_file) == 0) { // Header only if the file is new/empty
+            fprintf(progress_file, "Iteration,Coverage,Mode,CorpusSize,Crashes,Timeouts");
+            perf_write_csv_header(progress_file);
+            fprintf(progress_file, "\n");
+        }
+    }
+
+    stopping = 0;
+    if (pthread_create(&thread, NULL, statsThread, NULL) != 0) {
+        fprintf(stderr, "[Stats] Error: Cannot start the reporting thread\n");
+        if (progress_file) fclose(progress_file);
+        progress_file = NULL;
+        return -1;
+    }
+    running = 1;
+    return 0;
+}
+
+void stats_stop(void) {
+    if (!running) return;
+
+    pthread_mutex_lock(&lock);
+    stopping = 1;
+    pthread_cond_signal(&wakeup);
+    pthread_mutex_unlock(&lock);
+    pthread_join(thread, NULL);
+    running = 0;
+
+    tick(1);
+    if (progress_file) fclose(progress_file);
+    progress_file = NULL;
+}
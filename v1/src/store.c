@@ -0,0 +1,378 @@
+// filepath: src/store.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "../headers/store.h"
+#include "../headers/hash.h"
+
+// Segment file header
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t reserved;
+} store_segment_header_t;
+
+// Header written in front of every record in the segment
+typedef struct {
+    uint32_t magic;
+    uint32_t length;
+    uint64_t hash;
+} store_record_header_t;
+
+#define STORE_ALIGN(x) (((x) + 7) & ~(uint64_t)7)
+
+// Hash of the record data
+static uint64_t store_hash(const void *data, size_t length) {
+    return hash64(data, length, 0);
+}
+
+// Write the whole buffer at 'offset', retrying on short writes
+static int pwrite_all(int fd, const void *buf, size_t len, off_t offset) {
+    const uint8_t *p = (const uint8_t *)buf;
+    while (len > 0) {
+        ssize_t n = pwrite(fd, p, len, offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+        offset += n;
+    }
+    return 0;
+}
+
+// Is index entry 'e' backed by a complete, matching record in the segment?
+static int record_is_valid(const corpus_store_t *store, const store_index_entry_t *e, uint64_t seg_size) {
+    if (e->offset < sizeof(store_segment_header_t) + sizeof(store_record_header_t)) return 0;
+    if (e->offset + e->length > seg_size || e->offset + e->length < e->offset) return 0;
+
+    const store_record_header_t *rec =
+        (const store_record_header_t *)(store->map + e->offset - sizeof(store_record_header_t));
+    if (rec->magic != STORE_RECORD_MAGIC || rec->length != e->length || rec->hash != e->hash) return 0;
+
+    return store_hash(store->map + e->offset, e->length) == e->hash;
+}
+
+// Load the index and drop any torn tail left behind by a crash
+static int store_recover(corpus_store_t *store, uint64_t seg_size) {
+    struct stat st;
+    if (fstat(store->idx_fd, &st) != 0) {
+        perror("Store Error: fstat(index) failed");
+        return -1;
+    }
+
+    size_t on_disk = (size_t)st.st_size / sizeof(store_index_entry_t);
+    if (on_disk > 0) {
+        store->entries = malloc(on_disk * sizeof(store_index_entry_t));
+        if (!store->entries) {
+            fprintf(stderr, "Store Error: Failed to allocate index (%zu entries)\n", on_disk);
+            return -1;
+        }
+        store->capacity = on_disk;
+        if (pread(store->idx_fd, store->entries, on_disk * sizeof(store_index_entry_t), 0) !=
+            (ssize_t)(on_disk * sizeof(store_index_entry_t))) {
+            perror("Store Error: Failed to read index");
+            return -1;
+        }
+    }
+
+    // Entries are appended in segment order, so the first bad one marks the torn tail
+    store->seg_end = sizeof(store_segment_header_t);
+    store->count = 0;
+    while (store->count < on_disk && record_is_valid(store, &store->entries[store->count], seg_size)) {
+        const store_index_entry_t *e = &store->entries[store->count];
+        store->seg_end = STORE_ALIGN(e->offset + e->length);
+        store->count++;
+    }
+
+    if (store->count != on_disk || (uint64_t)st.st_size != on_disk * sizeof(store_index_entry_t)) {
+        fprintf(stderr, "Store Warning: Dropping torn index tail (%zu invalid entries, %zu stray bytes)\n",
+                on_disk - store->count, (size_t)st.st_size % sizeof(store_index_entry_t));
+        if (ftruncate(store->idx_fd, (off_t)(store->count * sizeof(store_index_entry_t))) != 0) {
+            perror("Store Error: Failed to truncate index");
+            return -1;
+        }
+    }
+    if (seg_size > store->seg_end && ftruncate(store->seg_fd, (off_t)store->seg_end) != 0) {
+        perror("Store Error: Failed to truncate segment");
+        return -1;
+    }
+    return 0;
+}
+
+// Open (or create) the store
+int store_open(corpus_store_t *store, const char *dir) {
+    char path[PATH_MAX];
+    struct stat st;
+
+    memset(store, 0, sizeof(*store));
+    store->seg_fd = -1;
+    store->idx_fd = -1;
+    snprintf(store->dir, sizeof(store->dir), "%s", dir);
+
+    if (mkdir(dir, 0755) == -1 && errno != EEXIST) {
+        fprintf(stderr, "Store Error: Failed to create directory %s: %s\n", dir, strerror(errno));
+        return -1;
+    }
+
+    snprintf(path, sizeof(path), "%s/%s", dir, STORE_SEGMENT_FILE);
+    store->seg_fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (store->seg_fd < 0) {
+        fprintf(stderr, "Store Error: Failed to open %s: %s\n", path, strerror(errno));
+        goto fail;
+    }
+
+    snprintf(path, sizeof(path), "%s/%s", dir, STORE_INDEX_FILE);
+    store->idx_fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (store->idx_fd < 0) {
+        fprintf(stderr, "Store Error: Failed to open %s: %s\n", path, strerror(errno));
+        goto fail;
+    }
+
+    if (fstat(store->seg_fd, &st) != 0) {
+        perror("Store Error: fstat(segment) failed");
+        goto fail;
+    }
+
+    store_segment_header_t header;
+    if (st.st_size == 0) {
+        // Fresh store: write the segment header and start with an empty index
+        header.magic = STORE_SEGMENT_MAGIC;
+        header.version = STORE_VERSION;
+        header.reserved = 0;
+        if (pwrite_all(store->seg_fd, &header, sizeof(header), 0) != 0 || ftruncate(store->idx_fd, 0) != 0) {
+            perror("Store Error: Failed to initialise segment");
+            goto fail;
+        }
+        st.st_size = sizeof(header);
+    } else if (pread(store->seg_fd, &header, sizeof(header), 0) != sizeof(header) ||
+               header.magic != STORE_SEGMENT_MAGIC || header.version != STORE_VERSION) {
+        fprintf(stderr, "Store Error: %s/%s is not a version %d store segment\n", dir, STORE_SEGMENT_FILE, STORE_VERSION);
+        goto fail;
+    }
+
+    store->map = mmap(NULL, STORE_MAX_SEGMENT_SIZE, PROT_READ, MAP_SHARED, store->seg_fd, 0);
+    if (store->map == MAP_FAILED) {
+        perror("Store Error: mmap(segment) failed");
+        store->map = NULL;
+        goto fail;
+    }
+
+    if (store_recover(store, (uint64_t)st.st_size) != 0) {
+        goto fail;
+    }
+
+    printf("Fuzzer Info: Opened corpus store %s (%zu records, %llu bytes)\n",
+           dir, store->count, (unsigned long long)store->seg_end);
+    return 0;
+
+fail:
+    store_close(store);
+    return -1;
+}
+
+// Close the store
+void store_close(corpus_store_t *store) {
+    if (store->map) {
+        munmap(store->map, STORE_MAX_SEGMENT_SIZE);
+        store->map = NULL;
+    }
+    if (store->seg_fd >= 0) {
+        close(store->seg_fd);
+        store->seg_fd = -1;
+    }
+    if (store->idx_fd >= 0) {
+        close(store->idx_fd);
+        store->idx_fd = -1;
+    }
+    free(store->entries);
+    store->entries = NULL;
+    store->count = 0;
+    store->capacity = 0;
+}
+
+// Append a record: data first, then its index entry
+long store_append(corpus_store_t *store, store_kind_t kind, const void *data, uint32_t length,
+                  const store_index_entry_t *meta) {
+    if (!store->map || (!data && length > 0)) {
+        return -1;
+    }
+
+    store_record_header_t rec;
+    rec.magic = STORE_RECORD_MAGIC;
+    rec.length = length;
+    rec.hash = store_hash(data, length);
+
+    uint64_t rec_off = store->seg_end;
+    uint64_t data_off = rec_off + sizeof(rec);
+    uint64_t new_end = STORE_ALIGN(data_off + length);
+    if (new_end > STORE_MAX_SEGMENT_SIZE) {
+        fprintf(stderr, "Store Error: Segment full (%llu bytes)\n", (unsigned long long)store->seg_end);
+        return -1;
+    }
+
+    static const uint8_t padding[8] = {0};
+    if (pwrite_all(store->seg_fd, &rec, sizeof(rec), (off_t)rec_off) != 0 ||
+        pwrite_all(store->seg_fd, data, length, (off_t)data_off) != 0 ||
+        pwrite_all(store->seg_fd, padding, new_end - (data_off + length), (off_t)(data_off + length)) != 0) {
+        perror("Store Error: Failed to append record");
+        return -1;
+    }
+
+    // Findings are rare and valuable: make sure they hit the disk before the index says so
+    if (kind == STORE_KIND_CRASH || kind == STORE_KIND_TIMEOUT) {
+        fdatasync(store->seg_fd);
+    }
+
+    if (store->count == store->capacity) {
+        size_t new_capacity = store->capacity ? store->capacity * 2 : 256;
+        store_index_entry_t *grown = realloc(store->entries, new_capacity * sizeof(store_index_entry_t));
+        if (!grown) {
+            fprintf(stderr, "Store Error: Failed to grow index\n");
+            return -1;
+        }
+        store->entries = grown;
+        store->capacity = new_capacity;
+    }
+
+    store_index_entry_t *e = &store->entries[store->count];
+    if (meta) {
+        *e = *meta;
+    } else {
+        memset(e, 0, sizeof(*e));
+    }
+    e->offset = data_off;
+    e->length = length;
+    e->kind = (uint32_t)kind;
+    e->hash = rec.hash;
+    e->timestamp = (int64_t)time(NULL);
+
+    if (write(store->idx_fd, e, sizeof(*e)) != (ssize_t)sizeof(*e)) {
+        perror("Store Error: Failed to append index entry");
+        return -1;
+    }
+
+    store->seg_end = new_end;
+    return (long)store->count++;
+}
+
+// Zero-copy record access
+const uint8_t *store_get(const corpus_store_t *store, size_t index, uint32_t *length) {
+    if (index >= store->count) {
+        return NULL;
+    }
+    if (length) {
+        *length = store->entries[index].length;
+    }
+    return store->map + store->entries[index].offset;
+}
+
+const store_index_entry_t *store_entry(const corpus_store_t *store, size_t index) {
+    return index < store->count ? &store->entries[index] : NULL;
+}
+
+size_t store_count(const corpus_store_t *store) {
+    return store->count;
+}
+
+// Write one file. Inputs and findings are never overwritten; metadata is
+// (a later sidecar record for the same input supersedes the earlier one).
+static int export_file(const char *path, const uint8_t *data, uint32_t length, int overwrite) {
+    int fd = open(path, O_WRONLY | O_CREAT | (overwrite ? O_TRUNC : O_EXCL), 0644);
+    if (fd < 0) {
+        return -1;
+    }
+    int ok = pwrite_all(fd, data, length, 0) == 0;
+    ok = (close(fd) == 0) && ok;
+    return ok ? 0 : -1;
+}
+
+// Export to the per-file directory layout
+int store_export(const corpus_store_t *store, const char *out_dir) {
+    static const char *subdirs[] = { "corpus", "crashes", "timeouts" };
+    char path[PATH_MAX];
+    int written = 0;
+    int corpus_n = 0;
+
+    if (mkdir(out_dir, 0755) == -1 && errno != EEXIST) {
+        fprintf(stderr, "Store Error: Failed to create %s: %s\n", out_dir, strerror(errno));
+        return -1;
+    }
+    for (size_t i = 0; i < sizeof(subdirs) / sizeof(subdirs[0]); i++) {
+        snprintf(path, sizeof(path), "%s/%s", out_dir, subdirs[i]);
+        if (mkdir(path, 0755) == -1 && errno != EEXIST) {
+            fprintf(stderr, "Store Error: Failed to create %s: %s\n", path, strerror(errno));
+            return -1;
+        }
+    }
+
+    // Ordinal of each corpus record, so metadata records can name their input file
+    int *corpus_ordinal = calloc(store->count ? store->count : 1, sizeof(int));
+    uint8_t *superseded = calloc(store->count ? store->count : 1, 1);
+    if (!corpus_ordinal || !superseded) {
+        fprintf(stderr, "Store Error: Failed to allocate export table\n");
+        free(corpus_ordinal);
+        free(superseded);
+        return -1;
+    }
+    for (size_t i = 0; i < store->count; i++) {
+        const store_index_entry_t *e = &store->entries[i];
+        if (e->kind == STORE_KIND_SUPERSEDED && e->ref < i) superseded[e->ref] = 1;
+    }
+
+    for (size_t i = 0; i < store->count; i++) {
+        const store_index_entry_t *e = &store->entries[i];
+        const uint8_t *data = store->map + e->offset;
+        const store_index_entry_t *target;
+        char value_buf[32];
+        size_t n = e->length < sizeof(value_buf) - 1 ? e->length : sizeof(value_buf) - 1;
+
+        switch (e->kind) {
+        case STORE_KIND_CORPUS:
+            corpus_ordinal[i] = ++corpus_n;
+            snprintf(path, sizeof(path), "%s/corpus/input_%d_%lld",
+                     out_dir, corpus_n, (long long)e->timestamp);
+            break;
+        case STORE_KIND_CORPUS_META:
+            target = store_entry(store, e->ref);
+            if (!target || target->kind != STORE_KIND_CORPUS || e->ref >= i) continue; // Orphaned metadata
+            snprintf(path, sizeof(path), "%s/corpus/input_%d_%lld.meta",
+                     out_dir, corpus_ordinal[e->ref], (long long)target->timestamp);
+            break;
+        case STORE_KIND_CRASH:
+        case STORE_KIND_TIMEOUT:
+            if (superseded[i]) continue; // Replaced by a simpler reproducer
+            memcpy(value_buf, data, n);
+            value_buf[n] = '\0';
+            snprintf(path, sizeof(path), "%s/%s/finding_%d_%016llx", out_dir,
+                     e->kind == STORE_KIND_CRASH ? "crashes" : "timeouts",
+                     atoi(value_buf), (unsigned long long)hash_finding(atoi(value_buf), e->kind == STORE_KIND_TIMEOUT));
+            break;
+        case STORE_KIND_SUPERSEDED:
+            continue;
+        default:
+            fprintf(stderr, "Store Warning: Skipping record %zu of unknown kind %u\n", i, e->kind);
+            continue;
+        }
+
+        if (export_file(path, data, e->length, e->kind == STORE_KIND_CORPUS_META) != 0) {
+            fprintf(stderr, "Store Warning: Failed to export %s: %s\n", path, strerror(errno));
+            continue;
+        }
+        written++;
+    }
+
+    free(corpus_ordinal);
+    free(superseded);
+    printf("Exported %d files from store %s to %s\n", written, store->dir, out_dir);
+    return written;
+}
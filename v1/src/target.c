@@ -1,5 +1,5 @@
 // filepath: src/target.c
-#define _GNU_SOURCE // For pipe2, kill, readlink
+#define _GNU_SOURCE // For pipe2, dup3, kill, readlink
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -11,12 +11,28 @@
 #include <fcntl.h> // For pipe2 flags, O_WRONLY, O_CLOEXEC
 #include <errno.h>
 #include <limits.h> // PATH_MAX
+#include <time.h>   // clock_gettime
+#include <spawn.h>  // posix_spawn
 
 #include "../headers/target.h"
 #include "../headers/coverage.h" // For fuzz_shared_mem, child_timed_out, reset_coverage_map
+#include "../headers/perf.h"
+#include "../headers/logger.h"
+#include "../headers/execcache.h"
 
-// Define specific error code for internal fuzzer execution errors
-#define FUZZER_EXEC_ERROR -999
+// Duration of the last execution, reported to the corpus for scheduling
+static unsigned int last_exec_us = 0;
+
+// Extra compiler flags for the target (e.g. -finstrument-functions for directed mode)
+static char target_extra_cflags[256] = "";
+
+static int run_target_once(const char *exePath, int input, unsigned int timeout_ms);
+static int run_target_timed(const char *exePath, int input, unsigned int timeout_ms);
+
+void set_target_extra_cflags(const char *flags)
+{
+snprintf(target_extra_cflags, sizeof(target_extra_cflags), "%s", flags ? flags : "");
+}
 
 // Compile the target program using Clang with coverage instrumentation.
 int compile_target_with_clang_coverage(const char *sourceDir,
@@ -56,7 +72,8 @@ snprintf(outputFilePath, sizeof(outputFilePath), "%s/%s", sourceDir, outputExeNa
 
 // --- Build the Clang command using both trace-pc-guard and trace-cmp ---
 snprintf(command, sizeof(command),
-"clang -g -fsanitize-coverage=trace-pc-guard,trace-cmp -o \"%s\" \"%s\" \"%s\" -Wl,--no-as-needed -fsanitize-coverage=trace-pc-guard,trace-cmp",
+"clang -g -fsanitize-coverage=trace-pc-guard,trace-cmp %s -o \"%s\" \"%s\" \"%s\" -Wl,--no-as-needed -fsanitize-coverage=trace-pc-guard,trace-cmp -rdynamic -ldl",
+target_extra_cflags,
 outputFilePath,
 sourceFilePath,
 runtimeFilePath);
@@ -83,90 +100,220 @@ printf("Fuzzer Info: Target compiled successfully: %s\n", outputFilePath);
 return 0;
 }
 
-// Execute the instrumented target in a controlled environment (fork/exec).
+// Execute the instrumented target in a controlled environment (spawn/wait).
 // Return codes:
 //   0: Normal exit(0)
-//  +N: Normal exit(N) where N > 0 (e.g., +1, +100 from child errors)
+//  +N: Normal exit(N) where N > 0
 //  -S: Terminated by signal S (e.g., -6 for SIGABRT, -11 for SIGSEGV, -SIGALRM for timeout)
-// FUZZER_EXEC_ERROR (-999): Internal fuzzer error during execution setup (fork/pipe/etc.)
+// FUZZER_EXEC_ERROR: Internal fuzzer error during execution setup (spawn/pipe/etc.)
+// Inputs already run are restored from the execution cache instead (see execcache.h)
 int execute_target_fork(const char *exePath, int input, unsigned int timeout_ms) {
-    int status = 0; // Final status to return
-    pid_t child_pid;
-    int pipe_stdin[2];
-    int wait_status; // Raw status from waitpid
+    int status;
+    unsigned int cached_us;
+    int verify = 0;
+    if (fuzz_shared_mem.map &&
+        exec_cache_lookup(input, fuzz_shared_mem.map, fuzz_shared_mem.extra, &status, &cached_us)) {
+        if (!exec_cache_should_verify()) {
+            last_exec_us = cached_us;
+            return status;
+        }
+        verify = 1; // Run it anyway and compare
+    }
 
-    // Pre-execution checks
-    if (fuzz_shared_mem.shm_id < 0 || !fuzz_shared_mem.map) {
-        fprintf(stderr, "[Exec] Error: Shared memory not initialized.\n"); // Use stderr
-        return FUZZER_EXEC_ERROR;
+    status = run_target_timed(exePath, input, timeout_ms);
+    if (verify) exec_cache_verify(input, fuzz_shared_mem.map, status);
+    else exec_cache_insert(input, fuzz_shared_mem.map, fuzz_shared_mem.extra, status, last_exec_us);
+    return status;
+}
+
+int execute_target_uncached(const char *exePath, int input, unsigned int timeout_ms) {
+    return run_target_timed(exePath, input, timeout_ms);
+}
+
+// One execution, accounted in the exec histogram and as the last exec time
+static int run_target_timed(const char *exePath, int input, unsigned int timeout_ms) {
+    uint64_t start = perf_now_ns();
+
+    int status = run_target_once(exePath, input, timeout_ms);
+
+    uint64_t elapsed_ns = perf_now_ns() - start;
+    perf_record(PERF_STAGE_EXEC, elapsed_ns);
+    last_exec_us = (unsigned int)(elapsed_ns / 1000);
+    return status;
+}
+
+void record_pooled_exec(unsigned int exec_us) {
+    perf_record(PERF_STAGE_EXEC, (uint64_t)exec_us * 1000);
+    last_exec_us = exec_us;
+}
+
+void set_last_exec_time_us(unsigned int exec_us) {
+    last_exec_us = exec_us;
+}
+
+unsigned int get_last_exec_time_us(void) {
+    return last_exec_us;
+}
+
+// Spawning. posix_spawn (clone(CLONE_VM|CLONE_VFORK) in glibc) starts the
+// target without copying the fuzzer's page tables, so launch cost does not
+// grow with the corpus and population heaps the way fork's does. What the
+// child needs is prepared once: the file actions map a fixed descriptor to
+// stdin and /dev/null to stdout/stderr, and each shared memory segment gets an
+// envp with its __AFL_SHM_ID appended to the fuzzer's environment (as it was
+// when the segment was first used).
+#define LAUNCH_ENV_SLOTS 32 // Segments with a prebuilt envp (main map, pipeline slots, ...)
+
+extern char **environ;
+
+typedef struct {
+    int shm_id;       // -1: free
+    char **envp;
+    char var[32];     // "__AFL_SHM_ID=<id>"
+} launch_env_t;
+
+static int launch_ready = 0;
+static int dev_null_fd = -1;
+static int stdin_fd = -1;         // Parked on /dev/null; the input pipe is moved here to spawn
+static posix_spawn_file_actions_t launch_actions;
+static launch_env_t launch_envs[LAUNCH_ENV_SLOTS];
+static int next_env_slot = 0;
+
+static int launch_init(void) {
+    dev_null_fd = open("/dev/null", O_RDWR | O_CLOEXEC);
+    if (dev_null_fd < 0) {
+        LOG_E("Exec", "Cannot open /dev/null: %s", strerror(errno));
+        return -1;
     }
-    reset_coverage_map(); // Ensure coverage map is clean before run
+    stdin_fd = fcntl(dev_null_fd, F_DUPFD_CLOEXEC, 0);
+    if (stdin_fd < 0 || posix_spawn_file_actions_init(&launch_actions) != 0) {
+        LOG_E("Exec", "Cannot prepare target file actions: %s", strerror(errno));
+        return -1;
+    }
+    // dup2 clears close-on-exec on the target's 0/1/2; everything else of ours is close-on-exec
+    posix_spawn_file_actions_adddup2(&launch_actions, stdin_fd, STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&launch_actions, dev_null_fd, STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&launch_actions, dev_null_fd, STDERR_FILENO);
+    for (int i = 0; i < LAUNCH_ENV_SLOTS; i++) launch_envs[i].shm_id = -1;
+    launch_ready = 1;
+    return 0;
+}
 
-    // Create pipe for feeding input to child's stdin
-    if (pipe2(pipe_stdin, O_CLOEXEC) < 0) { // O_CLOEXEC prevents fd leak on execv
-        perror("[Exec] Error: pipe2(pipe_stdin) failed"); // Use stderr + perror
-        return FUZZER_EXEC_ERROR;
+// Environment for a target attached to segment shm_id
+static char **launch_envp(int shm_id) {
+    for (int i = 0; i < LAUNCH_ENV_SLOTS; i++) {
+        if (launch_envs[i].shm_id == shm_id) return launch_envs[i].envp;
     }
 
-    // Fork the fuzzer process
-    child_pid = fork();
+    size_t count = 0;
+    while (environ && environ[count]) count++;
+    char **envp = malloc((count + 2) * sizeof(char *));
+    if (!envp) return NULL;
 
-    if (child_pid < 0) {
-        // Fork failed
-        perror("[Exec] Error: fork failed"); // Use stderr + perror
-        close(pipe_stdin[0]); close(pipe_stdin[1]); // Clean up pipe fds
-        return FUZZER_EXEC_ERROR;
+    launch_env_t *env = &launch_envs[next_env_slot];
+    next_env_slot = (next_env_slot + 1) % LAUNCH_ENV_SLOTS;
+    free(env->envp); // Oldest segment's entry, if the table is full
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (strncmp(environ[i], "__AFL_SHM_ID=", 13) != 0) envp[n++] = environ[i];
     }
+    snprintf(env->var, sizeof(env->var), "__AFL_SHM_ID=%d", shm_id);
+    envp[n++] = env->var;
+    envp[n] = NULL;
+    env->envp = envp;
+    env->shm_id = shm_id;
+    return envp;
+}
 
-    // --- Child Process ---
-    if (child_pid == 0) {
-        // Close the write end of the stdin pipe (child only reads)
-        close(pipe_stdin[1]);
-        // Redirect child's stdin to read from the pipe's read end
-        if (dup2(pipe_stdin[0], STDIN_FILENO) < 0) {
-            perror("Child Error: dup2(stdin) failed"); exit(100); // Use distinct codes for child setup errors
-        }
-        // Close the original read end descriptor (no longer needed after dup2)
-        close(pipe_stdin[0]);
-
-        // Set environment variable for shared memory ID so runtime can attach
-        char shm_env_var[64];
-        snprintf(shm_env_var, sizeof(shm_env_var), "__AFL_SHM_ID=%d", fuzz_shared_mem.shm_id);
-        if (putenv(shm_env_var) != 0) {
-             perror("Child Error: putenv(__AFL_SHM_ID) failed"); exit(101);
-        }
-
-        // Redirect stdout/stderr to /dev/null to prevent target output clutter
-        int dev_null = open("/dev/null", O_WRONLY);
-        if (dev_null >= 0) {
-            dup2(dev_null, STDOUT_FILENO);
-            dup2(dev_null, STDERR_FILENO); // Redirect stderr as well
-            close(dev_null);
-        } else {
-             perror("Child Warning: Could not open /dev/null");
-        }
+pid_t launch_target(const char *exePath, int input, int shm_id) {
+    pid_t child_pid;
+    int pipe_stdin[2];
 
-        // Prepare arguments for execv (program name, NULL terminator)
-        char *const argv[] = {(char *)exePath, NULL};
-        // Replace child process image with the target executable
-        execv(exePath, argv);
+    if (!launch_ready && launch_init() != 0) {
+        return -1;
+    }
+    char **envp = launch_envp(shm_id);
+    if (!envp) {
+        LOG_E("Exec", "Cannot build the target environment");
+        return -1;
+    }
 
-        // If execv returns, it means an error occurred
-        fprintf(stderr, "Child Error: execv failed: %s\n", strerror(errno));
-        exit(102); // Exit with distinct code
+    // Create pipe for feeding input to child's stdin, read end on the descriptor the file actions expect
+    if (pipe2(pipe_stdin, O_CLOEXEC) < 0) { // O_CLOEXEC prevents fd leak on exec
+        LOG_E("Exec", "pipe2(pipe_stdin) failed: %s", strerror(errno));
+        return -1;
+    }
+    if (dup3(pipe_stdin[0], stdin_fd, O_CLOEXEC) < 0) {
+        LOG_E("Exec", "dup3(pipe_stdin) failed: %s", strerror(errno));
+        close(pipe_stdin[0]); close(pipe_stdin[1]);
+        return -1;
     }
+    close(pipe_stdin[0]);
 
-    // --- Parent Process (Fuzzer) ---
-    close(pipe_stdin[0]); // Close read end (parent only writes)
+    // Spawn the target
+    uint64_t stage_start = perf_now_ns();
+    char *const argv[] = {(char *)exePath, NULL};
+    int err = posix_spawn(&child_pid, exePath, &launch_actions, NULL, argv, envp);
+    dup3(dev_null_fd, stdin_fd, O_CLOEXEC); // Drop our copy of the read end (parent only writes)
+    if (err != 0) {
+        LOG_E("Exec", "posix_spawn(%s) failed: %s", exePath, strerror(err));
+        close(pipe_stdin[1]);
+        return -1;
+    }
+    perf_record_since(PERF_STAGE_FORK, stage_start);
 
     // Write input to child
+    stage_start = perf_now_ns();
     char input_str[32];
     snprintf(input_str, sizeof(input_str), "%d\n", input);
     ssize_t written = write(pipe_stdin[1], input_str, strlen(input_str));
     if (written <= 0 && errno != EPIPE) {
-         fprintf(stderr, "[Exec] Warning: Failed to write full input to pipe: %s\n", strerror(errno));
+         LOG_W("Exec", "Failed to write full input to pipe: %s", strerror(errno));
     }
     close(pipe_stdin[1]); // Close pipe write end to signal EOF
+    perf_record_since(PERF_STAGE_WRITE, stage_start);
+    return child_pid;
+}
+
+int decode_target_status(int wait_status, const shm_extra_t *extra) {
+    if (WIFEXITED(wait_status)) {
+        int exit_code = WEXITSTATUS(wait_status);
+        // reach_error()/__assert_fail intercepted by the runtime: report it as the abort it replaces
+        if (exit_code == ERROR_LABEL_EXIT_CODE && extra && extra->error.magic == ERROR_LABEL_MAGIC) {
+             return -SIGABRT;
+        }
+        return exit_code; // 0 or +N
+    } else if (WIFSIGNALED(wait_status)) {
+        int signal_num = WTERMSIG(wait_status);
+        if (signal_num == SIGALRM || signal_num == SIGKILL) { // Killed on timeout
+             return -SIGALRM;
+        } else { // Genuine crash
+             LOG_D("Exec", "Crash detected: Signal %d", signal_num);
+             return -signal_num; // -S
+        }
+    }
+
+    LOG_W("Exec", "Unknown child termination status: %d", wait_status);
+    return FUZZER_EXEC_ERROR;
+}
+
+// Single spawn/wait cycle (see execute_target_fork for return codes)
+static int run_target_once(const char *exePath, int input, unsigned int timeout_ms) {
+    int status = 0; // Final status to return
+    pid_t child_pid;
+    int wait_status; // Raw status from waitpid
+
+    // Pre-execution checks
+    if (fuzz_shared_mem.shm_id < 0 || !fuzz_shared_mem.map) {
+        LOG_E("Exec", "Shared memory not initialized.");
+        return FUZZER_EXEC_ERROR;
+    }
+    reset_coverage_map(); // Ensure coverage map is clean before run
+
+    child_pid = launch_target(exePath, input, fuzz_shared_mem.shm_id);
+    if (child_pid < 0) {
+        return FUZZER_EXEC_ERROR;
+    }
 
     // Setup timer
     child_timed_out = 0;
@@ -180,11 +327,12 @@ int execute_target_fork(const char *exePath, int input, unsigned int timeout_ms)
     alarm(timeout_sec);
 
     // Wait for child, handling EINTR
+    uint64_t stage_start = perf_now_ns();
     do {
         if (waitpid(child_pid, &wait_status, 0) < 0) {
             if (errno == EINTR) {
                 if (child_timed_out) {
-                    fprintf(stderr, "[Exec] Timeout detected during EINTR loop (PID: %d)\n", child_pid);
+                    LOG_D("Exec", "Timeout detected during EINTR loop (PID: %d)", child_pid);
                     kill(child_pid, SIGKILL);
                     waitpid(child_pid, &wait_status, 0);
                     status = -SIGALRM;
@@ -192,7 +340,7 @@ int execute_target_fork(const char *exePath, int input, unsigned int timeout_ms)
                 }
                 continue;
             } else {
-                perror("[Exec] Error: waitpid failed (non-EINTR)");
+                LOG_E("Exec", "waitpid failed (non-EINTR): %s", strerror(errno));
                 status = FUZZER_EXEC_ERROR;
                 goto end_wait;
             }
@@ -203,6 +351,7 @@ int execute_target_fork(const char *exePath, int input, unsigned int timeout_ms)
 
 end_wait:
     alarm(0); // Cancel alarm
+    perf_record_since(PERF_STAGE_WAIT, stage_start);
 
     if (status != 0) { // Status already set by error/timeout in loop
          if (status == -SIGALRM) { // Ensure cleanup on timeout path
@@ -214,33 +363,14 @@ end_wait:
 
     // Check timeout flag again after successful wait
     if (child_timed_out) {
-        fprintf(stderr, "[Exec] Timeout detected after waitpid success (PID: %d)\n", child_pid);
+        LOG_D("Exec", "Timeout detected after waitpid success (PID: %d)", child_pid);
         kill(child_pid, SIGKILL);
         waitpid(child_pid, NULL, WNOHANG);
         return -SIGALRM;
     }
 
     // Determine status from wait_status if waitpid succeeded and no timeout flag
-    if (WIFEXITED(wait_status)) {
-        int exit_code = WEXITSTATUS(wait_status);
-        if (exit_code == 100 || exit_code == 101 || exit_code == 102) {
-             fprintf(stderr, "[Exec] Warning: Child process setup error (exit code %d)\n", exit_code);
-             return FUZZER_EXEC_ERROR;
-        }
-        return exit_code; // 0 or +N
-    } else if (WIFSIGNALED(wait_status)) {
-        int signal_num = WTERMSIG(wait_status);
-        if (signal_num == SIGALRM || signal_num == SIGKILL) { // Should be caught by timeout flag, but handle defensively
-             if (!child_timed_out) { fprintf(stderr, "[Exec] Info: Child killed by ALRM/KILL post-wait? (PID: %d)\n", child_pid); }
-             return -SIGALRM;
-        } else { // Genuine crash
-             fprintf(stderr, "[Exec] Crash detected: Signal %d (PID: %d)\n", signal_num, child_pid);
-             return -signal_num; // -S
-        }
-    }
-
-    fprintf(stderr, "[Exec] Warning: Unknown child termination status: %d\n", wait_status);
-    return FUZZER_EXEC_ERROR;
+    return decode_target_status(wait_status, fuzz_shared_mem.extra);
 }
 
 // Cleanup function (placeholder)
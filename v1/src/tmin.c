@@ -0,0 +1,171 @@
+// filepath: src/tmin.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <signal.h>
+
+#include "../headers/tmin.h"
+#include "../headers/crash.h"
+#include "../headers/target.h"
+
+static unsigned int magnitude(int v) {
+    return v < 0 ? 0u - (unsigned int)v : (unsigned int)v;
+}
+
+int tmin_is_simpler(int a, int b) {
+    unsigned int ma = magnitude(a), mb = magnitude(b);
+    if (ma != mb) return ma < mb;
+    return a >= 0 && b < 0;
+}
+
+static int compareSimplicity(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    if (tmin_is_simpler(x, y)) return -1;
+    if (tmin_is_simpler(y, x)) return 1;
+    return 0;
+}
+
+// Add a candidate if it is simpler than 'current' and not already queued
+static void addCandidate(int* candidates, int* count, int current, int negative, unsigned long mag) {
+    int value;
+
+    if (*count >= TMIN_MAX_CANDIDATES) return;
+    if (negative) {
+        if (mag > (unsigned long)INT_MAX + 1UL) return;
+        value = mag == (unsigned long)INT_MAX + 1UL ? INT_MIN : -(int)mag;
+    } else {
+        if (mag > (unsigned long)INT_MAX) return;
+        value = (int)mag;
+    }
+    if (!tmin_is_simpler(value, current)) return;
+    for (int i = 0; i < *count; i++) {
+        if (candidates[i] == value) return;
+    }
+    candidates[(*count)++] = value;
+}
+
+// Candidates for one round, simplest first
+static int buildCandidates(int current, int* candidates) {
+    char text[16], edited[16];
+    int count = 0;
+    int negative = current < 0;
+    unsigned int mag = magnitude(current);
+    int len = snprintf(text, sizeof(text), "%u", mag);
+
+    addCandidate(candidates, &count, current, 0, 0);
+    if (negative) {
+        addCandidate(candidates, &count, current, 0, mag); // Drop the sign
+    }
+
+    // Block deletion on the decimal text, largest blocks first
+    for (int block = len - 1; block >= 1; block--) {
+        for (int pos = 0; pos + block <= len; pos++) {
+            memcpy(edited, text, (size_t)pos);
+            memcpy(edited + pos, text + pos + block, (size_t)(len - pos - block) + 1);
+            addCandidate(candidates, &count, current, negative, strtoul(edited, NULL, 10));
+        }
+    }
+
+    // Normalisation: one digit at a time to '0'
+    for (int pos = 0; pos < len; pos++) {
+        if (text[pos] == '0') continue;
+        memcpy(edited, text, (size_t)len + 1);
+        edited[pos] = '0';
+        addCandidate(candidates, &count, current, negative, strtoul(edited, NULL, 10));
+    }
+
+    // Halving and single steps toward 0
+    for (unsigned int m = mag / 2; m > 0; m /= 2) {
+        addCandidate(candidates, &count, current, negative, m);
+    }
+    if (mag > 0) {
+        addCandidate(candidates, &count, current, negative, mag - 1);
+    }
+
+    qsort(candidates, (size_t)count, sizeof(int), compareSimplicity);
+    return count;
+}
+
+// Crash bucket of a run: signature hash (signal, PC, frames) and reach_error label
+typedef struct {
+    uint64_t sig_hash;
+    int label;
+} crash_identity_t;
+
+static crash_identity_t crashIdentity(int status, const exec_run_extra_t* extra) {
+    shm_extra_t run;
+    crash_identity_t id;
+
+    memcpy(&run, extra->bytes, SHM_EXTRA_RUN_SIZE);
+    id.sig_hash = crash_signature_hash(&run.crash, -status);
+    id.label = run.error.magic == ERROR_LABEL_MAGIC ? run.error.label : 0;
+    return id;
+}
+
+// Same observable behaviour as the original run?
+static int reproduces(const exec_result_t* original, const crash_identity_t* original_crash,
+                      const exec_result_t* result, const exec_run_extra_t* extra) {
+    int status = original->status;
+
+    if (status < 0 && status != -SIGALRM && status != FUZZER_EXEC_ERROR) {
+        if (result->status != status) return 0;
+        crash_identity_t id = crashIdentity(result->status, extra); // Same crash bucket
+        return id.sig_hash == original_crash->sig_hash && id.label == original_crash->label;
+    }
+    if (status == -SIGALRM) {
+        return result->status == -SIGALRM;
+    }
+    return result->status == status && result->cov_hash == original->cov_hash;
+}
+
+int tmin_minimize_int(executor_pool_t* pool, int input, int* out, tmin_stats_t* stats) {
+    int candidates[TMIN_MAX_CANDIDATES];
+    exec_result_t results[TMIN_MAX_CANDIDATES];
+    exec_run_extra_t extras[TMIN_MAX_CANDIDATES];
+    exec_result_t original;
+    exec_run_extra_t original_extra;
+    crash_identity_t original_crash;
+    tmin_stats_t local;
+    int current = input;
+
+    if (!stats) stats = &local;
+    memset(stats, 0, sizeof(*stats));
+    *out = input;
+
+    if (executor_pool_run_maps(pool, &input, 1, &original, NULL, &original_extra) != 0 ||
+        original.status == FUZZER_EXEC_ERROR) {
+        fprintf(stderr, "Error: Failed to execute original input %d\n", input);
+        return -1;
+    }
+    original_crash = crashIdentity(original.status, &original_extra);
+    stats->original_status = original.status;
+    stats->execs = 1;
+
+    for (int round = 0; round < TMIN_MAX_ROUNDS; round++) {
+        int count = buildCandidates(current, candidates);
+        if (count == 0) break;
+
+        // Run one batch per pool width; candidates are sorted simplest first,
+        // so the first reproducing one in the earliest batch is the best
+        int found = -1;
+        for (int start = 0; start < count && found < 0; start += pool->workers) {
+            int batch = count - start < pool->workers ? count - start : pool->workers;
+            executor_pool_run_maps(pool, candidates + start, batch, results + start, NULL, extras + start);
+            stats->execs += batch;
+            for (int i = start; i < start + batch; i++) {
+                if (reproduces(&original, &original_crash, &results[i], &extras[i])) {
+                    found = i;
+                    break;
+                }
+            }
+        }
+        if (found < 0) break;
+
+        current = candidates[found];
+        stats->rounds++;
+    }
+
+    *out = current;
+    return 0;
+}